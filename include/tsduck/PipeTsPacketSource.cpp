@@ -5,14 +5,38 @@ using namespace std;
 
 void video::PipeTsPacketSource::SendPacketToEachConsumer(ts::TSPacket *packet)
 {
+	SendPacketToEachConsumer(packet, _metadata);
+}
+
+void video::PipeTsPacketSource::SendPacketToEachConsumer(ts::TSPacket *packet, ts::TSPacketMetadata *metadata)
+{
+	if (_window)
+	{
+		SpliceIntoWindow(packet, 1);
+		return;
+	}
+
 	for (shared_ptr<ITSPacketConsumer> &consumer : _consumer_list)
 	{
-		consumer->SendPacket(packet);
+		if (metadata)
+		{
+			consumer->SendPacket(packet, metadata);
+		}
+		else
+		{
+			consumer->SendPacket(packet);
+		}
 	}
 }
 
 void video::PipeTsPacketSource::SendPacketToEachConsumer(std::vector<ts::TSPacket> packets)
 {
+	if (_window)
+	{
+		SpliceIntoWindow(packets.data(), packets.size());
+		return;
+	}
+
 	for (auto &packet : packets)
 	{
 		SendPacketToEachConsumer(&packet);
@@ -27,6 +51,106 @@ void video::PipeTsPacketSource::SendPacketToEachConsumer(std::vector<std::vector
 	}
 }
 
+void video::PipeTsPacketSource::SendPacketWindowToEachConsumer(ts::TSPacketWindow &window)
+{
+	// 延后一步送出，这样才知道哪个是最后一个消费者。
+	shared_ptr<ITSPacketConsumer> previous;
+	for (shared_ptr<ITSPacketConsumer> &consumer : _consumer_list)
+	{
+		if (previous)
+		{
+			SendPacketCopies(*previous, window);
+		}
+
+		previous = consumer;
+	}
+
+	if (previous)
+	{
+		// 后面没有消费者了，窗口本身可以交给它修改。
+		previous->SendPacketWindow(window);
+	}
+}
+
+void video::PipeTsPacketSource::SendPacketCopies(ITSPacketConsumer &consumer, ts::TSPacketWindow &window)
+{
+	for (size_t i = 0; i < window.size(); i++)
+	{
+		ts::TSPacket *packet = window.packet(i);
+		if (!packet)
+		{
+			continue;
+		}
+
+		ts::TSPacket packet_copy = *packet;
+		ts::TSPacketMetadata *metadata = window.metadata(i);
+		if (metadata)
+		{
+			ts::TSPacketMetadata metadata_copy = *metadata;
+			consumer.SendPacket(&packet_copy, &metadata_copy);
+		}
+		else
+		{
+			consumer.SendPacket(&packet_copy);
+		}
+	}
+}
+
+void video::PipeTsPacketSource::BeginWindow(ts::TSPacketWindow &window)
+{
+	_window = &window;
+	_window_position = 0;
+	_splice_packets.clear();
+	_splice_metadata.clear();
+	_splices.clear();
+}
+
+void video::PipeTsPacketSource::SetWindowPosition(size_t index)
+{
+	_window_position = index;
+}
+
+void video::PipeTsPacketSource::SpliceIntoWindow(ts::TSPacket const *packets, size_t count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// 连续送出且插入位置相同的包合并成一段。
+	if (!_splices.empty() && _splices.back().index == _window_position)
+	{
+		_splices.back().count += count;
+	}
+	else
+	{
+		_splices.push_back(WindowSplice{_window_position, _splice_packets.size(), count});
+	}
+
+	_splice_packets.insert(_splice_packets.end(), packets, packets + count);
+
+	ts::TSPacketMetadata *metadata = _window->metadata(_window_position);
+	_splice_metadata.insert(_splice_metadata.end(), count, metadata ? *metadata : ts::TSPacketMetadata{});
+}
+
+void video::PipeTsPacketSource::EndWindow()
+{
+	ts::TSPacketWindow &window = *_window;
+	_window = nullptr;
+
+	// 所有包都复制完后才取地址，此后向量不会再重新分配。
+	// 从后往前插入，前面的插入位置不受影响。
+	for (auto it = _splices.rbegin(); it != _splices.rend(); ++it)
+	{
+		window.insertPacketsReference(it->index,
+									  &_splice_packets[it->first],
+									  &_splice_metadata[it->first],
+									  it->count);
+	}
+
+	SendPacketWindowToEachConsumer(window);
+}
+
 void video::PipeTsPacketSource::AddTsPacketConsumer(shared_ptr<ITSPacketConsumer> packet_comsumer)
 {
 	if (!packet_comsumer)
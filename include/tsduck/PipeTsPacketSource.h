@@ -4,6 +4,7 @@
 #include <memory>
 #include <tsduck/interface/ITSPacketConsumer.h>
 #include <tsTSPacket.h>
+#include <tsTSPacketWindow.h>
 
 using std::shared_ptr;
 
@@ -38,10 +39,124 @@ namespace video
 	protected:
 		base::List<shared_ptr<ITSPacketConsumer>> _consumer_list;
 
+		/// <summary>
+		///		送出包。如果正在处理带元数据的包（见 MetadataScope），送出的包带上该元数据，
+		///		所以处理一个包期间生成的表格包继承这个包的元数据。
+		/// </summary>
+		/// <param name="packet"></param>
 		void SendPacketToEachConsumer(ts::TSPacket *packet);
+
+		/// <summary>
+		///		送出带元数据的包。metadata 为空指针时送出的包不带元数据。
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <param name="metadata"></param>
+		void SendPacketToEachConsumer(ts::TSPacket *packet, ts::TSPacketMetadata *metadata);
+
 		void SendPacketToEachConsumer(std::vector<ts::TSPacket> packets);
 		void SendPacketToEachConsumer(std::vector<std::vector<ts::TSPacket>> packet_vectors);
 
+		/// <summary>
+		///		正在处理的包的元数据。没有元数据时为空指针。
+		/// </summary>
+		/// <returns></returns>
+		ts::TSPacketMetadata *CurrentMetadata() const
+		{
+			return _metadata;
+		}
+
+		/// <summary>
+		///		在作用域内把 metadata 设置为正在处理的包的元数据，离开作用域时恢复。
+		///		带元数据的 SendPacket 一般这样实现：
+		///			MetadataScope scope{*this, metadata};
+		///			SendPacket(packet);
+		/// </summary>
+		class MetadataScope
+		{
+		public:
+			MetadataScope(PipeTsPacketSource &source, ts::TSPacketMetadata *metadata)
+				: _source(source),
+				  _saved(source._metadata)
+			{
+				_source._metadata = metadata;
+			}
+
+			~MetadataScope()
+			{
+				_source._metadata = _saved;
+			}
+
+			MetadataScope(MetadataScope const &) = delete;
+			MetadataScope &operator=(MetadataScope const &) = delete;
+
+		private:
+			PipeTsPacketSource &_source;
+			ts::TSPacketMetadata *_saved;
+		};
+
+		/// <summary>
+		///		把窗口送给每个消费者。
+		///
+		///		消费者会就地修改、丢弃或插入包，所以只有最后一个消费者拿到窗口本身，
+		///		前面的消费者逐个收到包和元数据的副本，彼此看不到对方的修改。
+		///		只有一个消费者时不复制。
+		/// </summary>
+		/// <param name="window"></param>
+		void SendPacketWindowToEachConsumer(ts::TSPacketWindow &window);
+
+		/// <summary>
+		///		把窗口中的包逐个复制后送给 consumer. 窗口不会被修改。
+		/// </summary>
+		/// <param name="consumer"></param>
+		/// <param name="window"></param>
+		static void SendPacketCopies(ITSPacketConsumer &consumer, ts::TSPacketWindow &window);
+
+		/// <summary>
+		///		开始处理一个窗口。
+		///
+		///		从此时起到 EndWindow 为止，通过 SendPacketToEachConsumer 送出的包不会立即送给消费者，
+		///		而是被复制到本对象内部，在 EndWindow 中作为额外的范围拼接到窗口中 SetWindowPosition
+		///		设置的位置之前。这样 TableVersionChangeHandler 的回调函数不需要区分两种送包方式。
+		/// </summary>
+		/// <param name="window"></param>
+		void BeginWindow(ts::TSPacketWindow &window);
+
+		/// <summary>
+		///		设置接下来送出的包在窗口中的插入位置。一般是正在处理的包的索引，
+		///		这样插入的包会位于正在处理的包之前，与逐包送入时的顺序相同。
+		/// </summary>
+		/// <param name="index"></param>
+		void SetWindowPosition(size_t index);
+
+		/// <summary>
+		///		把暂存的包拼接进窗口，然后把窗口送给每个消费者。
+		/// </summary>
+		void EndWindow();
+
+	private:
+		/// <summary>
+		///		一段要拼接进窗口的包。
+		/// </summary>
+		struct WindowSplice
+		{
+			size_t index = 0;
+			size_t first = 0;
+			size_t count = 0;
+		};
+
+		ts::TSPacketMetadata *_metadata = nullptr;
+		ts::TSPacketWindow *_window = nullptr;
+		size_t _window_position = 0;
+
+		/// <summary>
+		///		拼接进窗口的包和它们的元数据。元数据复制自插入位置的包。在下一次 BeginWindow 之前保持有效。
+		/// </summary>
+		std::vector<ts::TSPacket> _splice_packets;
+		std::vector<ts::TSPacketMetadata> _splice_metadata;
+		std::vector<WindowSplice> _splices;
+
+		void SpliceIntoWindow(ts::TSPacket const *packets, size_t count);
+
 	public:
 		virtual void AddTsPacketConsumer(shared_ptr<ITSPacketConsumer> packet_comsumer) override;
 		virtual bool RemovePacketConsumer(shared_ptr<ITSPacketConsumer> packet_comsumer) override;
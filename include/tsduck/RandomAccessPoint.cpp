@@ -0,0 +1,76 @@
+#include "tsduck/RandomAccessPoint.h"
+#include <tsAccessUnitIterator.h>
+#include <tsAVC.h>
+#include <tsHEVC.h>
+#include <tsPSI.h>
+#include <tsVVC.h>
+
+bool video::RandomAccessPoint::Check(ts::TSPacket const &packet, uint8_t stream_type)
+{
+	if (!packet.getPUSI() || !packet.hasPayload())
+	{
+		return false;
+	}
+
+	if (packet.getRandomAccessIndicator() || !ts::StreamTypeIsVideo(stream_type))
+	{
+		return true;
+	}
+
+	// 没有设置 random_access_indicator 时在 PES 包的开头寻找随机访问单元。
+	uint8_t const *payload = packet.getPayload();
+	size_t payload_size = packet.getPayloadSize();
+	if (payload_size < 9 || payload[0] != 0x00 || payload[1] != 0x00 || payload[2] != 0x01)
+	{
+		return false;
+	}
+
+	size_t pes_header_size = 9 + size_t(payload[8]);
+	if (pes_header_size >= payload_size)
+	{
+		return false;
+	}
+
+	ts::AccessUnitIterator au_iterator{payload + pes_header_size, payload_size - pes_header_size, stream_type};
+	for (; au_iterator.isValid() && !au_iterator.atEnd(); au_iterator.next())
+	{
+		uint8_t type = au_iterator.currentAccessUnitType();
+		switch (au_iterator.videoFormat())
+		{
+		case ts::CodecType::AVC:
+			{
+				if (type == ts::AVC_AUT_IDR)
+				{
+					return true;
+				}
+
+				break;
+			}
+		case ts::CodecType::HEVC:
+			{
+				// BLA, IDR, CRA 都是 IRAP.
+				if (type >= ts::HEVC_AUT_BLA_W_LP && type <= ts::HEVC_AUT_RSV_IRAP_VCL23)
+				{
+					return true;
+				}
+
+				break;
+			}
+		case ts::CodecType::VVC:
+			{
+				if (type >= ts::VVC_AUT_IDR_W_RADL && type <= ts::VVC_AUT_CRA_NUT)
+				{
+					return true;
+				}
+
+				break;
+			}
+		default:
+			{
+				return false;
+			}
+		}
+	}
+
+	return false;
+}
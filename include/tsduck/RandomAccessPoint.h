@@ -0,0 +1,27 @@
+#pragma once
+#include <tsTSPacket.h>
+
+namespace video
+{
+	/// <summary>
+	///		判断视频的随机访问点。
+	/// </summary>
+	class RandomAccessPoint
+	{
+	private:
+		RandomAccessPoint() = delete;
+
+	public:
+		/// <summary>
+		///		packet 是否是随机访问点：PES 包的第一个 ts 包，并且设置了自适应字段的 random_access_indicator，
+		///		或者这个包中能找到 AVC 的 IDR, HEVC 的 IRAP, VVC 的 IDR 或 CRA 访问单元。
+		///
+		///		只检查这一个 ts 包，随机访问单元前面的 SPS, PPS, SEI 等超出这个包时会漏检。
+		///		非视频流的每个 PES 包开头都是随机访问点。
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <param name="stream_type">PMT 中的流类型。</param>
+		/// <returns></returns>
+		static bool Check(ts::TSPacket const &packet, uint8_t stream_type);
+	};
+} // namespace video
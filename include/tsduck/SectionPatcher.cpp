@@ -0,0 +1,277 @@
+#include "tsduck/SectionPatcher.h"
+#include <tsMemory.h>
+#include <tsSection.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace video;
+
+namespace
+{
+	/// <summary>
+	///		在映射表中查找 value. 找到了则将映射后的值写入 value 并返回 true.
+	/// </summary>
+	/// <param name="map"></param>
+	/// <param name="value"></param>
+	/// <returns></returns>
+	bool Map(std::map<uint16_t, uint16_t> const &map, uint16_t &value)
+	{
+		auto it = map.find(value);
+		if (it == map.end() || it->second == value)
+		{
+			return false;
+		}
+
+		value = it->second;
+		return true;
+	}
+
+	/// <summary>
+	///		修改段的载荷中 offset 处的 13 位 PID，高 3 位的保留位保持不变。
+	/// </summary>
+	/// <param name="section"></param>
+	/// <param name="offset">相对于载荷的偏移量。</param>
+	/// <param name="pid_map"></param>
+	/// <returns>PID 被修改则返回 true.</returns>
+	bool ChangePid(ts::Section &section, size_t offset, std::map<uint16_t, uint16_t> const &pid_map)
+	{
+		uint16_t field = ts::GetUInt16(section.payload() + offset);
+		uint16_t pid = field & 0x1FFF;
+		if (!Map(pid_map, pid))
+		{
+			return false;
+		}
+
+		uint8_t bytes[2];
+		ts::PutUInt16(bytes, uint16_t((field & 0xE000) | (pid & 0x1FFF)));
+		section.patch(section.headerSize() + offset, bytes, sizeof(bytes));
+		return true;
+	}
+
+	/// <summary>
+	///		修改段的载荷中 offset 处的 16 位 service_id.
+	/// </summary>
+	/// <param name="section"></param>
+	/// <param name="offset">相对于载荷的偏移量。</param>
+	/// <param name="service_id_map"></param>
+	/// <returns>service_id 被修改则返回 true.</returns>
+	bool ChangeServiceId(ts::Section &section, size_t offset, std::map<uint16_t, uint16_t> const &service_id_map)
+	{
+		uint16_t service_id = ts::GetUInt16(section.payload() + offset);
+		if (!Map(service_id_map, service_id))
+		{
+			return false;
+		}
+
+		uint8_t bytes[2];
+		ts::PutUInt16(bytes, service_id);
+		section.patch(section.headerSize() + offset, bytes, sizeof(bytes));
+		return true;
+	}
+
+	/// <summary>
+	///		对表格的每个有效的长段执行 patch. 字段用 ts::Section::patch 修改，CRC32 是增量更新的。
+	/// </summary>
+	/// <typeparam name="PatchFunc">bool(ts::Section &section)，有修改则返回 true.</typeparam>
+	/// <param name="table"></param>
+	/// <param name="patch"></param>
+	/// <returns>有段被修改则返回 true.</returns>
+	template <typename PatchFunc>
+	bool PatchEachSection(ts::BinaryTable &table, PatchFunc patch)
+	{
+		bool changed = false;
+		for (size_t i = 0; i < table.sectionCount(); i++)
+		{
+			ts::SectionPtr section = table.sectionAt(i);
+			if (section.isNull() || !section->isLongSection())
+			{
+				continue;
+			}
+
+			changed |= patch(*section);
+		}
+
+		return changed;
+	}
+} // namespace
+
+bool video::SectionPatcher::ChangeServiceIdInPat(ts::BinaryTable &pat, std::map<uint16_t, uint16_t> const &service_id_map)
+{
+	return PatchEachSection(pat, [&](ts::Section &section)
+	{
+		// 每个条目 4 字节：program_number(16), reserved(3), PID(13).
+		bool changed = false;
+		for (size_t offset = 0; offset + 4 <= section.payloadSize(); offset += 4)
+		{
+			if (ts::GetUInt16(section.payload() + offset) != 0)
+			{
+				changed |= ChangeServiceId(section, offset, service_id_map);
+			}
+		}
+
+		return changed;
+	});
+}
+
+bool video::SectionPatcher::ChangePmtPidInPat(ts::BinaryTable &pat, std::map<uint16_t, uint16_t> const &pid_map)
+{
+	return PatchEachSection(pat, [&](ts::Section &section)
+	{
+		bool changed = false;
+		for (size_t offset = 0; offset + 4 <= section.payloadSize(); offset += 4)
+		{
+			if (ts::GetUInt16(section.payload() + offset) != 0)
+			{
+				changed |= ChangePid(section, offset + 2, pid_map);
+			}
+		}
+
+		return changed;
+	});
+}
+
+bool video::SectionPatcher::ChangeServiceIdInPmt(ts::BinaryTable &pmt, std::map<uint16_t, uint16_t> const &service_id_map)
+{
+	uint16_t service_id = pmt.tableIdExtension();
+	if (!Map(service_id_map, service_id))
+	{
+		return false;
+	}
+
+	// table_id_extension 在段头的偏移量 3 处。
+	uint8_t bytes[2];
+	ts::PutUInt16(bytes, service_id);
+	return PatchEachSection(pmt, [&](ts::Section &section)
+	{
+		section.patch(3, bytes, sizeof(bytes));
+		return true;
+	});
+}
+
+bool video::SectionPatcher::ChangeStreamPidAndPcrPidInPmt(ts::BinaryTable &pmt, std::map<uint16_t, uint16_t> const &pid_map)
+{
+	return PatchEachSection(pmt, [&](ts::Section &section)
+	{
+		// 载荷：reserved(3), PCR_PID(13), reserved(4), program_info_length(12), 描述符，然后是流的循环。
+		size_t size = section.payloadSize();
+		if (size < 4)
+		{
+			return false;
+		}
+
+		bool changed = ChangePid(section, 0, pid_map);
+
+		// 流的循环中每个条目：stream_type(8), reserved(3), elementary_PID(13), reserved(4), ES_info_length(12), 描述符。
+		size_t offset = 4 + (ts::GetUInt16(section.payload() + 2) & 0x0FFF);
+		while (offset + 5 <= size)
+		{
+			changed |= ChangePid(section, offset + 1, pid_map);
+			offset += 5 + (ts::GetUInt16(section.payload() + offset + 3) & 0x0FFF);
+		}
+
+		return changed;
+	});
+}
+
+bool video::SectionPatcher::ChangeServiceIdInSdt(ts::BinaryTable &sdt, std::map<uint16_t, uint16_t> const &service_id_map)
+{
+	return PatchEachSection(sdt, [&](ts::Section &section)
+	{
+		// 载荷：original_network_id(16), reserved(8)，然后是服务的循环。
+		// 每个条目：service_id(16), reserved(6), EIT 标志(2), running_status(3), free_CA_mode(1),
+		// descriptors_loop_length(12), 描述符。
+		size_t size = section.payloadSize();
+		bool changed = false;
+		size_t offset = 3;
+		while (offset + 5 <= size)
+		{
+			changed |= ChangeServiceId(section, offset, service_id_map);
+			offset += 5 + (ts::GetUInt16(section.payload() + offset + 3) & 0x0FFF);
+		}
+
+		return changed;
+	});
+}
+
+bool video::SectionPatcher::WriteToPackets(ts::BinaryTable const &table, std::vector<ts::TSPacket> &packets)
+{
+	// 所有段首尾相接，记下每个段的起始位置。
+	ts::ByteBlock data;
+	std::vector<size_t> section_starts;
+	for (size_t i = 0; i < table.sectionCount(); i++)
+	{
+		ts::SectionPtr section = table.sectionAt(i);
+		if (section.isNull() || !section->isValid())
+		{
+			return false;
+		}
+
+		section_starts.push_back(data.size());
+		data.append(section->content(), section->size());
+	}
+
+	if (data.empty())
+	{
+		return false;
+	}
+
+	size_t next_section = 0;
+	size_t pos = 0;
+	for (ts::TSPacket &packet : packets)
+	{
+		uint8_t *payload = packet.getPayload();
+		size_t size = packet.getPayloadSize();
+		size_t offset = 0;
+		if (packet.getPUSI())
+		{
+			if (size == 0)
+			{
+				return false;
+			}
+
+			// 段的边界上从指针域指示的位置开始，段的中间则从指针域后面接着写。
+			offset = (next_section < section_starts.size() && pos == section_starts[next_section]) ? 1 + payload[0] : 1;
+		}
+		else if (pos == 0)
+		{
+			// 第一个段必须从 PUSI 包开始。
+			return false;
+		}
+
+		while (offset < size && pos < data.size())
+		{
+			if (next_section < section_starts.size() && pos == section_starts[next_section])
+			{
+				// 段的开头，原来的包在这里也必须是同样 table_id 和长度的段。
+				if (payload[offset] == 0xFF)
+				{
+					// 原来的包在这里是填充，段从下一个 PUSI 包开始。
+					break;
+				}
+
+				if (offset + 3 > size || std::memcmp(payload + offset, data.data() + pos, 3) != 0)
+				{
+					return false;
+				}
+
+				next_section++;
+			}
+
+			size_t section_end = next_section < section_starts.size() ? section_starts[next_section] : data.size();
+			size_t count = std::min(size - offset, section_end - pos);
+			std::memcpy(payload + offset, data.data() + pos, count);
+			offset += count;
+			pos += count;
+		}
+
+		if (pos == data.size())
+		{
+			// 最后一个段后面原来可能是下一个表格的开头，改成填充。
+			std::memset(payload + offset, 0xFF, size - offset);
+			packets.resize(&packet - packets.data() + 1);
+			return true;
+		}
+	}
+
+	return false;
+}
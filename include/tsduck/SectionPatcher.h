@@ -0,0 +1,81 @@
+#pragma once
+#include <map>
+#include <stdint.h>
+#include <tsBinaryTable.h>
+#include <tsTSPacket.h>
+#include <vector>
+
+namespace video
+{
+	/// <summary>
+	///		直接在段的二进制数据上修改 PAT、PMT、SDT 中的 PID 和 service_id. 每修改一个字段就用
+	///		ts::Section::patch 增量更新 CRC32，不重新计算整个段。
+	///
+	///		* 不反序列化成 ts::PAT、ts::PMT、ts::SDT，不重新序列化，所以不认识的描述符、保留位、
+	///		  条目顺序、段的划分都原样保留。
+	///		* 映射表的键是原始值，值是要被修改成的值。每个字段只按原始值查一次映射表，不会连锁映射。
+	///		* 映射后如果出现重复的 PID 或 service_id，不会去重，由调用者保证映射表不冲突。
+	///		* 格式错误的段会在出错的位置停止修改，已经修改的部分仍然有效。
+	///
+	///		要修改的表格如果与别的表格共享段，应该先用 ts::ShareMode::COPY 复制一份。
+	/// </summary>
+	class SectionPatcher
+	{
+	private:
+		SectionPatcher() = delete;
+
+	public:
+		/// <summary>
+		///		更改 PAT 中各个节目的 program_number. program_number 为 0 的 NIT 条目不会被修改。
+		/// </summary>
+		/// <param name="pat">此表格会被修改。</param>
+		/// <param name="service_id_map"></param>
+		/// <returns>有字段被修改则返回 true.</returns>
+		static bool ChangeServiceIdInPat(ts::BinaryTable &pat, std::map<uint16_t, uint16_t> const &service_id_map);
+
+		/// <summary>
+		///		更改 PAT 中各个节目的 PMT PID. NIT PID 不会被修改。
+		/// </summary>
+		/// <param name="pat">此表格会被修改。</param>
+		/// <param name="pid_map"></param>
+		/// <returns>有字段被修改则返回 true.</returns>
+		static bool ChangePmtPidInPat(ts::BinaryTable &pat, std::map<uint16_t, uint16_t> const &pid_map);
+
+		/// <summary>
+		///		更改 PMT 的 program_number，即 table_id_extension.
+		/// </summary>
+		/// <param name="pmt">此表格会被修改。</param>
+		/// <param name="service_id_map"></param>
+		/// <returns>有字段被修改则返回 true.</returns>
+		static bool ChangeServiceIdInPmt(ts::BinaryTable &pmt, std::map<uint16_t, uint16_t> const &service_id_map);
+
+		/// <summary>
+		///		更改 PMT 的 PCR PID 和各个流的 PID. 流的描述符原样保留。
+		/// </summary>
+		/// <param name="pmt">此表格会被修改。</param>
+		/// <param name="pid_map"></param>
+		/// <returns>有字段被修改则返回 true.</returns>
+		static bool ChangeStreamPidAndPcrPidInPmt(ts::BinaryTable &pmt, std::map<uint16_t, uint16_t> const &pid_map);
+
+		/// <summary>
+		///		更改 SDT 中各个服务的 service_id. 服务的描述符原样保留。
+		/// </summary>
+		/// <param name="sdt">此表格会被修改。</param>
+		/// <param name="service_id_map"></param>
+		/// <returns>有字段被修改则返回 true.</returns>
+		static bool ChangeServiceIdInSdt(ts::BinaryTable &sdt, std::map<uint16_t, uint16_t> const &service_id_map);
+
+		/// <summary>
+		///		把 table 的各个段按原来的布局写回承载它的原始包中：指针域、自适应字段、填充、连续性计数都不变，
+		///		只改写段的字节。用来在修改后重新打包，不用再经过 ts::OneShotPacketizer.
+		///
+		///		* packets 必须从第一个段所在的 PUSI 包开始，依次承载所有的段，并且每个段的 table_id
+		///		  和长度都与 table 中的相同。只修改字段的值不会改变段的长度。
+		///		* 最后一个段后面的字节改写为填充，多余的包会被删除。
+		/// </summary>
+		/// <param name="table"></param>
+		/// <param name="packets">原始包。失败时内容是不确定的。</param>
+		/// <returns>布局对不上时返回 false，此时应该改用 TableOperator::ToTsPacket.</returns>
+		static bool WriteToPackets(ts::BinaryTable const &table, std::vector<ts::TSPacket> &packets);
+	};
+} // namespace video
@@ -1,16 +1,40 @@
 #include "tsduck/TSDumper.h"
+#include <base/string/define.h>
+#include <tsMemory.h>
 
 using namespace video;
 using namespace std;
 
-TSDumper::TSDumper(std::string output_file_path)
+TSDumper::TSDumper(std::string output_file_path, OutputFormat format)
 {
+	_output_file_path = output_file_path;
+	_format = format;
 	_output_fs = shared_ptr<std::fstream>{
 		new std::fstream{
 			output_file_path,
-			std::ios_base::out | std::ios_base::trunc,
+			std::ios_base::out | std::ios_base::trunc | std::ios_base::binary,
 		},
 	};
+
+	_buffer.reserve(_buffer_size);
+	if (_format == OutputFormat::Binary)
+	{
+		// 魔数和格式版本号
+		_buffer.append("TSEL");
+		_buffer.push_back(1);
+	}
+}
+
+video::TSDumper::~TSDumper()
+{
+	try
+	{
+		Close();
+	}
+	catch (std::exception &e)
+	{
+		cerr << CODE_POS_STR << e.what() << endl;
+	}
 }
 
 void video::TSDumper::HandlePAT(ts::BinaryTable const &table)
@@ -24,8 +48,7 @@ void video::TSDumper::HandlePAT(ts::BinaryTable const &table)
 
 	if (_dump_pat)
 	{
-		Dump(ToString(pat));
-		Dump("\n");
+		DumpTable(table, _format == OutputFormat::Json ? ToJson(pat) : base::Json{});
 	}
 
 	_demux->resetPID(0);
@@ -35,10 +58,15 @@ void video::TSDumper::HandlePMT(ts::BinaryTable const &table)
 {
 	if (_dump_pmt)
 	{
-		ts::PMT pmt;
-		pmt.deserialize(*_duck, table);
-		Dump(ToString(pmt));
-		Dump("\n");
+		base::Json pmt_json;
+		if (_format == OutputFormat::Json)
+		{
+			ts::PMT pmt;
+			pmt.deserialize(*_duck, table);
+			pmt_json = ToJson(pmt);
+		}
+
+		DumpTable(table, pmt_json);
 		_demux->resetPID(table.sourcePID());
 	}
 }
@@ -47,39 +75,218 @@ void video::TSDumper::HandleSDT(ts::BinaryTable const &table)
 {
 	if (_dump_sdt)
 	{
-		ts::SDT sdt;
-		sdt.deserialize(*_duck, table);
-		Dump(ToString(sdt, *_duck));
-		Dump("\n");
+		base::Json sdt_json;
+		if (_format == OutputFormat::Json)
+		{
+			ts::SDT sdt;
+			sdt.deserialize(*_duck, table);
+			sdt_json = ToJson(sdt, *_duck);
+		}
+
+		DumpTable(table, sdt_json);
 		_demux->resetPID(0x11);
 	}
 }
 
-void TSDumper::Dump(std::string str)
+void video::TSDumper::WriteRecord(RecordType type, uint8_t const *payload, size_t size)
 {
-	// std::cout << str << std::endl;
-	(*_output_fs) << str << std::endl;
+	uint8_t header[5];
+	ts::PutUInt8(header, static_cast<uint8_t>(type));
+	ts::PutUInt32(header + 1, static_cast<uint32_t>(size));
+	_buffer.append(reinterpret_cast<char const *>(header), sizeof(header));
+	_buffer.append(reinterpret_cast<char const *>(payload), size);
+	if (_buffer.size() >= _buffer_size)
+	{
+		Flush();
+	}
+}
+
+void video::TSDumper::WriteJsonRecord(base::Json const &json)
+{
+	_buffer.append(json.dump());
+	_buffer.push_back('\n');
+	if (_buffer.size() >= _buffer_size)
+	{
+		Flush();
+	}
+}
+
+void video::TSDumper::DumpPacket(ts::TSPacket const &packet)
+{
+	if (_format == OutputFormat::Json)
+	{
+		base::Json json = ToJson(packet);
+		json["event"] = "packet";
+		json["packet_index"] = _total_packet_count;
+		WriteJsonRecord(json);
+		return;
+	}
+
+	// 最大负载：8 + 2 + 1 + 1 + 3 * 8
+	uint8_t payload[36];
+	uint8_t *p = payload;
+	ts::PutUInt64(p, _total_packet_count);
+	ts::PutUInt16(p + 8, packet.getPID());
+	ts::PutUInt8(p + 10, packet.getCC());
+	uint8_t &flags = p[11];
+	flags = 0;
+	p += 12;
+
+	if (packet.getPUSI())
+	{
+		flags |= 0x01;
+	}
+
+	if (packet.hasPCR())
+	{
+		flags |= 0x02;
+		ts::PutUInt64(p, packet.getPCR());
+		p += 8;
+	}
+
+	if (packet.hasPTS())
+	{
+		flags |= 0x04;
+		ts::PutUInt64(p, packet.getPTS());
+		p += 8;
+	}
+
+	if (packet.hasDTS())
+	{
+		flags |= 0x08;
+		ts::PutUInt64(p, packet.getDTS());
+		p += 8;
+	}
+
+	if (packet.getDiscontinuityIndicator())
+	{
+		flags |= 0x10;
+	}
+
+	WriteRecord(RecordType::Packet, payload, p - payload);
+}
+
+void video::TSDumper::DumpTable(ts::BinaryTable const &table, base::Json table_json)
+{
+	if (_format == OutputFormat::Json)
+	{
+		base::Json json{
+			{"event", "table"},
+			{"packet_index", _total_packet_count},
+			{"pid", table.sourcePID()},
+			{"table", table_json},
+		};
+
+		WriteJsonRecord(json);
+		return;
+	}
+
+	// 二进制格式直接记录段的原始字节，不需要解析表格。
+	std::vector<uint8_t> payload(14);
+	ts::PutUInt64(payload.data(), _total_packet_count);
+	ts::PutUInt16(payload.data() + 8, table.sourcePID());
+	ts::PutUInt8(payload.data() + 10, table.tableId());
+	ts::PutUInt8(payload.data() + 11, table.version());
+	ts::PutUInt16(payload.data() + 12, static_cast<uint16_t>(table.sectionCount()));
+	for (size_t i = 0; i < table.sectionCount(); i++)
+	{
+		ts::SectionPtr section = table.sectionAt(i);
+		size_t offset = payload.size();
+		payload.resize(offset + 2 + section->size());
+		ts::PutUInt16(payload.data() + offset, static_cast<uint16_t>(section->size()));
+		std::copy(section->content(), section->content() + section->size(), payload.data() + offset + 2);
+	}
+
+	WriteRecord(RecordType::Table, payload.data(), payload.size());
+}
+
+void video::TSDumper::DumpPidSummary()
+{
+	for (uint16_t pid = 0; pid < ts::PID_MAX; pid++)
+	{
+		uint64_t packet_count = _pid_packet_counts[pid];
+		uint64_t increase = packet_count - _pid_packet_counts_at_last_summary[pid];
+		if (increase == 0 || !_pid_filter[pid])
+		{
+			continue;
+		}
+
+		_pid_packet_counts_at_last_summary[pid] = packet_count;
+		if (_format == OutputFormat::Json)
+		{
+			base::Json json{
+				{"event", "pid_summary"},
+				{"packet_index", _total_packet_count},
+				{"pid", pid},
+				{"packet_count", packet_count},
+				{"increase", increase},
+			};
+
+			WriteJsonRecord(json);
+			continue;
+		}
+
+		uint8_t payload[26];
+		ts::PutUInt64(payload, _total_packet_count);
+		ts::PutUInt16(payload + 8, pid);
+		ts::PutUInt64(payload + 10, packet_count);
+		ts::PutUInt64(payload + 18, increase);
+		WriteRecord(RecordType::PidSummary, payload, sizeof(payload));
+	}
 }
 
 void video::TSDumper::SendPacket(ts::TSPacket *packet)
 {
-	if (_dump_packet)
+	uint16_t pid = packet->getPID();
+	if (_dump_packet && !_sampling_mode && _pid_filter[pid])
 	{
-		Dump(ToString(*packet));
+		DumpPacket(*packet);
 	}
 
 	_demux->feedPacket(*packet);
 	_total_packet_count++;
-	_pid__packet_count_map[packet->getPID()]++;
+	_pid_packet_counts[pid]++;
+
+	if (_sampling_mode && _summary_interval_in_packets > 0 && _total_packet_count % _summary_interval_in_packets == 0)
+	{
+		DumpPidSummary();
+	}
+}
+
+void video::TSDumper::Flush()
+{
+	if (_buffer.empty())
+	{
+		return;
+	}
+
+	_output_fs->write(_buffer.data(), _buffer.size());
+	_output_fs->flush();
+	_buffer.clear();
+}
+
+void video::TSDumper::Close()
+{
+	if (_sampling_mode)
+	{
+		// 只输出上次统计之后有新增包的 PID，最后一个窗口刚好满时不会重复输出。
+		DumpPidSummary();
+	}
+
+	Flush();
 }
 
 void video::TSDumper::DisplayStatisticalResults()
 {
 	cout << std::format("一共有 {} 个包", _total_packet_count) << endl;
-	for (auto &it : _pid__packet_count_map)
+	for (uint16_t pid = 0; pid < ts::PID_MAX; pid++)
 	{
-		uint16_t pid = it.first;
-		uint64_t packet_count = it.second;
+		uint64_t packet_count = _pid_packet_counts[pid];
+		if (packet_count == 0)
+		{
+			continue;
+		}
+
 		cout << std::format(
 					"pid = {}, packet_count = {}, rate = {}%",
 					pid,
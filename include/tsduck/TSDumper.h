@@ -5,38 +5,146 @@
 #include <tsduck/interface/ITSPacketConsumer.h>
 #include <tsduck/TsDuckToString.h>
 #include <tsTSPacket.h>
+#include <vector>
 
 namespace video
 {
+	/// <summary>
+	///		将送入的 ts 包和解析出的表格记录成结构化的事件日志。
+	///
+	///		* 每个事件是一条记录。可以选择输出成每行一个 Json 对象的格式，也可以选择输出成紧凑的二进制记录。
+	///		* 记录先写入内部缓冲区，缓冲区满了才一次性写入文件，不会每写一条记录就冲洗一次。
+	///		* 可以按 PID 过滤包事件，按表格类型过滤表格事件。
+	///		* 采样模式下不记录每一个包，只记录表格事件和定期的各个 PID 的包数统计。
+	/// </summary>
 	class TSDumper :
 		public ITSPacketConsumer,
 		public TableHandler
 	{
 	public:
-		TSDumper(std::string output_file_path);
+		/// <summary>
+		///		输出格式。
+		/// </summary>
+		enum class OutputFormat
+		{
+			/// <summary>
+			///		每行一个紧凑的 Json 对象。
+			/// </summary>
+			Json,
+
+			/// <summary>
+			///		二进制记录。
+			///		文件开头是 4 字节的魔数 "TSEL" 和 1 字节的格式版本号。
+			///		之后每条记录是 1 字节的 RecordType，4 字节大端序的负载长度，然后是负载。
+			/// </summary>
+			Binary,
+		};
+
+		/// <summary>
+		///		二进制记录的类型。负载中的整数都是大端序。
+		/// </summary>
+		enum class RecordType : uint8_t
+		{
+			/// <summary>
+			///		负载：packet_index(8) pid(2) cc(1) flags(1)，然后按 flags 依次是 PCR(8) PTS(8) DTS(8)。
+			///		flags 的 bit0 到 bit4 分别表示 PUSI、有 PCR、有 PTS、有 DTS、不连续指示。
+			/// </summary>
+			Packet = 1,
+
+			/// <summary>
+			///		负载：packet_index(8) pid(2) table_id(1) version(1) section_count(2)，
+			///		然后是每个段：段长度(2) 段的原始字节。
+			/// </summary>
+			Table = 2,
+
+			/// <summary>
+			///		负载：packet_index(8) pid(2) 总包数(8) 距离上次统计新增的包数(8)。
+			/// </summary>
+			PidSummary = 3,
+		};
+
+		/// <summary>
+		///
+		/// </summary>
+		/// <param name="output_file_path"></param>
+		/// <param name="format">输出格式。</param>
+		TSDumper(std::string output_file_path, OutputFormat format = OutputFormat::Json);
+		~TSDumper();
 
 	private:
 		std::string _output_file_path;
 		shared_ptr<std::fstream> _output_fs;
+		OutputFormat _format = OutputFormat::Json;
+
+		/// <summary>
+		///		记录先写到这里，超过 _buffer_size 后才写入文件。
+		/// </summary>
+		std::string _buffer;
 
 		uint64_t _total_packet_count = 0;
-		std::map<uint16_t, uint64_t> _pid__packet_count_map;
+
+		/// <summary>
+		///		下标是 PID，值是该 PID 的包数。
+		/// </summary>
+		std::vector<uint64_t> _pid_packet_counts = std::vector<uint64_t>(ts::PID_MAX);
+
+		/// <summary>
+		///		上次输出统计时各个 PID 的包数。
+		/// </summary>
+		std::vector<uint64_t> _pid_packet_counts_at_last_summary = std::vector<uint64_t>(ts::PID_MAX);
 
 		void HandlePAT(ts::BinaryTable const &table) override;
 		void HandlePMT(ts::BinaryTable const &table) override;
 		void HandleSDT(ts::BinaryTable const &table) override;
 
-		void Dump(std::string str);
+		void WriteRecord(RecordType type, uint8_t const *payload, size_t size);
+		void WriteJsonRecord(base::Json const &json);
+
+		void DumpPacket(ts::TSPacket const &packet);
+		void DumpTable(ts::BinaryTable const &table, base::Json table_json);
+		void DumpPidSummary();
 
 	public:
 		using ITSPacketConsumer::SendPacket;
 		void SendPacket(ts::TSPacket *packet) override;
 
+		/// <summary>
+		///		将内部缓冲区的记录写入文件。
+		/// </summary>
+		void Flush();
+
+		/// <summary>
+		///		结束记录。采样模式下先输出最后一个不满 _summary_interval_in_packets 个包的统计窗口，
+		///		然后将内部缓冲区的记录写入文件。析构时会自动调用。
+		/// </summary>
+		void Close();
+
 		void DisplayStatisticalResults();
 
 		bool _dump_packet = true;
 		bool _dump_pat = true;
 		bool _dump_pmt = true;
 		bool _dump_sdt = true;
+
+		/// <summary>
+		///		只有置位了的 PID 的包才会被记录成包事件和统计事件。默认全部置位。
+		/// </summary>
+		ts::PIDSet _pid_filter = ts::PIDSet{}.set();
+
+		/// <summary>
+		///		采样模式。为 true 时不记录每个包，只记录表格事件，并且每隔 _summary_interval_in_packets
+		///		个包输出一次各个 PID 的包数统计。
+		/// </summary>
+		bool _sampling_mode = false;
+
+		/// <summary>
+		///		采样模式下输出 PID 统计的间隔。单位：包。
+		/// </summary>
+		uint64_t _summary_interval_in_packets = 100000;
+
+		/// <summary>
+		///		内部缓冲区的大小。缓冲的数据超过此大小后会写入文件。单位：字节。
+		/// </summary>
+		size_t _buffer_size = 1024 * 1024;
 	};
 } // namespace video
@@ -1,6 +1,6 @@
 #include "tsduck/TsDuckToString.h"
 
-std::string ToString(ts::TSPacket const &packet)
+base::Json ToJson(ts::TSPacket const &packet)
 {
 	base::Json json{
 		{"PID", packet.getPID()},
@@ -57,10 +57,10 @@ std::string ToString(ts::TSPacket const &packet)
 		json["payload_unit_start_indicator"] = true;
 	}
 
-	return json.dump(4);
+	return json;
 }
 
-std::string ToString(ts::PAT const &pat)
+base::Json ToJson(ts::PAT const &pat)
 {
 	base::Json json{
 		{"table_name", "PAT"},
@@ -78,10 +78,10 @@ std::string ToString(ts::PAT const &pat)
 		json["pmts"].push_back(pmt_json);
 	}
 
-	return json.dump(4);
+	return json;
 }
 
-std::string ToString(ts::PMT const &pmt)
+base::Json ToJson(ts::PMT const &pmt)
 {
 	base::Json json{
 		{"table_name", "PMT"},
@@ -96,10 +96,10 @@ std::string ToString(ts::PMT const &pmt)
 		json["streams"].push_back(stream_json);
 	}
 
-	return json.dump(4);
+	return json;
 }
 
-std::string ToString(ts::SDT const &sdt, ts::DuckContext &duck)
+base::Json ToJson(ts::SDT const &sdt, ts::DuckContext &duck)
 {
 	base::Json json{
 		{"table_name", "SDT"},
@@ -116,5 +116,25 @@ std::string ToString(ts::SDT const &sdt, ts::DuckContext &duck)
 		json["services"].push_back(services_json);
 	}
 
-	return json.dump(4);
+	return json;
+}
+
+std::string ToString(ts::TSPacket const &packet)
+{
+	return ToJson(packet).dump(4);
+}
+
+std::string ToString(ts::PAT const &pat)
+{
+	return ToJson(pat).dump(4);
+}
+
+std::string ToString(ts::PMT const &pmt)
+{
+	return ToJson(pmt).dump(4);
+}
+
+std::string ToString(ts::SDT const &sdt, ts::DuckContext &duck)
+{
+	return ToJson(sdt, duck).dump(4);
 }
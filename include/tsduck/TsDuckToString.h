@@ -6,6 +6,14 @@
 #include <tsSDT.h>
 #include <tsTSPacket.h>
 
+/// <summary>
+///		转化为 Json 对象。调用者可以自己决定是缩进格式化还是紧凑地输出成一行。
+/// </summary>
+base::Json ToJson(ts::TSPacket const &packet);
+base::Json ToJson(ts::PAT const &pat);
+base::Json ToJson(ts::PMT const &pmt);
+base::Json ToJson(ts::SDT const &sdt, ts::DuckContext &duck);
+
 std::string ToString(ts::TSPacket const &packet);
 std::string ToString(ts::PAT const &pat);
 std::string ToString(ts::PMT const &pmt);
@@ -39,7 +39,7 @@ void video::AutoPidChanger::HandlePatVersionChange(ts::PAT &pat)
 
 	_pid_changer = shared_ptr<PidChanger>{new PidChanger{_final_pid_map}};
 	_pid_changer->AddTsPacketConsumerFromAnother(*this);
-	_pid_changer->SendPacket(TableOperator::ToTsPacket(*_duck, pat));
+	_pid_changer->SendPacket(TableOperator::ToTsPacket(*_duck, CurrentTable(), ts::PID_PAT));
 }
 
 void video::AutoPidChanger::HandlePmtVersionChange(ts::PMT &pmt, uint16_t source_pid)
@@ -53,7 +53,7 @@ void video::AutoPidChanger::HandlePmtVersionChange(ts::PMT &pmt, uint16_t source
 	}
 
 	_pid_changer->SetPidMap(_final_pid_map);
-	_pid_changer->SendPacket(TableOperator::ToTsPacket(*_duck, pmt, source_pid));
+	_pid_changer->SendPacket(TableOperator::ToTsPacket(*_duck, CurrentTable(), source_pid));
 }
 
 #pragma region PipeTsPacketSource
@@ -97,11 +97,17 @@ void video::AutoPidChanger::SendPacket(ts::TSPacket *packet)
 	{
 		if (_streams_pid_set[packet->getPID()])
 		{
-			_pid_changer->SendPacket(packet);
+			_pid_changer->SendPacket(packet, CurrentMetadata());
 		}
 		else if (packet->getPID() == 0x11)
 		{
-			_pid_changer->SendPacket(packet);
+			_pid_changer->SendPacket(packet, CurrentMetadata());
 		}
 	}
 }
+
+void video::AutoPidChanger::SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata)
+{
+	MetadataScope scope{*this, metadata};
+	SendPacket(packet);
+}
@@ -1,4 +1,5 @@
 #include "tsduck/changer/AutoServiceIdChanger.h"
+#include <tsduck/SectionPatcher.h>
 
 using namespace video;
 using namespace std;
@@ -19,76 +20,29 @@ public:
 private:
 	std::map<uint16_t, uint16_t> _service_id_map;
 
+	/* 直接在原始段上修改 service_id，不重新序列化，不认识的描述符会原样保留，并沿用原始包的布局。
+	 * 映射表由 AutoServiceIdChanger 根据 PAT 生成，包含了 PAT 中所有的节目，映射后不会冲突。
+	 */
+
 	void HandlePatVersionChange(ts::PAT &pat) override
 	{
-		ChangeServiceIdInPat(pat);
-		SendPacketToEachConsumer(TableOperator::ToTsPacket(*_duck, pat));
+		ts::BinaryTable table{CurrentTable(), ts::ShareMode::COPY};
+		SectionPatcher::ChangeServiceIdInPat(table, _service_id_map);
+		SendPacketToEachConsumer(ToTsPacketLikeCurrentTable(table, ts::PID_PAT));
 	}
 
 	void HandlePmtVersionChange(ts::PMT &pmt, uint16_t source_pid) override
 	{
-		// 如果此 PMT 的 service_id 有在映射表中，更改它。
-		auto it = _service_id_map.find(pmt.service_id);
-		if (it != _service_id_map.end())
-		{
-			pmt.service_id = it->second;
-		}
-
-		SendPacketToEachConsumer(TableOperator::ToTsPacket(*_duck, pmt, source_pid));
+		ts::BinaryTable table{CurrentTable(), ts::ShareMode::COPY};
+		SectionPatcher::ChangeServiceIdInPmt(table, _service_id_map);
+		SendPacketToEachConsumer(ToTsPacketLikeCurrentTable(table, source_pid));
 	}
 
 	void HandleSdtVersionChange(ts::BinaryTable const &table) override
 	{
-		ts::SDT sdt;
-		sdt.deserialize(*_duck, table);
-		ts::SDT backup_sdt{sdt};
-		for (auto &map_pair : _service_id_map)
-		{
-			auto it = sdt.services.find(map_pair.first);
-			if (it != sdt.services.end())
-			{
-				sdt.services.erase(it);
-			}
-		}
-
-		for (auto &map_pair : _service_id_map)
-		{
-			auto it = backup_sdt.services.find(map_pair.first);
-			if (it != backup_sdt.services.end())
-			{
-				sdt.services[map_pair.second] = it->second;
-			}
-		}
-
-		SendPacketToEachConsumer(TableOperator::ToTsPacket(*_duck, sdt));
-	}
-
-	void ChangeServiceIdInPat(ts::PAT &pat)
-	{
-		// 备份字典。
-		std::map<uint16_t, uint16_t> backup_pmts{pat.pmts};
-
-		// 遍历映射表，找出哪些键是 pat.pmts 里确实有的，将它们从 pat.pmts 中移除。
-		for (auto &map_pair : _service_id_map)
-		{
-			auto pmt = pat.pmts.find(map_pair.first);
-			if (pmt != pat.pmts.end())
-			{
-				pat.pmts.erase(pmt);
-			}
-		}
-
-		for (auto &map_pair : _service_id_map)
-		{
-			uint16_t src_service_id = map_pair.first;
-			uint16_t dst_service_id = map_pair.second;
-			auto it = backup_pmts.find(src_service_id);
-			if (it != backup_pmts.end())
-			{
-				uint16_t pmt_pid = it->second;
-				pat.pmts[dst_service_id] = pmt_pid;
-			}
-		}
+		ts::BinaryTable patched_table{table, ts::ShareMode::COPY};
+		SectionPatcher::ChangeServiceIdInSdt(patched_table, _service_id_map);
+		SendPacketToEachConsumer(ToTsPacketLikeCurrentTable(patched_table, ts::PID_SDT));
 	}
 
 public:
@@ -96,12 +50,18 @@ public:
 
 	void SendPacket(ts::TSPacket *packet) override
 	{
-		_demux->feedPacket(*packet);
+		FeedAndRecordPacket(*packet);
 		if (_streams_pid_set[packet->getPID()])
 		{
 			SendPacketToEachConsumer(packet);
 		}
 	}
+
+	void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override
+	{
+		MetadataScope scope{*this, metadata};
+		SendPacket(packet);
+	}
 };
 
 #pragma endregion
@@ -143,7 +103,7 @@ void video::AutoServiceIdChanger::HandlePatVersionChange(ts::PAT &pat)
 	// 得到最终的 _service_id_map 后，重新构造 _service_id_changer。
 	_service_id_changer = shared_ptr<ServiceIdChanger>{new ServiceIdChanger{_final_service_id_map}};
 	_service_id_changer->AddTsPacketConsumerFromAnother(*this);
-	_service_id_changer->SendPacket(TableOperator::ToTsPacket(*_duck, pat));
+	_service_id_changer->SendPacket(TableOperator::ToTsPacket(*_duck, CurrentTable(), ts::PID_PAT));
 }
 
 void video::AutoServiceIdChanger::SendPacket(ts::TSPacket *packet)
@@ -156,7 +116,13 @@ void video::AutoServiceIdChanger::SendPacket(ts::TSPacket *packet)
 		}
 		else
 		{
-			_service_id_changer->SendPacket(packet);
+			_service_id_changer->SendPacket(packet, CurrentMetadata());
 		}
 	}
 }
+
+void video::AutoServiceIdChanger::SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata)
+{
+	MetadataScope scope{*this, metadata};
+	SendPacket(packet);
+}
@@ -34,5 +34,6 @@ namespace video
 
 	public:
 		void SendPacket(ts::TSPacket *packet) override;
+		void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override;
 	};
 } // namespace video
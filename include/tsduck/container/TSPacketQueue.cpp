@@ -5,6 +5,11 @@ using namespace video;
 using namespace std;
 
 void video::TSPacketQueue::SendPacket(ts::TSPacket *packet)
+{
+	SendPacket(packet, nullptr);
+}
+
+void video::TSPacketQueue::SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata)
 {
 	if (_flushed)
 	{
@@ -17,16 +22,23 @@ void video::TSPacketQueue::SendPacket(ts::TSPacket *packet)
 		return;
 	}
 
-	_packet_queue.Enqueue(*packet);
+	_packet_queue.Enqueue(Item{*packet, metadata ? *metadata : ts::TSPacketMetadata{}});
 }
 
 ITSPacketSource::ReadPacketResult video::TSPacketQueue::ReadPacket(ts::TSPacket &packet)
 {
-	base::Placement<ts::TSPacket> packet_placement;
-	_packet_queue.TryDequeue(packet_placement);
-	if (packet_placement.Available())
+	ts::TSPacketMetadata metadata;
+	return ReadPacket(packet, metadata);
+}
+
+ITSPacketSource::ReadPacketResult video::TSPacketQueue::ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata)
+{
+	base::Placement<Item> item_placement;
+	_packet_queue.TryDequeue(item_placement);
+	if (item_placement.Available())
 	{
-		packet = packet_placement.Object();
+		packet = item_placement.Object().packet;
+		metadata = item_placement.Object().metadata;
 		return ITSPacketSource::ReadPacketResult::Success;
 	}
 
@@ -10,7 +10,16 @@ namespace video
 		public ITSPacketSource
 	{
 	private:
-		base::Queue<ts::TSPacket> _packet_queue;
+		/// <summary>
+		///		队列中的包和它的元数据。
+		/// </summary>
+		struct Item
+		{
+			ts::TSPacket packet;
+			ts::TSPacketMetadata metadata;
+		};
+
+		base::Queue<Item> _packet_queue;
 		bool _flushed = false;
 
 	public:
@@ -22,6 +31,13 @@ namespace video
 		/// <param name="packet"></param>
 		void SendPacket(ts::TSPacket *packet) override;
 
+		/// <summary>
+		///		送入包和元数据，元数据随包一起入队。
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <param name="metadata"></param>
+		void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override;
+
 		/// <summary>
 		///		读取包。
 		/// </summary>
@@ -31,5 +47,13 @@ namespace video
 		///		否则返回 ITSPacketSource::ReadPacketResult::NeedMoreInput。
 		/// </returns>
 		ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet) override;
+
+		/// <summary>
+		///		读取包和送入时的元数据。送入时没有元数据的包读出的是默认的元数据。
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <param name="metadata"></param>
+		/// <returns></returns>
+		ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata) override;
 	};
 } // namespace video
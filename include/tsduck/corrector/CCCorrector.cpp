@@ -30,3 +30,23 @@ void video::CCCorrector::SendPacket(ts::TSPacket *packet)
 	CorrectCC(*packet);
 	SendPacketToEachConsumer(packet);
 }
+
+void video::CCCorrector::SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata)
+{
+	MetadataScope scope{*this, metadata};
+	SendPacket(packet);
+}
+
+void video::CCCorrector::SendPacketWindow(ts::TSPacketWindow &window)
+{
+	for (size_t i = 0; i < window.size(); i++)
+	{
+		ts::TSPacket *packet = window.packet(i);
+		if (packet)
+		{
+			CorrectCC(*packet);
+		}
+	}
+
+	SendPacketWindowToEachConsumer(window);
+}
@@ -32,5 +32,12 @@ namespace video
 	public:
 		using ITSPacketConsumer::SendPacket;
 		void SendPacket(ts::TSPacket *packet) override;
+		void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override;
+
+		/// <summary>
+		///		就地更正窗口中的包的连续性计数。
+		/// </summary>
+		/// <param name="window"></param>
+		void SendPacketWindow(ts::TSPacketWindow &window) override;
 	};
 } // namespace video
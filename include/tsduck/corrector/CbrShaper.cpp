@@ -0,0 +1,257 @@
+#include "tsduck/corrector/CbrShaper.h"
+#include <base/string/define.h>
+#include <cmath>
+#include <tsPES.h>
+#include <vector>
+
+using namespace video;
+using namespace std;
+
+video::CbrShaper::CbrShaper(uint64_t bitrate)
+{
+	if (bitrate == 0)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"码率不能为 0."}};
+	}
+
+	_bitrate = bitrate;
+	_time_per_packet = double(ts::PKT_SIZE_BITS) * ts::SYSTEM_CLOCK_FREQ / _bitrate;
+}
+
+void video::CbrShaper::SendPacket(ts::TSPacket *packet)
+{
+	uint16_t pid = packet->getPID();
+	UpdateEsPidPriority(*packet);
+	if (_ref_pid == ts::PID_NULL && packet->hasPCR() && (_pcr_pid == ts::PID_NULL || _pcr_pid == pid))
+	{
+		_ref_pid = pid;
+	}
+
+	bool is_ref = pid == _ref_pid && packet->hasPCR();
+	if (!_clock_started)
+	{
+		if (!is_ref)
+		{
+			// 还没有时间基准，原样输出。
+			SendPacketToEachConsumer(packet);
+			return;
+		}
+
+		_clock_started = true;
+		_last_ref_pcr = packet->getPCR();
+		_last_ref_time = 0;
+		_output_time = 0;
+		_packets_since_ref = 0;
+		_pending_packets.push_back(PendingPacket{*packet, 0, 0, CopyCurrentMetadata()});
+		_unassigned_begin = _pending_packets.size();
+		return;
+	}
+
+	_packets_since_ref++;
+	if (is_ref)
+	{
+		OnReferencePcr(*packet);
+		return;
+	}
+
+	if (pid != ts::PID_NULL)
+	{
+		_pending_packets.push_back(PendingPacket{*packet, _packets_since_ref, 0, CopyCurrentMetadata()});
+	}
+
+	if (_packets_since_ref > _max_packets_without_pcr)
+	{
+		// 参考 PID 消失了。
+		Flush();
+	}
+}
+
+void video::CbrShaper::SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata)
+{
+	MetadataScope scope{*this, metadata};
+	SendPacket(packet);
+}
+
+ts::TSPacketMetadata video::CbrShaper::CopyCurrentMetadata() const
+{
+	ts::TSPacketMetadata *metadata = CurrentMetadata();
+	return metadata ? *metadata : ts::TSPacketMetadata{};
+}
+
+void video::CbrShaper::OnReferencePcr(ts::TSPacket const &packet)
+{
+	uint64_t pcr = packet.getPCR();
+	uint64_t delta = (pcr + ts::PCR_SCALE - _last_ref_pcr) % ts::PCR_SCALE;
+	double interval = double(delta);
+	if (packet.getDiscontinuityIndicator() || delta == 0 || delta > _max_pcr_interval)
+	{
+		// 时钟不连续，按目标码率推算这段时间。
+		interval = _packets_since_ref * _time_per_packet;
+	}
+
+	double time = _last_ref_time + interval;
+	for (size_t i = _unassigned_begin; i < _pending_packets.size(); i++)
+	{
+		PendingPacket &pending = _pending_packets[i];
+		pending._input_time = _last_ref_time + interval * pending._index_since_ref / _packets_since_ref;
+	}
+
+	_pending_packets.push_back(PendingPacket{packet, _packets_since_ref, time, CopyCurrentMetadata()});
+	_unassigned_begin = _pending_packets.size();
+	_last_ref_pcr = pcr;
+	_last_ref_time = time;
+	_packets_since_ref = 0;
+
+	EmitUntil(time);
+}
+
+void video::CbrShaper::EmitUntil(double time)
+{
+	while (_output_time < time)
+	{
+		if (_unassigned_begin > 0 && _pending_packets.front()._input_time <= _output_time)
+		{
+			EmitPending(_pending_packets.front());
+			_pending_packets.pop_front();
+			_unassigned_begin--;
+		}
+		else
+		{
+			// 填充的空包不带元数据。
+			ts::TSPacket null_packet = ts::NullPacket;
+			SendPacketToEachConsumer(&null_packet, nullptr);
+			_stuffing_packet_count++;
+		}
+
+		_output_time += _time_per_packet;
+	}
+
+	// 已经到期却没能输出的包就是超出码率预算的包。
+	size_t overdue_count = 0;
+	while (overdue_count < _unassigned_begin && _pending_packets[overdue_count]._input_time <= _output_time)
+	{
+		overdue_count++;
+	}
+
+	if (overdue_count > _max_hold_back_packet_count)
+	{
+		DropOverduePackets(overdue_count);
+	}
+}
+
+void video::CbrShaper::UpdateEsPidPriority(ts::TSPacket const &packet)
+{
+	if (!packet.startPES() || packet.getPayloadSize() < 4)
+	{
+		return;
+	}
+
+	uint8_t stream_id = packet.getPayload()[3];
+	if (ts::IsAudioSID(stream_id))
+	{
+		_es_pid_priority[packet.getPID()] = 2;
+	}
+	else if (ts::IsVideoSID(stream_id))
+	{
+		_es_pid_priority[packet.getPID()] = 1;
+	}
+	else
+	{
+		_es_pid_priority[packet.getPID()] = 0;
+	}
+}
+
+int video::CbrShaper::DropPriority(ts::TSPacket const &packet) const
+{
+	if (packet.getPID() < 0x20 || packet.hasPCR())
+	{
+		return -1;
+	}
+
+	auto it = _es_pid_priority.find(packet.getPID());
+	if (it == _es_pid_priority.end())
+	{
+		return -1;
+	}
+
+	return it->second;
+}
+
+void video::CbrShaper::DropOverduePackets(size_t overdue_count)
+{
+	size_t excess = overdue_count - _max_hold_back_packet_count;
+	std::vector<bool> drop(overdue_count, false);
+	for (int priority = 0; priority <= 2 && excess > 0; priority++)
+	{
+		for (size_t i = 0; i < overdue_count && excess > 0; i++)
+		{
+			if (!drop[i] && DropPriority(_pending_packets[i]._packet) == priority)
+			{
+				drop[i] = true;
+				excess--;
+			}
+		}
+	}
+
+	// 一次性压缩，不逐个从中间删除。
+	size_t kept = 0;
+	for (size_t i = 0; i < overdue_count; i++)
+	{
+		if (!drop[i])
+		{
+			if (kept != i)
+			{
+				_pending_packets[kept] = std::move(_pending_packets[i]);
+			}
+
+			kept++;
+		}
+	}
+
+	size_t dropped = overdue_count - kept;
+	_pending_packets.erase(_pending_packets.begin() + kept, _pending_packets.begin() + overdue_count);
+	_unassigned_begin -= dropped;
+	_dropped_packet_count += dropped;
+}
+
+void video::CbrShaper::EmitPending(PendingPacket &pending)
+{
+	if (pending._packet.hasPCR())
+	{
+		// 包被移到了 _output_time 输出，PCR 要加上这段位移。
+		int64_t correction = std::llround(_output_time - pending._input_time);
+		int64_t pcr = (int64_t(pending._packet.getPCR()) + correction) % int64_t(ts::PCR_SCALE);
+		if (pcr < 0)
+		{
+			pcr += ts::PCR_SCALE;
+		}
+
+		pending._packet.setPCR(uint64_t(pcr));
+	}
+
+	SendPacketToEachConsumer(&pending._packet, &pending._metadata);
+}
+
+void video::CbrShaper::Flush()
+{
+	for (size_t i = 0; i < _pending_packets.size(); i++)
+	{
+		PendingPacket &pending = _pending_packets[i];
+		if (i >= _unassigned_begin)
+		{
+			// 后面没有参考 PCR 了，按目标码率推算输入时间。
+			pending._input_time = _last_ref_time + pending._index_since_ref * _time_per_packet;
+		}
+
+		// 不再填充空包，但输出时间仍然要前进，PCR 才能和输出位置对应。
+		_output_time = std::max(_output_time, pending._input_time);
+		EmitPending(pending);
+		_output_time += _time_per_packet;
+	}
+
+	_pending_packets.clear();
+	_unassigned_begin = 0;
+	_clock_started = false;
+	_packets_since_ref = 0;
+	_ref_pid = ts::PID_NULL;
+}
@@ -0,0 +1,178 @@
+#pragma once
+#include <deque>
+#include <map>
+#include <tsduck/interface/ITSPacketConsumer.h>
+#include <tsduck/PipeTsPacketSource.h>
+#include <tsTSPacket.h>
+
+namespace video
+{
+	/// <summary>
+	///		恒定码率整形器。把输入的 ts 流整形成指定码率的恒定码率流。
+	///
+	///		* 以参考 PID 的 PCR 为时间基准，参考 PCR 之间的包按位置线性插值得到输入时间。
+	///		* 输出端每个包占一个时隙，时隙的时间由目标码率决定。时隙到了而没有到期的包就插入空包。
+	///		* 输入的空包会被丢弃，由本对象重新填充。
+	///		* 输入码率超过目标码率时包会被推迟输出。推迟的包超过 _max_hold_back_packet_count 个时丢包：
+	///		  只丢弃承载 PES 的 PID 上不带 PCR 的包，先丢弃数据流（字幕、私有流等），再丢弃视频，最后丢弃音频，
+	///		  同一优先级内先丢弃最早的包。PSI 和带 PCR 的包永远不丢弃。
+	///		* 丢包会造成连续性计数跳变，所以后面应该接 CCCorrector. TSOutputCorrector 就是这样串联的。
+	///		* 包的输出位置变了，所有 PID 的 PCR 都会按输出时间与输入时间的差值重新打时间戳。
+	///		* 第一个参考 PCR 之前的包原样输出。
+	/// </summary>
+	class CbrShaper :
+		public ITSPacketConsumer,
+		public PipeTsPacketSource
+	{
+	public:
+		/// <summary>
+		///
+		/// </summary>
+		/// <param name="bitrate">目标码率。单位：bps。</param>
+		CbrShaper(uint64_t bitrate);
+
+	private:
+		/// <summary>
+		///		等待输出的包。
+		/// </summary>
+		class PendingPacket
+		{
+		public:
+			ts::TSPacket _packet;
+
+			/// <summary>
+			///		自上一个参考 PCR 以来的包序号（包括被丢弃的空包）。用来插值计算 _input_time.
+			/// </summary>
+			uint64_t _index_since_ref = 0;
+
+			/// <summary>
+			///		输入时间。单位：27MHz 时钟周期，不回绕。
+			/// </summary>
+			double _input_time = 0;
+
+			/// <summary>
+			///		送入时的元数据，输出时随包送出。
+			/// </summary>
+			ts::TSPacketMetadata _metadata;
+		};
+
+		uint64_t _bitrate = 0;
+		double _time_per_packet = 0;
+
+		std::deque<PendingPacket> _pending_packets;
+
+		/// <summary>
+		///		_pending_packets 中从这个位置开始的包还没有计算输入时间。
+		/// </summary>
+		size_t _unassigned_begin = 0;
+
+		bool _clock_started = false;
+
+		/// <summary>
+		///		实际使用的参考 PID.
+		/// </summary>
+		uint16_t _ref_pid = ts::PID_NULL;
+
+		uint64_t _last_ref_pcr = 0;
+		double _last_ref_time = 0;
+		uint64_t _packets_since_ref = 0;
+
+		/// <summary>
+		///		下一个输出时隙的时间。单位：27MHz 时钟周期，不回绕。
+		/// </summary>
+		double _output_time = 0;
+
+		uint64_t _stuffing_packet_count = 0;
+		uint64_t _dropped_packet_count = 0;
+
+		/// <summary>
+		///		承载 PES 的 PID 的丢弃优先级，数值越小越先丢弃。
+		///		见过 PES 包头的 PID 才会出现在这里，不在这里的 PID 都当作 PSI, 不会被丢弃。
+		/// </summary>
+		std::map<uint16_t, int> _es_pid_priority;
+
+		/// <summary>
+		///		根据 PES 包头中的 stream_id 记录 PID 的丢弃优先级。
+		/// </summary>
+		/// <param name="packet"></param>
+		void UpdateEsPidPriority(ts::TSPacket const &packet);
+
+		/// <summary>
+		///		包的丢弃优先级。不能丢弃时返回 -1.
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <returns></returns>
+		int DropPriority(ts::TSPacket const &packet) const;
+
+		/// <summary>
+		///		从前 overdue_count 个已经到期的包中丢弃超出 _max_hold_back_packet_count 的部分。
+		///		没有足够的可丢弃的包时少丢一些。
+		/// </summary>
+		/// <param name="overdue_count"></param>
+		void DropOverduePackets(size_t overdue_count);
+
+		void OnReferencePcr(ts::TSPacket const &packet);
+
+		/// <summary>
+		///		输出时隙直到 time. 没有到期的包就输出空包。
+		/// </summary>
+		/// <param name="time"></param>
+		void EmitUntil(double time);
+
+		void EmitPending(PendingPacket &pending);
+
+		/// <summary>
+		///		正在处理的包的元数据的副本。没有元数据时返回默认的元数据。
+		/// </summary>
+		/// <returns></returns>
+		ts::TSPacketMetadata CopyCurrentMetadata() const;
+
+	public:
+		/// <summary>
+		///		参考 PCR 的 PID. 为 ts::PID_NULL 表示使用第一个携带 PCR 的 PID.
+		/// </summary>
+		uint16_t _pcr_pid = ts::PID_NULL;
+
+		/// <summary>
+		///		最多推迟多少个包。超过后按优先级丢包。
+		/// </summary>
+		size_t _max_hold_back_packet_count = 10000;
+
+		/// <summary>
+		///		参考 PCR 的间隔超过这个值就认为是不连续，此时按目标码率推算时间。单位：27MHz 时钟周期。
+		/// </summary>
+		uint64_t _max_pcr_interval = ts::SYSTEM_CLOCK_FREQ;
+
+		/// <summary>
+		///		两个参考 PCR 之间最多缓存多少个包。参考 PID 消失后超过这个值就冲洗缓存，重新寻找参考 PCR.
+		/// </summary>
+		uint64_t _max_packets_without_pcr = 100000;
+
+		using ITSPacketConsumer::SendPacket;
+		void SendPacket(ts::TSPacket *packet) override;
+		void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override;
+
+		/// <summary>
+		///		不填充空包，立刻输出所有缓存的包，然后重新寻找参考 PCR. 输入结束时调用。
+		/// </summary>
+		void Flush();
+
+		/// <summary>
+		///		插入的空包数。
+		/// </summary>
+		/// <returns></returns>
+		uint64_t StuffingPacketCount() const
+		{
+			return _stuffing_packet_count;
+		}
+
+		/// <summary>
+		///		因为超过码率预算而丢弃的包数。不包括输入的空包。
+		/// </summary>
+		/// <returns></returns>
+		uint64_t DroppedPacketCount() const
+		{
+			return _dropped_packet_count;
+		}
+	};
+} // namespace video
@@ -8,22 +8,48 @@ video::TSOutputCorrector::TSOutputCorrector()
 	_repeater->AddTsPacketConsumer(_cccorrect);
 }
 
+video::TSOutputCorrector::TSOutputCorrector(uint64_t cbr_bitrate)
+{
+	// 整形器丢包会造成连续性计数跳变，所以放在 CCCorrector 前面。
+	_cbr_shaper = shared_ptr<video::CbrShaper>{new video::CbrShaper{cbr_bitrate}};
+	_repeater->AddTsPacketConsumer(_cbr_shaper);
+	_cbr_shaper->AddTsPacketConsumer(_cccorrect);
+}
+
+IPipeTsPacketSource &video::TSOutputCorrector::OutputStage()
+{
+	return *_cccorrect;
+}
+
 void video::TSOutputCorrector::AddTsPacketConsumer(shared_ptr<ITSPacketConsumer> packet_comsumer)
 {
-	_cccorrect->AddTsPacketConsumer(packet_comsumer);
+	OutputStage().AddTsPacketConsumer(packet_comsumer);
 }
 
 bool video::TSOutputCorrector::RemovePacketConsumer(shared_ptr<ITSPacketConsumer> packet_comsumer)
 {
-	return _cccorrect->RemovePacketConsumer(packet_comsumer);
+	return OutputStage().RemovePacketConsumer(packet_comsumer);
 }
 
 void video::TSOutputCorrector::ClearConsumers()
 {
-	_cccorrect->ClearConsumers();
+	OutputStage().ClearConsumers();
 }
 
 void video::TSOutputCorrector::SendPacket(ts::TSPacket *packet)
 {
 	_repeater->SendPacket(packet);
 }
+
+void video::TSOutputCorrector::SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata)
+{
+	_repeater->SendPacket(packet, metadata);
+}
+
+void video::TSOutputCorrector::Flush()
+{
+	if (_cbr_shaper)
+	{
+		_cbr_shaper->Flush();
+	}
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <tsduck/corrector/CbrShaper.h>
 #include <tsduck/corrector/CCCorrector.h>
 #include <tsduck/corrector/TableRepeater.h>
 
@@ -7,6 +8,10 @@ namespace video
 	/// <summary>
 	///		输出校正器。组合了多个校正器，用来当作输出端口，对输出进行矫正，这样就不用每次
 	///		都重复串联一大堆管道了。
+	///
+	///		* 指定了码率时工作在恒定码率模式，CbrShaper 会填充空包并重新打 PCR 时间戳，
+	///		  可以直接送给调制器或 IP 输出。CbrShaper 放在 CCCorrector 前面，它丢包造成的
+	///		  连续性计数跳变会被 CCCorrector 修复。
 	/// </summary>
 	class TSOutputCorrector :
 		public IPipeTsPacketSource,
@@ -15,10 +20,27 @@ namespace video
 	public:
 		TSOutputCorrector();
 
+		/// <summary>
+		///		恒定码率模式。
+		/// </summary>
+		/// <param name="cbr_bitrate">输出码率。单位：bps。</param>
+		TSOutputCorrector(uint64_t cbr_bitrate);
+
 	private:
 		shared_ptr<CCCorrector> _cccorrect{new CCCorrector{}};
 		shared_ptr<TableRepeater> _repeater{new TableRepeater{}};
 
+		/// <summary>
+		///		不是恒定码率模式时为空。
+		/// </summary>
+		shared_ptr<CbrShaper> _cbr_shaper;
+
+		/// <summary>
+		///		最后一级。消费者都添加到这里。
+		/// </summary>
+		/// <returns></returns>
+		IPipeTsPacketSource &OutputStage();
+
 	public:
 #pragma region 通过 IPipeTsPacketSource 继承
 		void AddTsPacketConsumer(shared_ptr<ITSPacketConsumer> packet_comsumer) override;
@@ -28,5 +50,20 @@ namespace video
 
 		using ITSPacketConsumer::SendPacket;
 		void SendPacket(ts::TSPacket *packet) override;
+		void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override;
+
+		/// <summary>
+		///		恒定码率模式下的整形器。不是恒定码率模式时返回空指针。
+		/// </summary>
+		/// <returns></returns>
+		shared_ptr<video::CbrShaper> GetCbrShaper()
+		{
+			return _cbr_shaper;
+		}
+
+		/// <summary>
+		///		输入结束时调用，输出恒定码率模式下缓存的包。
+		/// </summary>
+		void Flush();
 	};
 } // namespace video
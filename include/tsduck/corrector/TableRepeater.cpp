@@ -4,7 +4,7 @@ using namespace std;
 
 void video::TableRepeater::HandlePatVersionChange(ts::PAT &pat)
 {
-	_pat_packets = TableOperator::ToTsPacket(*_duck, pat);
+	_pat_packets = TableOperator::ToTsPacket(*_duck, CurrentTable(), ts::PID_PAT);
 	SendPacketToEachConsumer(_pat_packets);
 
 	// PMT 要重新解析
@@ -14,16 +14,14 @@ void video::TableRepeater::HandlePatVersionChange(ts::PAT &pat)
 
 void video::TableRepeater::HandlePmtVersionChange(ts::PMT &pmt, uint16_t source_pid)
 {
-	std::vector<ts::TSPacket> pmt_pckets = TableOperator::ToTsPacket(*_duck, pmt, source_pid);
+	std::vector<ts::TSPacket> pmt_pckets = TableOperator::ToTsPacket(*_duck, CurrentTable(), source_pid);
 	_pmt_packet_vectors.push_back(pmt_pckets);
 	SendPacketToEachConsumer(pmt_pckets);
 }
 
 void video::TableRepeater::HandleSdtVersionChange(ts::BinaryTable const &table)
 {
-	ts::SDT sdt;
-	sdt.deserialize(*_duck, table);
-	_sdt_packets = TableOperator::ToTsPacket(*_duck, sdt);
+	_sdt_packets = TableOperator::ToTsPacket(*_duck, table, ts::PID_SDT);
 	SendPacketToEachConsumer(_sdt_packets);
 }
 
@@ -34,30 +32,69 @@ void video::TableRepeater::SendTable()
 	SendPacketToEachConsumer(_pmt_packet_vectors);
 }
 
-void video::TableRepeater::SendPacket(ts::TSPacket *packet)
+void video::TableRepeater::HandlePacket(ts::TSPacket const &packet)
 {
-	_demux->feedPacket(*packet);
-	if (packet->hasPCR())
+	_demux->feedPacket(packet);
+	_timeline.feedPacket(packet);
+	if (packet.hasPCR() && packet.getPID() == _timeline.referencePCRPID())
 	{
-		// PCR 每 100 毫秒发送一次。
-		uint64_t _current_pcr = packet->getPCR();
+		if (packet.getPID() != _pcr_pid_at_last_send_pat_pmt)
+		{
+			// 参考 PID 变了，上次发送时的 PCR 属于另一个时钟，立刻重新发送并重新计时。
+			_table_sent = false;
+		}
 
-		// diff_pcr_at_send_pat = _current_pcr - _pcr_at_last_send_pat_pmt
-		uint64_t diff_pcr_at_send_pat = ts::DiffPCR(_pcr_at_last_send_pat_pmt, _current_pcr);
-		int64_t millisecond = ts::PCRToMilliSecond(diff_pcr_at_send_pat);
-		if (millisecond >= _repeat_table_interval_in_milliseconds)
+		// PCR 已经展开回绕，直接相减。
+		int64_t current_pcr = _timeline.referencePCR();
+		int64_t millisecond = ts::TimelineDemux::PCRToMilliSecond(_pcr_at_last_send_pat_pmt, current_pcr);
+		if (!_table_sent || millisecond >= _repeat_table_interval_in_milliseconds)
 		{
 			SendTable();
-			_pcr_at_last_send_pat_pmt = _current_pcr;
+			_pcr_at_last_send_pat_pmt = current_pcr;
+			_pcr_pid_at_last_send_pat_pmt = packet.getPID();
+			_table_sent = true;
 		}
 	}
+}
 
+void video::TableRepeater::SendPacket(ts::TSPacket *packet)
+{
+	HandlePacket(*packet);
 	if (_streams_pid_set[packet->getPID()])
 	{
 		SendPacketToEachConsumer(packet);
 	}
 }
 
+void video::TableRepeater::SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata)
+{
+	MetadataScope scope{*this, metadata};
+	SendPacket(packet);
+}
+
+void video::TableRepeater::SendPacketWindow(ts::TSPacketWindow &window)
+{
+	BeginWindow(window);
+	for (size_t i = 0; i < window.size(); i++)
+	{
+		ts::TSPacket *packet = window.packet(i);
+		if (!packet)
+		{
+			continue;
+		}
+
+		// 表格插入到当前包之前。
+		SetWindowPosition(i);
+		HandlePacket(*packet);
+		if (!_streams_pid_set[packet->getPID()])
+		{
+			window.drop(i);
+		}
+	}
+
+	EndWindow();
+}
+
 int64_t video::TableRepeater::RepeatPatPmtIntervalInMillisecond()
 {
 	return _repeat_table_interval_in_milliseconds;
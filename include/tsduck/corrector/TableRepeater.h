@@ -5,6 +5,7 @@
 #include <tsduck/TableOperator.h>
 #include <tsDuckContext.h>
 #include <tsSectionDemux.h>
+#include <tsTimelineDemux.h>
 
 namespace video
 {
@@ -19,9 +20,22 @@ namespace video
 		std::vector<std::vector<ts::TSPacket>> _pmt_packet_vectors;
 
 		/// <summary>
-		///		上次送入包时的 PCR。
+		///		跟踪 PCR, 计算距离上次发送表格的时间。
 		/// </summary>
-		uint64_t _pcr_at_last_send_pat_pmt = 0;
+		ts::TimelineDemux _timeline{*_duck};
+
+		/// <summary>
+		///		上次发送表格时的 PCR。是 _timeline 中展开回绕后的值。
+		/// </summary>
+		int64_t _pcr_at_last_send_pat_pmt = 0;
+
+		/// <summary>
+		///		_pcr_at_last_send_pat_pmt 所在的 PID. 解析到 PMT 后参考 PCR 的 PID 可能会变，
+		///		不同 PID 的 PCR 不能相减，变了就要重新计时。
+		/// </summary>
+		uint16_t _pcr_pid_at_last_send_pat_pmt = ts::PID_NULL;
+
+		bool _table_sent = false;
 		int64_t _repeat_table_interval_in_milliseconds = 1000;
 
 		void HandlePatVersionChange(ts::PAT &pat) override;
@@ -30,9 +44,22 @@ namespace video
 
 		void SendTable();
 
+		/// <summary>
+		///		解析包，到了重复发送的时间就发送表格。
+		/// </summary>
+		/// <param name="packet"></param>
+		void HandlePacket(ts::TSPacket const &packet);
+
 	public:
 		using ITSPacketConsumer::SendPacket;
 		void SendPacket(ts::TSPacket *packet) override;
+		void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override;
+
+		/// <summary>
+		///		重复发送的表格包会被拼接进窗口，不输出的包会被丢弃。
+		/// </summary>
+		/// <param name="window"></param>
+		void SendPacketWindow(ts::TSPacketWindow &window) override;
 
 		/// <summary>
 		///		重复发送表格的时间间隔。单位：毫秒。
@@ -0,0 +1,269 @@
+#include "tsduck/generator/SyntheticTsStream.h"
+#include <base/string/define.h>
+#include <tsPESPacket.h>
+#include <tsPESStreamPacketizer.h>
+
+using namespace video;
+using namespace std;
+
+video::SyntheticTsStream::SyntheticTsStream(uint16_t service_count, uint16_t es_count_per_service, uint64_t bitrate)
+{
+	if (service_count == 0 || PmtPid(service_count - 1) + 0x0F >= ts::PID_NULL)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"节目数必须在 1 到 "} + std::to_string((ts::PID_NULL - 0x100) / 0x10) + " 之间。"};
+	}
+
+	if (es_count_per_service == 0 || es_count_per_service > 0x0F)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"每个节目的基本流数必须在 1 到 15 之间。"}};
+	}
+
+	if (bitrate == 0)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"码率不能为 0."}};
+	}
+
+	_service_count = service_count;
+	_es_count_per_service = es_count_per_service;
+	_bitrate = bitrate;
+}
+
+void video::SyntheticTsStream::Initialize()
+{
+	_pcr_per_packet = double(ts::PKT_SIZE_BITS) * ts::SYSTEM_CLOCK_FREQ / _bitrate;
+
+	for (uint16_t i = 0; i < _service_count; i++)
+	{
+		for (uint16_t j = 0; j < _es_count_per_service; j++)
+		{
+			ElementaryStream stream;
+			stream._pid = PmtPid(i) + 1 + j;
+			BuildTemplatePackets(stream, j == 0);
+			_streams.push_back(stream);
+		}
+
+		// 错开各个节目插入 PCR 的位置。
+		_next_pcr_packet_indexes.push_back(i);
+	}
+
+	_pat_packetizer = shared_ptr<ts::CyclingPacketizer>{
+		new ts::CyclingPacketizer{_duck, ts::PID_PAT, ts::CyclingPacketizer::StuffingPolicy::ALWAYS},
+	};
+
+	_sdt_packetizer = shared_ptr<ts::CyclingPacketizer>{
+		new ts::CyclingPacketizer{_duck, ts::PID_SDT, ts::CyclingPacketizer::StuffingPolicy::ALWAYS},
+	};
+
+	for (uint16_t i = 0; i < _service_count; i++)
+	{
+		_pmt_packetizers.push_back(shared_ptr<ts::CyclingPacketizer>{
+			new ts::CyclingPacketizer{_duck, PmtPid(i), ts::CyclingPacketizer::StuffingPolicy::ALWAYS},
+		});
+	}
+
+	BuildTables();
+	_next_version_bump_packet_index = MillisecondToPacketCount(_version_bump_interval_in_milliseconds);
+	_initialized = true;
+}
+
+void video::SyntheticTsStream::BuildTables()
+{
+	uint8_t version = _pat.version;
+	_pat = ts::PAT{version, true, 1};
+	_sdt = ts::SDT{true, version, true, 1, 1};
+	_pmts.clear();
+	for (uint16_t i = 0; i < _service_count; i++)
+	{
+		uint16_t service_id = i + 1;
+		uint16_t pcr_pid = PmtPid(i) + 1;
+		_pat.pmts[service_id] = PmtPid(i);
+
+		ts::PMT pmt{version, true, service_id, pcr_pid};
+		for (uint16_t j = 0; j < _es_count_per_service; j++)
+		{
+			pmt.streams[pcr_pid + j].stream_type = j == 0 ? ts::ST_AVC_VIDEO : ts::ST_MPEG2_AUDIO;
+		}
+
+		_pmts.push_back(pmt);
+		_sdt.services[service_id].setName(_duck, ts::UString::Format(u"Synthetic %d", {service_id}));
+		_sdt.services[service_id].setProvider(_duck, u"SyntheticTsStream");
+	}
+
+	_pat_packetizer->removeAll();
+	_pat_packetizer->addTable(_duck, _pat);
+	_sdt_packetizer->removeAll();
+	_sdt_packetizer->addTable(_duck, _sdt);
+	for (uint16_t i = 0; i < _service_count; i++)
+	{
+		_pmt_packetizers[i]->removeAll();
+		_pmt_packetizers[i]->addTable(_duck, _pmts[i]);
+	}
+}
+
+void video::SyntheticTsStream::BuildTemplatePackets(ElementaryStream &stream, bool is_video)
+{
+	// PES 头：起始码、流 ID、长度、只带 PTS。PTS 在输出时才写入。
+	std::vector<uint8_t> content(14 + _pes_payload_size, 0xAA);
+	size_t pes_length = content.size() - 6;
+	ts::PutUInt32(content.data(), 0x00000100 | (is_video ? 0xE0 : 0xC0));
+	ts::PutUInt16(content.data() + 4, pes_length <= 0xFFFF ? uint16_t(pes_length) : 0);
+	content[6] = 0x80;
+	content[7] = 0x80;
+	content[8] = 0x05;
+	ts::PutUInt8(content.data() + 9, 0x21);
+	ts::PutUInt16(content.data() + 10, 0x0001);
+	ts::PutUInt16(content.data() + 12, 0x0001);
+
+	ts::PESStreamPacketizer packetizer{_duck, stream._pid};
+	packetizer.addPES(ts::PESPacket{content.data(), content.size(), stream._pid}, ts::ShareMode::COPY);
+	ts::TSPacket packet;
+	while (!packetizer.empty() && packetizer.getNextPacket(packet))
+	{
+		stream._template_packets.push_back(packet);
+	}
+}
+
+void video::SyntheticTsStream::LoadTables(ts::CyclingPacketizer &packetizer)
+{
+	ts::TSPacket packet;
+	do
+	{
+		packetizer.getNextPacket(packet);
+		_table_packets.push_back(packet);
+	} while (!packetizer.atCycleBoundary());
+}
+
+void video::SyntheticTsStream::BumpVersion()
+{
+	_pat.version = (_pat.version + 1) & 0x1F;
+	BuildTables();
+}
+
+uint64_t video::SyntheticTsStream::MillisecondToPacketCount(int64_t millisecond)
+{
+	if (millisecond <= 0)
+	{
+		return 0;
+	}
+
+	uint64_t count = uint64_t(millisecond) * _bitrate / (ts::PKT_SIZE_BITS * 1000);
+	return count > 0 ? count : 1;
+}
+
+uint64_t video::SyntheticTsStream::PacketIndexToPcr(uint64_t packet_index)
+{
+	return uint64_t(packet_index * _pcr_per_packet) % ts::PCR_SCALE;
+}
+
+void video::SyntheticTsStream::InjectFault(ts::TSPacket &packet)
+{
+	if (_cc_error_interval_in_packets > 0 && _packet_index % _cc_error_interval_in_packets == _cc_error_interval_in_packets - 1)
+	{
+		packet.setCC(packet.getCC() + 1);
+	}
+
+	if (_sync_loss_interval_in_packets > 0 && _packet_index % _sync_loss_interval_in_packets == _sync_loss_interval_in_packets - 1)
+	{
+		packet.b[0] = 0;
+	}
+}
+
+ITSPacketSource::ReadPacketResult video::SyntheticTsStream::ReadPacket(ts::TSPacket &packet)
+{
+	if (!_initialized)
+	{
+		Initialize();
+	}
+
+	if (_max_packet_count > 0 && _packet_index >= _max_packet_count)
+	{
+		return ITSPacketSource::ReadPacketResult::NoMorePacket;
+	}
+
+	if (_table_packet_pos >= _table_packets.size())
+	{
+		_table_packets.clear();
+		_table_packet_pos = 0;
+
+		if (_next_version_bump_packet_index > 0 && _packet_index >= _next_version_bump_packet_index)
+		{
+			BumpVersion();
+			_next_version_bump_packet_index += MillisecondToPacketCount(_version_bump_interval_in_milliseconds);
+
+			// 版本变化后立刻发送新的表格。
+			_next_pat_pmt_packet_index = _packet_index;
+			_next_sdt_packet_index = _packet_index;
+		}
+
+		if (_packet_index >= _next_pat_pmt_packet_index)
+		{
+			LoadTables(*_pat_packetizer);
+			for (auto &pmt_packetizer : _pmt_packetizers)
+			{
+				LoadTables(*pmt_packetizer);
+			}
+
+			_next_pat_pmt_packet_index = _packet_index + MillisecondToPacketCount(_pat_pmt_interval_in_milliseconds);
+		}
+
+		if (_packet_index >= _next_sdt_packet_index)
+		{
+			LoadTables(*_sdt_packetizer);
+			_next_sdt_packet_index = _packet_index + MillisecondToPacketCount(_sdt_interval_in_milliseconds);
+		}
+	}
+
+	if (_table_packet_pos < _table_packets.size())
+	{
+		packet = _table_packets[_table_packet_pos++];
+	}
+	else
+	{
+		// 到期的节目插入只有自适应字段的 PCR 包。
+		bool pcr_inserted = false;
+		for (uint16_t i = 0; i < _service_count; i++)
+		{
+			if (_packet_index < _next_pcr_packet_indexes[i])
+			{
+				continue;
+			}
+
+			ElementaryStream &pcr_stream = _streams[i * _es_count_per_service];
+			packet.b[0] = ts::SYNC_BYTE;
+			packet.b[1] = uint8_t(pcr_stream._pid >> 8);
+			packet.b[2] = uint8_t(pcr_stream._pid);
+
+			// 不带负载的包不递增连续性计数。
+			packet.b[3] = 0x20 | ((pcr_stream._cc - 1) & ts::CC_MASK);
+			packet.b[4] = 183;
+			packet.b[5] = 0x10;
+			std::memset(packet.b + 6, 0xFF, ts::PKT_SIZE - 6);
+			packet.setPCR(PacketIndexToPcr(_packet_index));
+
+			_next_pcr_packet_indexes[i] = _packet_index + std::max<uint64_t>(MillisecondToPacketCount(_pcr_interval_in_milliseconds), 1);
+			pcr_inserted = true;
+			break;
+		}
+
+		if (!pcr_inserted)
+		{
+			ElementaryStream &stream = _streams[_stream_index];
+			_stream_index = (_stream_index + 1) % _streams.size();
+
+			packet = stream._template_packets[stream._template_pos];
+			stream._template_pos = (stream._template_pos + 1) % stream._template_packets.size();
+			packet.setCC(stream._cc);
+			stream._cc = (stream._cc + 1) & ts::CC_MASK;
+			if (packet.getPUSI())
+			{
+				uint64_t pts = PacketIndexToPcr(_packet_index) / ts::SYSTEM_CLOCK_SUBFACTOR;
+				pts += uint64_t(_pts_delay_in_milliseconds) * ts::SYSTEM_CLOCK_SUBFREQ / 1000;
+				packet.setPTS(pts & ts::PTS_DTS_MASK);
+			}
+		}
+	}
+
+	InjectFault(packet);
+	_packet_index++;
+	return ITSPacketSource::ReadPacketResult::Success;
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <tsCyclingPacketizer.h>
+#include <tsduck/interface/ITSPacketSource.h>
+#include <tsDuckContext.h>
+#include <tsPAT.h>
+#include <tsPMT.h>
+#include <tsSDT.h>
+#include <vector>
+
+namespace video
+{
+	/// <summary>
+	///		合成的 ts 流。用来做负载测试和基准测试，不需要输入文件。
+	///
+	///		* 有 service_count 个节目，每个节目有 es_count_per_service 路基本流。每个节目的第一路基本流携带 PCR。
+	///		* PAT、PMT、SDT 按设置的间隔重复发送。
+	///		* 按目标码率换算包的时间，以此插入 PCR 和设置 PTS。PCR 放在只有自适应字段的包里。
+	///		* 基本流是 PES 封装的填充数据。
+	///		* 可以注入错误：连续性计数错误、表格版本号变化、同步字节丢失。
+	///
+	///		为了不成为基准测试的瓶颈，基本流的包在构造时就用 ts::PESStreamPacketizer 打包成模板，读取时只复制模板，
+	///		然后修改连续性计数和 PTS。表格只在到期时才用 ts::CyclingPacketizer 打包。
+	/// </summary>
+	class SyntheticTsStream : public ITSPacketSource
+	{
+	public:
+		/// <summary>
+		///
+		/// </summary>
+		/// <param name="service_count">节目数。</param>
+		/// <param name="es_count_per_service">每个节目的基本流数。</param>
+		/// <param name="bitrate">目标码率。单位：bps。用来把包的序号换算成时间。</param>
+		SyntheticTsStream(uint16_t service_count, uint16_t es_count_per_service, uint64_t bitrate);
+
+	private:
+		ts::DuckContext _duck;
+		uint16_t _service_count = 0;
+		uint16_t _es_count_per_service = 0;
+		uint64_t _bitrate = 0;
+		bool _initialized = false;
+
+		ts::PAT _pat;
+		ts::SDT _sdt;
+		std::vector<ts::PMT> _pmts;
+
+		shared_ptr<ts::CyclingPacketizer> _pat_packetizer;
+		shared_ptr<ts::CyclingPacketizer> _sdt_packetizer;
+		std::vector<shared_ptr<ts::CyclingPacketizer>> _pmt_packetizers;
+
+		/// <summary>
+		///		到期的表格打包出来的包，优先于基本流输出。
+		/// </summary>
+		std::vector<ts::TSPacket> _table_packets;
+		size_t _table_packet_pos = 0;
+
+		/// <summary>
+		///		一路基本流。
+		/// </summary>
+		class ElementaryStream
+		{
+		public:
+			uint16_t _pid = 0;
+			uint8_t _cc = 0;
+
+			/// <summary>
+			///		一个 PES 包打包成的 ts 包。循环输出。
+			/// </summary>
+			std::vector<ts::TSPacket> _template_packets;
+			size_t _template_pos = 0;
+		};
+
+		std::vector<ElementaryStream> _streams;
+		size_t _stream_index = 0;
+
+		/// <summary>
+		///		每个节目下一次插入 PCR 的包序号。
+		/// </summary>
+		std::vector<uint64_t> _next_pcr_packet_indexes;
+
+		uint64_t _packet_index = 0;
+		uint64_t _next_pat_pmt_packet_index = 0;
+		uint64_t _next_sdt_packet_index = 0;
+		uint64_t _next_version_bump_packet_index = 0;
+		double _pcr_per_packet = 0;
+
+		void Initialize();
+		void BuildTables();
+		void BuildTemplatePackets(ElementaryStream &stream, bool is_video);
+		void LoadTables(ts::CyclingPacketizer &packetizer);
+		void BumpVersion();
+
+		uint64_t MillisecondToPacketCount(int64_t millisecond);
+		uint64_t PacketIndexToPcr(uint64_t packet_index);
+
+		void InjectFault(ts::TSPacket &packet);
+
+	public:
+		/// <summary>
+		///		PAT 和 PMT 的重复间隔。单位：毫秒。
+		/// </summary>
+		int64_t _pat_pmt_interval_in_milliseconds = 100;
+
+		/// <summary>
+		///		SDT 的重复间隔。单位：毫秒。
+		/// </summary>
+		int64_t _sdt_interval_in_milliseconds = 1000;
+
+		/// <summary>
+		///		每个节目插入 PCR 的间隔。单位：毫秒。
+		/// </summary>
+		int64_t _pcr_interval_in_milliseconds = 30;
+
+		/// <summary>
+		///		每个 PES 包的负载大小。单位：字节。
+		/// </summary>
+		size_t _pes_payload_size = 4096;
+
+		/// <summary>
+		///		PTS 比 PCR 超前的时间。单位：毫秒。
+		/// </summary>
+		int64_t _pts_delay_in_milliseconds = 500;
+
+		/// <summary>
+		///		总共输出多少个包后结束。为 0 表示无限输出。
+		/// </summary>
+		uint64_t _max_packet_count = 0;
+
+		/// <summary>
+		///		每隔多少个包注入一次连续性计数错误。为 0 表示不注入。
+		/// </summary>
+		uint64_t _cc_error_interval_in_packets = 0;
+
+		/// <summary>
+		///		每隔多少个包注入一次同步字节丢失。为 0 表示不注入。
+		/// </summary>
+		uint64_t _sync_loss_interval_in_packets = 0;
+
+		/// <summary>
+		///		每隔多少毫秒让 PAT、PMT、SDT 的版本号递增一次。为 0 表示版本号不变。
+		/// </summary>
+		int64_t _version_bump_interval_in_milliseconds = 0;
+
+		/// <summary>
+		///		读取包。上面的设置在第一次读取时生效。
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <returns>
+		///		输出的包数达到 _max_packet_count 后返回 ITSPacketSource::ReadPacketResult::NoMorePacket。
+		/// </returns>
+		ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet) override;
+		using ITSPacketSource::PumpTo;
+
+		/// <summary>
+		///		节目 service_index 的 PMT 的 PID。
+		/// </summary>
+		/// <param name="service_index"></param>
+		/// <returns></returns>
+		static uint16_t PmtPid(uint16_t service_index)
+		{
+			return 0x100 + service_index * 0x10;
+		}
+	};
+} // namespace video
@@ -1,4 +1,11 @@
 #include "tsduck/handler/TableVersionChangeHandler.h"
+#include <base/string/define.h>
+#include <tsduck/SectionPatcher.h>
+
+video::TableVersionChangeHandler::TableVersionChangeHandler()
+{
+	_demux->setSectionDeduplication(true);
+}
 
 void video::TableVersionChangeHandler::HandlePAT(ts::BinaryTable const &table)
 {
@@ -19,13 +26,20 @@ void video::TableVersionChangeHandler::HandlePAT(ts::BinaryTable const &table)
 	ResetListenedPids();
 	ListenOnPmtPids(pat);
 
+	ts::BinaryTable serialized_table;
+	SetCurrentTable(&table);
 	if (_on_before_handling_new_version_pat)
 	{
 		_on_before_handling_new_version_pat(_current_pat, pat);
+
+		// 回调可能修改了 PAT，原始数据不再可靠。
+		pat.serialize(*_duck, serialized_table);
+		_current_table = &serialized_table;
 	}
 
 	_current_pat = pat;
 	HandlePatVersionChange(pat);
+	SetCurrentTable(nullptr);
 	_demux->reset();
 }
 
@@ -41,7 +55,9 @@ void video::TableVersionChangeHandler::HandlePMT(ts::BinaryTable const &table)
 		ts::PMT pmt;
 		pmt.deserialize(*_duck, table);
 		_streams_pid_set << pmt;
+		SetCurrentTable(&table);
 		HandlePmtVersionChange(pmt, source_pid);
+		SetCurrentTable(nullptr);
 	}
 
 	_demux->resetPID(source_pid);
@@ -58,6 +74,90 @@ void video::TableVersionChangeHandler::HandleSDT(ts::BinaryTable const &table)
 
 	// SDT 版本发生变化
 	_sdt_version = table.version();
+	SetCurrentTable(&table);
 	HandleSdtVersionChange(table);
+	SetCurrentTable(nullptr);
 	_demux->resetPID(table.sourcePID());
 }
+
+ts::BinaryTable const &video::TableVersionChangeHandler::CurrentTable() const
+{
+	if (_current_table == nullptr)
+	{
+		throw std::runtime_error{CODE_POS_STR + std::string{"只能在表格版本变化的回调中调用。"}};
+	}
+
+	return *_current_table;
+}
+
+void video::TableVersionChangeHandler::SetCurrentTable(ts::BinaryTable const *table)
+{
+	_current_table = table;
+	_current_table_packets = nullptr;
+	if (table != nullptr)
+	{
+		auto it = _table_packets.find(table->sourcePID());
+		if (it != _table_packets.end())
+		{
+			_current_table_packets = &it->second;
+		}
+	}
+}
+
+void video::TableVersionChangeHandler::FeedAndRecordPacket(ts::TSPacket const &packet)
+{
+	uint16_t pid = packet.getPID();
+	if (_demux->hasPID(pid) && packet.hasPayload())
+	{
+		std::vector<ts::TSPacket> &packets = _table_packets[pid];
+		if (packet.getPUSI())
+		{
+			// 指针域指向的段是第 0 段时重新开始记录。段头不完整时也重新开始，
+			// 布局对不上的话 ToTsPacketLikeCurrentTable 会改用重新打包。
+			uint8_t const *payload = packet.getPayload();
+			size_t size = packet.getPayloadSize();
+			size_t offset = size > 0 ? 1 + payload[0] : size;
+			bool first_section = offset + 8 > size ||
+								 (payload[offset + 1] & 0x80) == 0 ||
+								 payload[offset + 6] == 0;
+			if (first_section)
+			{
+				packets.clear();
+			}
+		}
+
+		// 一个表格最多 256 个段，每段最多 4096 字节，超过这么多包说明不是表格。
+		if (packets.size() >= 256 * 4096 / ts::PKT_SIZE + 256)
+		{
+			packets.clear();
+		}
+
+		if (!packets.empty() || packet.getPUSI())
+		{
+			packets.push_back(packet);
+		}
+	}
+
+	_demux->feedPacket(packet);
+}
+
+std::vector<ts::TSPacket> video::TableVersionChangeHandler::ToTsPacketLikeCurrentTable(
+	ts::BinaryTable const &table,
+	uint16_t pid) const
+{
+	if (_current_table_packets != nullptr)
+	{
+		std::vector<ts::TSPacket> packets = *_current_table_packets;
+		if (SectionPatcher::WriteToPackets(table, packets))
+		{
+			for (ts::TSPacket &packet : packets)
+			{
+				packet.setPID(pid);
+			}
+
+			return packets;
+		}
+	}
+
+	return TableOperator::ToTsPacket(*_duck, table, pid);
+}
@@ -1,7 +1,10 @@
 #pragma once
 #include <functional>
+#include <map>
 #include <tsduck/handler/TableHandler.h>
 #include <tsduck/TableOperator.h>
+#include <tsTSPacket.h>
+#include <vector>
 
 namespace video
 {
@@ -12,6 +15,13 @@ namespace video
 	class TableVersionChangeHandler :
 		public TableHandler
 	{
+	public:
+		/// <summary>
+		///		本类只关心版本变化，所以会开启 _demux 的段去重。内容没有变化的重复段会直接在 _demux
+		///		中被丢弃，不会构造 Section，也不会触发回调。
+		/// </summary>
+		TableVersionChangeHandler();
+
 	private:
 		int _pat_version = -1;
 		int _sdt_version = -1;
@@ -22,6 +32,23 @@ namespace video
 		std::map<uint16_t, uint8_t> _pmt_versions;
 		ts::PAT _current_pat;
 
+		/// <summary>
+		///		正在回调的表格的原始二进制数据。只在回调期间有效。
+		/// </summary>
+		ts::BinaryTable const *_current_table = nullptr;
+
+		/// <summary>
+		///		FeedAndRecordPacket 记录的承载表格的原始包。key=PID, value=从最近一次第 0 段开始的包。
+		/// </summary>
+		std::map<uint16_t, std::vector<ts::TSPacket>> _table_packets;
+
+		/// <summary>
+		///		承载正在回调的表格的原始包。只在回调期间有效，没有记录时为空指针。
+		/// </summary>
+		std::vector<ts::TSPacket> const *_current_table_packets = nullptr;
+
+		void SetCurrentTable(ts::BinaryTable const *table);
+
 	private:
 		void HandlePAT(ts::BinaryTable const &table) final override;
 		void HandlePMT(ts::BinaryTable const &table) final override;
@@ -33,6 +60,37 @@ namespace video
 		/// </summary>
 		ts::PIDSet _streams_pid_set;
 
+		/// <summary>
+		///		获取正在回调的表格的原始二进制数据，只能在 Handle*VersionChange 回调中调用。
+		///		派生类可以用 SectionPatcher 在原始数据上修改，这样不认识的描述符等内容会原样保留，
+		///		也不用再序列化一次。
+		///
+		///		* 如果设置了 _on_before_handling_new_version_pat，PAT 可能在回调中被修改，
+		///		  此时返回的是修改后的 PAT 重新序列化得到的表格。
+		/// </summary>
+		/// <returns></returns>
+		ts::BinaryTable const &CurrentTable() const;
+
+		/// <summary>
+		///		把包送给 _demux，同时记录 _demux 监听的 PID 上承载表格的原始包。
+		///		派生类用它代替 _demux->feedPacket，回调中就可以用 ToTsPacketLikeCurrentTable
+		///		按原来的布局重新打包。
+		/// </summary>
+		/// <param name="packet"></param>
+		void FeedAndRecordPacket(ts::TSPacket const &packet);
+
+		/// <summary>
+		///		把 table 打包成 PID 为 pid 的包。只能在 Handle*VersionChange 回调中调用。
+		///
+		///		* 如果包是用 FeedAndRecordPacket 送入的，并且 table 的各个段与正在回调的表格长度相同，
+		///		  例如用 SectionPatcher 修改过的 CurrentTable()，则沿用原始包的布局，只改写段的字节。
+		///		* 否则用 TableOperator::ToTsPacket 重新打包。
+		/// </summary>
+		/// <param name="table"></param>
+		/// <param name="pid"></param>
+		/// <returns></returns>
+		std::vector<ts::TSPacket> ToTsPacketLikeCurrentTable(ts::BinaryTable const &table, uint16_t pid) const;
+
 		virtual void HandlePatVersionChange(ts::PAT &pat)
 		{
 		}
@@ -9,3 +9,21 @@ void ITSPacketConsumer::SendPacket(std::vector<ts::TSPacket> packets)
 		SendPacket(&packet);
 	}
 }
+
+void ITSPacketConsumer::SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata)
+{
+	SendPacket(packet);
+}
+
+void ITSPacketConsumer::SendPacketWindow(ts::TSPacketWindow &window)
+{
+	ts::TSPacket *packet = nullptr;
+	ts::TSPacketMetadata *metadata = nullptr;
+	for (size_t i = 0; i < window.size(); i++)
+	{
+		if (window.get(i, packet, metadata))
+		{
+			SendPacket(packet, metadata);
+		}
+	}
+}
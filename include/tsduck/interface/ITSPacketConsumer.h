@@ -1,6 +1,8 @@
 #pragma once
 #include<memory>
 #include<tsTSPacket.h>
+#include<tsTSPacketMetadata.h>
+#include<tsTSPacketWindow.h>
 #include<vector>
 
 namespace video
@@ -15,5 +17,26 @@ namespace video
 	public:
 		virtual void SendPacket(ts::TSPacket *packet) = 0;
 		virtual void SendPacket(std::vector<ts::TSPacket> packets);
+
+		/// <summary>
+		///		送入带元数据的包。元数据包括输入时间戳、标签等。
+		///		处理链中的各级应该把元数据原样随包传给下游，元数据也可以就地修改。
+		///
+		///		默认实现丢弃元数据，调用 SendPacket(ts::TSPacket *)。
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <param name="metadata"></param>
+		virtual void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata);
+
+		/// <summary>
+		///		以窗口的方式送入一批包，包不会被复制。
+		///
+		///		实现者可以就地修改窗口中的包，或者用 nullify、drop 置空或丢弃包，也可以把新的包
+		///		作为额外的范围拼接进窗口，然后把同一个窗口送给下游。窗口和它引用的包只在本次调用期间有效。
+		///
+		///		默认实现把窗口中没有被丢弃的包和它们的元数据逐个送给 SendPacket(ts::TSPacket *, ts::TSPacketMetadata *)。
+		/// </summary>
+		/// <param name="window"></param>
+		virtual void SendPacketWindow(ts::TSPacketWindow &window);
 	};
-}
\ No newline at end of file
+}
@@ -1,8 +1,15 @@
 #include "ITSPacketSource.h"
+#include "base/string/define.h"
 #include "base/task/CancellationToken.h"
 
 using namespace video;
 
+ITSPacketSource::ReadPacketResult ITSPacketSource::ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata)
+{
+	metadata.reset();
+	return ReadPacket(packet);
+}
+
 ITSPacketSource::ReadPacketResult ITSPacketSource::PumpTo(
 	shared_ptr<ITSPacketConsumer> consumer,
 	shared_ptr<base::CancellationToken> cancel_pump)
@@ -16,10 +23,11 @@ ITSPacketSource::ReadPacketResult ITSPacketSource::PumpTo(std::vector<shared_ptr
 														  shared_ptr<base::CancellationToken> cancel_pump)
 {
 	ts::TSPacket packet;
+	ts::TSPacketMetadata metadata;
 
 	while (!base::is_cancellation_requested(cancel_pump))
 	{
-		ITSPacketSource::ReadPacketResult read_packet_result = ReadPacket(packet);
+		ITSPacketSource::ReadPacketResult read_packet_result = ReadPacket(packet, metadata);
 
 		switch (read_packet_result)
 		{
@@ -32,7 +40,7 @@ ITSPacketSource::ReadPacketResult ITSPacketSource::PumpTo(std::vector<shared_ptr
 						return ITSPacketSource::ReadPacketResult::Success;
 					}
 
-					consumer->SendPacket(&packet);
+					consumer->SendPacket(&packet, &metadata);
 				}
 
 				break;
@@ -46,3 +54,47 @@ ITSPacketSource::ReadPacketResult ITSPacketSource::PumpTo(std::vector<shared_ptr
 
 	return ITSPacketSource::ReadPacketResult::Success;
 }
+
+ITSPacketSource::ReadPacketResult ITSPacketSource::PumpWindowTo(shared_ptr<ITSPacketConsumer> consumer,
+																shared_ptr<base::CancellationToken> cancel_pump,
+																size_t window_size)
+{
+	if (window_size == 0)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"window_size 不能为 0。"}};
+	}
+
+	std::vector<ts::TSPacket> packets(window_size);
+	std::vector<ts::TSPacketMetadata> metadata(window_size);
+	ts::TSPacketWindow window;
+
+	while (!base::is_cancellation_requested(cancel_pump))
+	{
+		ITSPacketSource::ReadPacketResult read_packet_result = ITSPacketSource::ReadPacketResult::Success;
+		size_t count = 0;
+		while (count < window_size)
+		{
+			read_packet_result = ReadPacket(packets[count], metadata[count]);
+			if (read_packet_result != ITSPacketSource::ReadPacketResult::Success)
+			{
+				break;
+			}
+
+			count++;
+		}
+
+		if (count > 0)
+		{
+			window.clear();
+			window.addPacketsReference(packets.data(), metadata.data(), count);
+			consumer->SendPacketWindow(window);
+		}
+
+		if (read_packet_result != ITSPacketSource::ReadPacketResult::Success)
+		{
+			return read_packet_result;
+		}
+	}
+
+	return ITSPacketSource::ReadPacketResult::Success;
+}
@@ -30,7 +30,17 @@ namespace video
 		virtual ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet) = 0;
 
 		/// <summary>
-		///		在循环中从本对象的 ReadPacket 方法读出包送给 consumer。
+		///		读取包和它的元数据。元数据包括输入时间戳（例如 M2TS 包头中的时间戳）、标签等。
+		///
+		///		默认实现调用 ReadPacket(ts::TSPacket &)，元数据被重置为默认值。
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <param name="metadata"></param>
+		/// <returns></returns>
+		virtual ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata);
+
+		/// <summary>
+		///		在循环中从本对象的 ReadPacket 方法读出包和元数据送给 consumer。
 		///		遇到非 ReadPacketResult::Success 的情况会返回该 ReadPacketResult 类型的值。
 		/// 
 		///		取消后会返回 ITSPacketSource::ReadPacketResult::Success
@@ -46,5 +56,21 @@ namespace video
 			std::vector<shared_ptr<ITSPacketConsumer>> const consumers,
 			shared_ptr<base::CancellationToken> cancel_pump
 		);
+
+		/// <summary>
+		///		与 PumpTo 相同，但是每次把最多 window_size 个包读进缓冲区，以窗口的方式送给 consumer。
+		///		包只在从 ReadPacket 读进缓冲区时复制一次，之后在整个处理链中就地处理。
+		///
+		///		读到的包不足 window_size 个时，会先把已经读到的包送出去，再返回非 ReadPacketResult::Success 的值。
+		/// </summary>
+		/// <param name="consumer"></param>
+		/// <param name="cancel_pump"></param>
+		/// <param name="window_size">每个窗口最多包含的包数。</param>
+		/// <returns></returns>
+		virtual ITSPacketSource::ReadPacketResult PumpWindowTo(
+			shared_ptr<ITSPacketConsumer> consumer,
+			shared_ptr<base::CancellationToken> cancel_pump,
+			size_t window_size = 512
+		);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "tsduck/io/SegmentingWriter.h"
+#include <base/filesystem/file.h>
+#include <base/string/define.h>
+#include <tsduck/RandomAccessPoint.h>
+
+using namespace video;
+using namespace std;
+
+video::SegmentingWriter::SegmentingWriter(std::string const &name_template)
+{
+	if (name_template.empty())
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"文件名模板不能为空。"}};
+	}
+
+	_file_name_generator.initCounter(name_template);
+}
+
+video::SegmentingWriter::~SegmentingWriter()
+{
+	try
+	{
+		Close();
+	}
+	catch (std::exception &e)
+	{
+		cerr << CODE_POS_STR << e.what() << endl;
+	}
+}
+
+void video::SegmentingWriter::HandlePatVersionChange(ts::PAT &pat)
+{
+	_pat_packets = TableOperator::ToTsPacket(*_duck, CurrentTable(), ts::PID_PAT);
+
+	// PMT 要重新解析
+	_pmt_packets.clear();
+	_cut_pid = ts::PID_NULL;
+	_cut_pid_stream_type = ts::ST_NULL;
+	_cut_pid_pmt_pid = ts::PID_NULL;
+}
+
+void video::SegmentingWriter::HandlePmtVersionChange(ts::PMT &pmt, uint16_t source_pid)
+{
+	_pmt_packets[source_pid] = TableOperator::ToTsPacket(*_duck, CurrentTable(), source_pid);
+
+	// 切分点只从一个 PMT 中选取，优先视频流。
+	if (_cut_pid_pmt_pid != ts::PID_NULL && _cut_pid_pmt_pid != source_pid)
+	{
+		return;
+	}
+
+	_cut_pid = ts::PID_NULL;
+	_cut_pid_stream_type = ts::ST_NULL;
+	for (auto const &it : pmt.streams)
+	{
+		if (it.second.isVideo(*_duck))
+		{
+			_cut_pid = it.first;
+			_cut_pid_stream_type = it.second.stream_type;
+			break;
+		}
+	}
+
+	if (_cut_pid == ts::PID_NULL && !pmt.streams.empty())
+	{
+		_cut_pid = pmt.streams.begin()->first;
+		_cut_pid_stream_type = pmt.streams.begin()->second.stream_type;
+	}
+
+	_cut_pid_pmt_pid = _cut_pid == ts::PID_NULL ? ts::PID_NULL : source_pid;
+}
+
+bool video::SegmentingWriter::IsRandomAccessPoint(ts::TSPacket const &packet) const
+{
+	return packet.getPID() == _cut_pid && RandomAccessPoint::Check(packet, _cut_pid_stream_type);
+}
+
+bool video::SegmentingWriter::SegmentIsFull() const
+{
+	if (_target_size_in_bytes > 0 && _current_size >= _target_size_in_bytes)
+	{
+		return true;
+	}
+
+	if (_target_duration_in_milliseconds > 0 && _segment_pcr_pid != ts::PID_NULL)
+	{
+		if (SegmentDurationInMilliseconds() >= _target_duration_in_milliseconds)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int64_t video::SegmentingWriter::SegmentDurationInMilliseconds() const
+{
+	return _segment_elapsed_in_milliseconds + ts::TimelineDemux::PCRToMilliSecond(_segment_start_pcr, _segment_last_pcr);
+}
+
+void video::SegmentingWriter::UpdateSegmentClock()
+{
+	uint16_t pid = _timeline.referencePCRPID();
+	if (pid == ts::PID_NULL)
+	{
+		return;
+	}
+
+	if (pid != _segment_pcr_pid)
+	{
+		if (_segment_pcr_pid != ts::PID_NULL)
+		{
+			// 参考 PID 变了。旧时钟上经过的时长保存下来，之后在新时钟上重新计时。
+			_segment_elapsed_in_milliseconds += ts::TimelineDemux::PCRToMilliSecond(_segment_start_pcr, _segment_last_pcr);
+		}
+
+		// 段开始时还没有 PCR 的话，从第一个 PCR 开始计时。
+		_segment_pcr_pid = pid;
+		_segment_start_pcr = _timeline.referencePCR();
+	}
+
+	_segment_last_pcr = _timeline.referencePCR();
+}
+
+void video::SegmentingWriter::StartSegment()
+{
+	Close();
+
+	_current_path = _file_name_generator.newFileName().string();
+	_current_stream = base::file::CreateNewAnyway(_current_path);
+	_current_writer = shared_ptr<TSPacketStreamWriter>{new TSPacketStreamWriter{_current_stream}};
+	_current_size = 0;
+	_segment_pcr_pid = _timeline.referencePCRPID();
+	_segment_start_pcr = _timeline.referencePCR();
+	_segment_last_pcr = _segment_start_pcr;
+	_segment_elapsed_in_milliseconds = 0;
+
+	// 每一段都以 PAT 和 PMT 开头。
+	WriteTablePackets(_pat_packets);
+	for (auto const &it : _pmt_packets)
+	{
+		WriteTablePackets(it.second);
+	}
+}
+
+void video::SegmentingWriter::WritePacket(ts::TSPacket &packet)
+{
+	uint16_t pid = packet.getPID();
+	if ((pid == ts::PID_PAT || _pmt_packets.count(pid)) && packet.hasPayload())
+	{
+		_table_cc[pid] = packet.getCC();
+	}
+
+	_current_writer->SendPacket(&packet);
+	_current_size += ts::PKT_SIZE;
+}
+
+void video::SegmentingWriter::WriteTablePackets(std::vector<ts::TSPacket> packets)
+{
+	if (packets.empty())
+	{
+		return;
+	}
+
+	// 让插入的最后一个包的连续性计数等于此 PID 上已经写出的最后一个包，
+	// 这样之后原样写出的表格包在新文件中是连续的。
+	uint16_t pid = packets[0].getPID();
+	auto it = _table_cc.find(pid);
+	if (it == _table_cc.end())
+	{
+		// 这个 PID 还没写出过包，只会发生在第一段，流中的表格包随后就会写出。
+		return;
+	}
+
+	uint8_t cc = uint8_t(it->second + 1 - packets.size());
+	for (ts::TSPacket &packet : packets)
+	{
+		packet.setCC(cc & ts::CC_MASK);
+		cc++;
+	}
+
+	for (ts::TSPacket &packet : packets)
+	{
+		_current_writer->SendPacket(&packet);
+		_current_size += ts::PKT_SIZE;
+	}
+}
+
+void video::SegmentingWriter::SendPacket(ts::TSPacket *packet)
+{
+	_demux->feedPacket(*packet);
+	_timeline.feedPacket(*packet);
+	UpdateSegmentClock();
+
+	if (_current_writer == nullptr)
+	{
+		StartSegment();
+	}
+	else if (SegmentIsFull() && IsRandomAccessPoint(*packet))
+	{
+		StartSegment();
+	}
+
+	WritePacket(*packet);
+}
+
+void video::SegmentingWriter::Close()
+{
+	if (_current_writer == nullptr)
+	{
+		return;
+	}
+
+	_current_stream->Flush();
+	_current_writer = nullptr;
+	_current_stream = nullptr;
+	std::string path = _current_path;
+	if (_on_segment_completed)
+	{
+		_on_segment_completed(path);
+	}
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include <base/stream/Stream.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <tsduck/handler/TableVersionChangeHandler.h>
+#include <tsduck/interface/ITSPacketConsumer.h>
+#include <tsduck/io/TSPacketStreamWriter.h>
+#include <tsFileNameGenerator.h>
+#include <tsTimelineDemux.h>
+
+namespace video
+{
+	/// <summary>
+	///		送入 ts 包，按目标时长或大小分段写入多个文件，文件名由 ts::FileNameGenerator 生成。
+	///
+	///		* 只在视频的随机访问点切分：PES 包的第一个 ts 包设置了自适应字段的 random_access_indicator，
+	///		  或者这个包中能找到 AVC/HEVC/VVC 的 IDR, CRA 等随机访问单元。这样每一段都能单独解码。
+	///		* 节目没有视频流时在 PMT 中第一路流的 PES 包开头切分。
+	///		* 时长用参考 PCR 计算，流中没有 PCR 时只能按大小切分。
+	///		* 每一段开头会先写入当前的 PAT 和 PMT, 连续性计数接续后面原有的表格包。
+	///		* 到达目标时长或大小后，要等到下一个随机访问点才切分，所以每一段都会略长于目标。
+	/// </summary>
+	class SegmentingWriter :
+		public ITSPacketConsumer,
+		public TableVersionChangeHandler
+	{
+	public:
+		/// <summary>
+		///
+		/// </summary>
+		/// <param name="name_template">
+		///		输出文件名模板，格式见 ts::FileNameGenerator::initCounter.
+		///		例如 "seg.ts" 会生成 seg-000000.ts, seg-000001.ts ...
+		/// </param>
+		SegmentingWriter(std::string const &name_template);
+
+		~SegmentingWriter();
+
+	private:
+		ts::FileNameGenerator _file_name_generator;
+		ts::TimelineDemux _timeline{*_duck};
+
+		std::vector<ts::TSPacket> _pat_packets;
+
+		/// <summary>
+		///		key=pmt_pid, value=PMT 的包。
+		/// </summary>
+		std::map<uint16_t, std::vector<ts::TSPacket>> _pmt_packets;
+
+		/// <summary>
+		///		已写出的表格包的连续性计数。key=PID.
+		/// </summary>
+		std::map<uint16_t, uint8_t> _table_cc;
+
+		/// <summary>
+		///		在这个 PID 的随机访问点切分。
+		/// </summary>
+		uint16_t _cut_pid = ts::PID_NULL;
+		uint8_t _cut_pid_stream_type = ts::ST_NULL;
+
+		/// <summary>
+		///		_cut_pid 所在的 PMT 的 PID.
+		/// </summary>
+		uint16_t _cut_pid_pmt_pid = ts::PID_NULL;
+
+		std::string _current_path;
+		shared_ptr<base::Stream> _current_stream;
+		shared_ptr<TSPacketStreamWriter> _current_writer;
+		int64_t _current_size = 0;
+
+		/// <summary>
+		///		当前段用来计时的参考 PCR 的 PID. 还没有 PCR 时为 ts::PID_NULL.
+		///		解析到 PMT 后参考 PCR 的 PID 可能会变，不同 PID 的 PCR 可能来自不同的时钟，不能相减。
+		/// </summary>
+		uint16_t _segment_pcr_pid = ts::PID_NULL;
+
+		/// <summary>
+		///		_segment_pcr_pid 上开始计时的 PCR 和最后一个 PCR. 是 _timeline 中展开回绕后的值。
+		/// </summary>
+		int64_t _segment_start_pcr = 0;
+		int64_t _segment_last_pcr = 0;
+
+		/// <summary>
+		///		参考 PID 变化之前，当前段已经经过的时长。单位：毫秒。
+		/// </summary>
+		int64_t _segment_elapsed_in_milliseconds = 0;
+
+		void HandlePatVersionChange(ts::PAT &pat) override;
+		void HandlePmtVersionChange(ts::PMT &pmt, uint16_t source_pid) override;
+
+		/// <summary>
+		///		packet 是否是 _cut_pid 上的随机访问点。见 RandomAccessPoint::Check.
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <returns></returns>
+		bool IsRandomAccessPoint(ts::TSPacket const &packet) const;
+
+		/// <summary>
+		///		送入包后更新当前段的计时。参考 PCR 的 PID 变了时，用旧 PID 的 PCR 算出已经经过的时长，
+		///		然后在新 PID 上重新计时。
+		/// </summary>
+		void UpdateSegmentClock();
+
+		/// <summary>
+		///		当前段已经经过的时长。单位：毫秒。
+		/// </summary>
+		/// <returns></returns>
+		int64_t SegmentDurationInMilliseconds() const;
+
+		/// <summary>
+		///		当前段是否已经达到目标时长或大小。
+		/// </summary>
+		/// <returns></returns>
+		bool SegmentIsFull() const;
+
+		/// <summary>
+		///		结束当前段，打开新的一段，写入 PAT 和 PMT.
+		/// </summary>
+		void StartSegment();
+
+		/// <summary>
+		///		写入包并记录表格包的连续性计数。
+		/// </summary>
+		/// <param name="packet"></param>
+		void WritePacket(ts::TSPacket &packet);
+
+		/// <summary>
+		///		写入表格包。连续性计数会被改写为接续此 PID 上已经写出的包。
+		/// </summary>
+		/// <param name="packets"></param>
+		void WriteTablePackets(std::vector<ts::TSPacket> packets);
+
+	public:
+		/// <summary>
+		///		每一段的目标时长。单位：毫秒。为 0 表示不按时长切分。
+		/// </summary>
+		int64_t _target_duration_in_milliseconds = 10000;
+
+		/// <summary>
+		///		每一段的目标大小。单位：字节。为 0 表示不按大小切分。
+		/// </summary>
+		int64_t _target_size_in_bytes = 0;
+
+		/// <summary>
+		///		一段写完并冲洗后触发。参数是这一段的文件路径。
+		/// </summary>
+		std::function<void(std::string const &path)> _on_segment_completed;
+
+		using ITSPacketConsumer::SendPacket;
+
+		/// <summary>
+		///		送入包。遇到随机访问点并且当前段已满时，会先切换到新的一段。
+		/// </summary>
+		/// <param name="packet"></param>
+		void SendPacket(ts::TSPacket *packet) override;
+
+		/// <summary>
+		///		结束当前段。之后再送入包会开始新的一段。
+		///		析构时会自动调用。
+		/// </summary>
+		void Close();
+
+		/// <summary>
+		///		当前正在写的文件的路径。还没开始写时为空。
+		/// </summary>
+		/// <returns></returns>
+		std::string CurrentPath() const
+		{
+			return _current_path;
+		}
+	};
+} // namespace video
@@ -71,3 +71,14 @@ ITSPacketSource::ReadPacketResult video::TSPacketStreamReader::ReadPacket(ts::TS
 
 	return ITSPacketSource::ReadPacketResult::Success;
 }
+
+ITSPacketSource::ReadPacketResult video::TSPacketStreamReader::ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata)
+{
+	int64_t have_read = _ts_packet_stream->readPackets(&packet, &metadata, 1, CerrReport::Instance());
+	if (have_read == 0)
+	{
+		return ITSPacketSource::ReadPacketResult::NoMorePacket;
+	}
+
+	return ITSPacketSource::ReadPacketResult::Success;
+}
@@ -25,6 +25,14 @@ namespace video
 
 	public:
 		ReadPacketResult ReadPacket(ts::TSPacket &packet) override;
+
+		/// <summary>
+		///		读取包和元数据。M2TS 等带包头的格式会把包头中的时间戳作为输入时间戳放进元数据。
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <param name="metadata"></param>
+		/// <returns></returns>
+		ReadPacketResult ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata) override;
 		using ITSPacketSource::PumpTo;
 	};
 }
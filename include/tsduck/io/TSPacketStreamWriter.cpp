@@ -18,3 +18,22 @@ void TSPacketStreamWriter::SendPacket(ts::TSPacket *packet)
 {
 	_out_stream->Write(packet->b, 0, 188);
 }
+
+void TSPacketStreamWriter::SendPacketWindow(ts::TSPacketWindow &window)
+{
+	for (size_t i = 0; i < window.size();)
+	{
+		ts::TSPacket *packets = nullptr;
+		ts::TSPacketMetadata *metadata = nullptr;
+		size_t count = window.getContiguous(i, packets, metadata);
+		if (count == 0)
+		{
+			// 被丢弃的包。
+			i++;
+			continue;
+		}
+
+		_out_stream->Write(packets->b, 0, static_cast<int32_t>(count * ts::PKT_SIZE));
+		i += count;
+	}
+}
@@ -22,5 +22,11 @@ namespace video
 		///		送入包，会被写入文件。
 		/// </summary>
 		void SendPacket(ts::TSPacket *packet) override;
+
+		/// <summary>
+		///		窗口中物理上连续的包一次写入。
+		/// </summary>
+		/// <param name="window"></param>
+		void SendPacketWindow(ts::TSPacketWindow &window) override;
 	};
 }
@@ -0,0 +1,127 @@
+#include "tsduck/io/TimestampCaptureWriter.h"
+#include <base/string/define.h>
+#include <tsAbstractWriteStreamInterface.h>
+#include <tsTSPacketWindow.h>
+
+using namespace video;
+using namespace ts;
+using namespace std;
+
+#pragma region 内部类型
+/// <summary>
+///		让 tsduck 写入字节流的接口
+/// </summary>
+class TimestampCaptureWriter::WriteStreamInterface : public ts::AbstractWriteStreamInterface
+{
+public:
+	WriteStreamInterface(shared_ptr<base::Stream> out_stream)
+	{
+		_out_stream = out_stream;
+	}
+
+private:
+	shared_ptr<base::Stream> _out_stream;
+
+public:
+	bool writeStream(void const *addr, size_t size, size_t &written_size, Report &report) override
+	{
+		try
+		{
+			_out_stream->Write((uint8_t const *)addr, 0, static_cast<int32_t>(size));
+			written_size = size;
+			return true;
+		}
+		catch (std::exception &e)
+		{
+			cerr << CODE_POS_STR << e.what() << endl;
+			written_size = 0;
+			return false;
+		}
+	}
+};
+#pragma endregion
+
+video::TimestampCaptureWriter::TimestampCaptureWriter(shared_ptr<base::Stream> out_stream,
+													  ts::TSPacketFormat format)
+{
+	if (out_stream == nullptr)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"out_stream 不能是空指针。"}};
+	}
+
+	if (format != ts::TSPacketFormat::M2TS && format != ts::TSPacketFormat::DUCK)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"只支持 M2TS 和 DUCK 格式，其他格式不能保存时间戳。"}};
+	}
+
+	_out_stream = out_stream;
+	_write_stream_interface = shared_ptr<WriteStreamInterface>{new WriteStreamInterface{_out_stream}};
+	_ts_packet_stream = shared_ptr<ts::TSPacketStream>{
+		new ts::TSPacketStream{
+			format,
+			nullptr,
+			_write_stream_interface.get()}};
+}
+
+void video::TimestampCaptureWriter::Stamp(ts::TSPacketMetadata &metadata, Clock::time_point now)
+{
+	if (_keep_input_timestamp && metadata.hasInputTimeStamp())
+	{
+		return;
+	}
+
+	if (!_clock_started)
+	{
+		_clock_started = true;
+		_start_time = now;
+	}
+
+	// 纳秒换算为 27MHz 时钟周期。
+	uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - _start_time).count();
+	metadata.setInputTimeStamp(ns * 27 / 1000, ts::SYSTEM_CLOCK_FREQ, ts::TimeSource::TSP);
+}
+
+void video::TimestampCaptureWriter::SendPacket(ts::TSPacket *packet)
+{
+	ts::TSPacketMetadata metadata;
+	SendPacket(packet, &metadata);
+}
+
+void video::TimestampCaptureWriter::SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata)
+{
+	ts::TSPacketMetadata stamped;
+	if (metadata != nullptr)
+	{
+		stamped = *metadata;
+	}
+
+	Stamp(stamped, Clock::now());
+	_ts_packet_stream->writePackets(packet, &stamped, 1, CerrReport::Instance());
+}
+
+void video::TimestampCaptureWriter::SendPacketWindow(ts::TSPacketWindow &window)
+{
+	Clock::time_point now = Clock::now();
+	for (size_t i = 0; i < window.size();)
+	{
+		ts::TSPacket *packets = nullptr;
+		ts::TSPacketMetadata *metadata = nullptr;
+		size_t count = window.getContiguous(i, packets, metadata);
+		if (count == 0)
+		{
+			// 被丢弃的包。
+			i++;
+			continue;
+		}
+
+		// 窗口中的元数据属于上游，打时间戳时不修改它们。
+		std::vector<ts::TSPacketMetadata> stamped{metadata, metadata + count};
+		for (ts::TSPacketMetadata &m : stamped)
+		{
+			Stamp(m, now);
+		}
+
+		_ts_packet_stream->writePackets(packets, stamped.data(), count, CerrReport::Instance());
+		i += count;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <base/stream/Stream.h>
+#include <chrono>
+#include <tsTSPacketStream.h>
+#include <tsduck/interface/ITSPacketConsumer.h>
+
+namespace video
+{
+	/// <summary>
+	///		送入 ts 包，以 M2TS 或 DUCK 格式写入文件，每个包都带有到达时刻的时间戳。
+	///		写出的文件可以用 TSPacketStreamReader 加 TimestampReplaySource 按原来的节奏回放。
+	///
+	///		时间戳取自单调时钟 std::chrono::steady_clock，以第一个包为 0，单位是 27MHz 时钟周期。
+	/// </summary>
+	class TimestampCaptureWriter :
+		public ITSPacketConsumer
+	{
+	public:
+		/// <summary>
+		///
+		/// </summary>
+		/// <param name="out_stream">输出流。</param>
+		/// <param name="format">只能是 ts::TSPacketFormat::M2TS 或 ts::TSPacketFormat::DUCK.</param>
+		TimestampCaptureWriter(shared_ptr<base::Stream> out_stream,
+							   ts::TSPacketFormat format = ts::TSPacketFormat::M2TS);
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		shared_ptr<base::Stream> _out_stream;
+		class WriteStreamInterface;
+		shared_ptr<WriteStreamInterface> _write_stream_interface;
+		shared_ptr<ts::TSPacketStream> _ts_packet_stream;
+
+		bool _clock_started = false;
+		Clock::time_point _start_time;
+
+		/// <summary>
+		///		给 metadata 打上当前时刻的时间戳。
+		/// </summary>
+		/// <param name="metadata"></param>
+		/// <param name="now"></param>
+		void Stamp(ts::TSPacketMetadata &metadata, Clock::time_point now);
+
+	public:
+		/// <summary>
+		///		为 true 时，已经带有输入时间戳的包保留原来的时间戳，例如转存从 M2TS 文件读出的包。
+		///		为 false 时总是用到达时刻覆盖。
+		/// </summary>
+		bool _keep_input_timestamp = false;
+
+		using ITSPacketConsumer::SendPacket;
+
+		/// <summary>
+		///		送入包，以当前时刻为时间戳写入文件。
+		/// </summary>
+		/// <param name="packet"></param>
+		void SendPacket(ts::TSPacket *packet) override;
+
+		/// <summary>
+		///		送入包和元数据。DUCK 格式会把标签等元数据一并写入。
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <param name="metadata"></param>
+		void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override;
+
+		/// <summary>
+		///		窗口中的包同时到达，使用同一个时间戳，物理上连续的包一次写入。
+		/// </summary>
+		/// <param name="window"></param>
+		void SendPacketWindow(ts::TSPacketWindow &window) override;
+	};
+} // namespace video
@@ -0,0 +1,107 @@
+#include "tsduck/io/TimestampReplaySource.h"
+#include <base/string/define.h>
+#include <thread>
+
+using namespace video;
+using namespace std;
+
+video::TimestampReplaySource::TimestampReplaySource(shared_ptr<ITSPacketSource> source, double speed)
+{
+	if (source == nullptr)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"source 不能是空指针。"}};
+	}
+
+	if (!(speed > 0))
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"回放速度必须大于 0."}};
+	}
+
+	_source = source;
+	_speed = speed;
+}
+
+ITSPacketSource::ReadPacketResult video::TimestampReplaySource::ReadPacket(ts::TSPacket &packet)
+{
+	ts::TSPacketMetadata metadata;
+	return ReadPacket(packet, metadata);
+}
+
+ITSPacketSource::ReadPacketResult video::TimestampReplaySource::ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata)
+{
+	ITSPacketSource::ReadPacketResult read_packet_result = _source->ReadPacket(packet, metadata);
+	if (read_packet_result != ITSPacketSource::ReadPacketResult::Success || !metadata.hasInputTimeStamp())
+	{
+		return read_packet_result;
+	}
+
+	if (!_clock_started)
+	{
+		_clock_started = true;
+		_anchor_timestamp = _last_timestamp = metadata.getInputTimeStamp();
+		_anchor_time = Clock::now();
+		return read_packet_result;
+	}
+
+	uint64_t delta = TimestampDelta(metadata);
+	uint64_t max_gap = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(_max_gap).count()) * ts::SYSTEM_CLOCK_FREQ / 1000000;
+	if (delta > max_gap)
+	{
+		// 不连续，以当前包重新对齐。
+		_anchor_timestamp = _last_timestamp = metadata.getInputTimeStamp();
+		_anchor_time = Clock::now();
+		return read_packet_result;
+	}
+
+	_last_timestamp += delta;
+
+	// 目标时刻 = 对齐时刻 + 时间戳之差 / 速度。
+	double seconds = double(_last_timestamp - _anchor_timestamp) / ts::SYSTEM_CLOCK_FREQ / _speed;
+	Clock::time_point target = _anchor_time + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+	WaitUntil(target);
+	return read_packet_result;
+}
+
+uint64_t video::TimestampReplaySource::TimestampDelta(ts::TSPacketMetadata const &metadata) const
+{
+	// M2TS 的时间戳只有 30 位。
+	uint64_t const scale = metadata.getInputTimeSource() == ts::TimeSource::M2TS ? (uint64_t(1) << 30) : ts::PCR_SCALE;
+	uint64_t const last = _last_timestamp % scale;
+	uint64_t const current = metadata.getInputTimeStamp() % scale;
+
+	// 倒退会变成接近 scale 的大数，被当作不连续。
+	return (current + scale - last) % scale;
+}
+
+void video::TimestampReplaySource::WaitUntil(Clock::time_point target)
+{
+	Clock::time_point now = Clock::now();
+	if (now > target)
+	{
+		Clock::duration lateness = now - target;
+		if (lateness > _lateness_tolerance)
+		{
+			_late_packet_count++;
+		}
+
+		_max_lateness = std::max(_max_lateness, lateness);
+		return;
+	}
+
+	// 睡眠到离目标时刻还剩 _spin_duration，睡眠可能多睡一点，由自旋吸收。
+	Clock::duration remaining = target - now;
+	if (remaining > _spin_duration)
+	{
+		std::this_thread::sleep_for(remaining - _spin_duration);
+	}
+
+	while (Clock::now() < target)
+	{
+		std::this_thread::yield();
+	}
+}
+
+void video::TimestampReplaySource::Restart()
+{
+	_clock_started = false;
+}
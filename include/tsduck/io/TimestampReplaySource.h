@@ -0,0 +1,109 @@
+#pragma once
+#include <chrono>
+#include <tsduck/interface/ITSPacketSource.h>
+
+namespace video
+{
+	/// <summary>
+	///		按包的输入时间戳回放。包装一个 ITSPacketSource，例如读取 M2TS 或 DUCK 格式文件的
+	///		TSPacketStreamReader，读出包后等到与第一个包的时间戳之差所对应的时刻才返回，
+	///		从而重现录制时包与包之间的间隔。
+	///
+	///		* 等待时先睡眠，离目标时刻不足 SpinDuration 时改为自旋，精度可以达到亚毫秒级。
+	///		* M2TS 的时间戳是 30 位的，大约 39.8 秒回绕一次，其他来源的时间戳按 ts::PCR_SCALE 回绕。
+	///		  回绕会被自动展开。
+	///		* 时间戳倒退或者向前跳变超过 MaxGap 时认为是不连续，以当前包重新对齐时钟，不等待。
+	///		* 没有时间戳的包立即返回。
+	/// </summary>
+	class TimestampReplaySource :
+		public ITSPacketSource
+	{
+	public:
+		/// <summary>
+		///
+		/// </summary>
+		/// <param name="source">被包装的源。</param>
+		/// <param name="speed">回放速度。1 为原速，2 为两倍速。</param>
+		TimestampReplaySource(shared_ptr<ITSPacketSource> source, double speed = 1.0);
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		shared_ptr<ITSPacketSource> _source;
+		double _speed = 1.0;
+
+		bool _clock_started = false;
+
+		/// <summary>
+		///		与 _anchor_time 对应的时间戳，已展开回绕。单位：27MHz 时钟周期。
+		/// </summary>
+		uint64_t _anchor_timestamp = 0;
+		Clock::time_point _anchor_time;
+
+		/// <summary>
+		///		上一个时间戳，已展开回绕。单位：27MHz 时钟周期。
+		/// </summary>
+		uint64_t _last_timestamp = 0;
+
+		uint64_t _late_packet_count = 0;
+		Clock::duration _max_lateness{0};
+
+		/// <summary>
+		///		计算时间戳与上一个时间戳之差，处理回绕。
+		/// </summary>
+		/// <param name="metadata"></param>
+		/// <returns></returns>
+		uint64_t TimestampDelta(ts::TSPacketMetadata const &metadata) const;
+
+		/// <summary>
+		///		睡眠加自旋，等到 target.
+		/// </summary>
+		/// <param name="target"></param>
+		void WaitUntil(Clock::time_point target);
+
+	public:
+		/// <summary>
+		///		离目标时刻小于这个时长时不再睡眠，改为自旋等待。
+		///		系统的睡眠精度越差，这个值应该越大。
+		/// </summary>
+		std::chrono::microseconds _spin_duration{1000};
+
+		/// <summary>
+		///		相邻两个时间戳的差超过这个值时认为时间戳不连续。
+		/// </summary>
+		std::chrono::milliseconds _max_gap{1000};
+
+		/// <summary>
+		///		包迟于目标时刻超过这个值才算作迟到。
+		/// </summary>
+		std::chrono::microseconds _lateness_tolerance{500};
+
+		ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet) override;
+		ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata) override;
+
+		/// <summary>
+		///		重新对齐时钟。下一个带时间戳的包立即返回，之后的包相对于它计时。
+		///		暂停后继续回放时调用。
+		/// </summary>
+		void Restart();
+
+		/// <summary>
+		///		迟于目标时刻超过 _lateness_tolerance 才返回的包数。
+		///		下游处理不过来时，这个值会增长。
+		/// </summary>
+		/// <returns></returns>
+		uint64_t LatePacketCount() const
+		{
+			return _late_packet_count;
+		}
+
+		/// <summary>
+		///		包迟于目标时刻的最大时长。单位：微秒。
+		/// </summary>
+		/// <returns></returns>
+		int64_t MaxLatenessInMicroseconds() const
+		{
+			return std::chrono::duration_cast<std::chrono::microseconds>(_max_lateness).count();
+		}
+	};
+} // namespace video
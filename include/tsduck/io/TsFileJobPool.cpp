@@ -0,0 +1,404 @@
+#include "tsduck/io/TsFileJobPool.h"
+#include <base/filesystem/file.h>
+#include <base/string/define.h>
+#include <condition_variable>
+#include <thread>
+#include <tsduck/io/TSPacketStreamReader.h>
+#include <tsduck/io/TSPacketStreamWriter.h>
+#include <tsTSPacketWindow.h>
+
+using namespace video;
+using namespace std;
+
+#pragma region 内部类型
+/// <summary>
+///		所有任务共享的 I/O 预算。本质是一个计数信号量。
+/// </summary>
+class TsFileJobPool::IoBudget
+{
+public:
+	IoBudget(size_t count)
+	{
+		_available = count;
+	}
+
+private:
+	std::mutex _lock;
+	std::condition_variable _cv;
+	size_t _available = 0;
+
+public:
+	void Acquire()
+	{
+		std::unique_lock l{_lock};
+		_cv.wait(l, [&]()
+				 {
+					 return _available > 0;
+				 });
+
+		_available--;
+	}
+
+	void Release()
+	{
+		{
+			std::lock_guard l{_lock};
+			_available++;
+		}
+
+		_cv.notify_one();
+	}
+
+	/// <summary>
+	///		构造时占用一份预算，析构时归还。
+	/// </summary>
+	class Scope
+	{
+	public:
+		Scope(IoBudget &budget) :
+			_budget(budget)
+		{
+			_budget.Acquire();
+		}
+
+		~Scope()
+		{
+			_budget.Release();
+		}
+
+	private:
+		IoBudget &_budget;
+	};
+};
+
+/// <summary>
+///		写文件时占用 I/O 预算。
+///
+///		逐个送入的包先缓存起来，Flush 时或缓存满了才一次性写出，整批只占用一次预算，
+///		不会每个包都去抢一次信号量。窗口整个写出，也只占用一次。
+/// </summary>
+class TsFileJobPool::IoBudgetConsumer :
+	public ITSPacketConsumer
+{
+public:
+	IoBudgetConsumer(shared_ptr<IoBudget> io_budget, shared_ptr<ITSPacketConsumer> consumer, size_t buffer_size)
+	{
+		_io_budget = io_budget;
+		_consumer = consumer;
+		_buffer_size = std::max<size_t>(buffer_size, 1);
+		_packets.reserve(_buffer_size);
+		_metadata.reserve(_buffer_size);
+	}
+
+private:
+	shared_ptr<IoBudget> _io_budget;
+	shared_ptr<ITSPacketConsumer> _consumer;
+	size_t _buffer_size = 1;
+	std::vector<ts::TSPacket> _packets;
+	std::vector<ts::TSPacketMetadata> _metadata;
+	ts::TSPacketWindow _window;
+
+	/// <summary>
+	///		写出缓存的包。调用者需要已经占用了预算。
+	/// </summary>
+	void WriteBuffer()
+	{
+		if (_packets.empty())
+		{
+			return;
+		}
+
+		_window.clear();
+		_window.addPacketsReference(_packets.data(), _metadata.data(), _packets.size());
+		_consumer->SendPacketWindow(_window);
+		_packets.clear();
+		_metadata.clear();
+	}
+
+public:
+	void SendPacket(ts::TSPacket *packet) override
+	{
+		_packets.push_back(*packet);
+		_metadata.push_back(ts::TSPacketMetadata{});
+		if (_packets.size() >= _buffer_size)
+		{
+			Flush();
+		}
+	}
+
+	void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override
+	{
+		_packets.push_back(*packet);
+		_metadata.push_back(metadata == nullptr ? ts::TSPacketMetadata{} : *metadata);
+		if (_packets.size() >= _buffer_size)
+		{
+			Flush();
+		}
+	}
+
+	void SendPacketWindow(ts::TSPacketWindow &window) override
+	{
+		// 先写出之前缓存的包，保持顺序。
+		IoBudget::Scope scope{*_io_budget};
+		WriteBuffer();
+		_consumer->SendPacketWindow(window);
+	}
+
+	/// <summary>
+	///		写出缓存的包。
+	/// </summary>
+	void Flush()
+	{
+		if (_packets.empty())
+		{
+			return;
+		}
+
+		IoBudget::Scope scope{*_io_budget};
+		WriteBuffer();
+	}
+};
+#pragma endregion
+
+video::TsFileJobPool::TsFileJobPool(size_t worker_count)
+{
+	if (worker_count == 0)
+	{
+		worker_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+
+	_worker_count = worker_count;
+}
+
+void video::TsFileJobPool::SetOutputNameTemplate(std::string const &name_template)
+{
+	if (_running || !_jobs.empty())
+	{
+		throw std::runtime_error{CODE_POS_STR + std::string{"必须在添加任务之前设置输出文件名模板。"}};
+	}
+
+	_file_name_generator.initCounter(name_template);
+	_has_output_name_template = true;
+}
+
+size_t video::TsFileJobPool::AddFile(std::string const &input_path)
+{
+	if (_running)
+	{
+		throw std::runtime_error{CODE_POS_STR + std::string{"运行中不能添加任务。"}};
+	}
+
+	TsFileJob job;
+	job.index = _jobs.size();
+	job.input_path = input_path;
+	if (_has_output_name_template)
+	{
+		// 在这里按加入顺序生成文件名，与任务完成的顺序无关。
+		job.output_path = _file_name_generator.newFileName().string();
+	}
+
+	_jobs.push_back(job);
+	return job.index;
+}
+
+std::vector<TsFileJobResult> video::TsFileJobPool::Run(shared_ptr<base::CancellationToken> cancel)
+{
+	if (_running)
+	{
+		throw std::runtime_error{CODE_POS_STR + std::string{"已经在运行了。"}};
+	}
+
+	if (_max_concurrent_io == 0 || _window_size == 0)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"_max_concurrent_io 和 _window_size 不能为 0。"}};
+	}
+
+	_running = true;
+	_next_job_index = 0;
+	_finished_job_count = 0;
+	_results.assign(_jobs.size(), TsFileJobResult{});
+	for (size_t i = 0; i < _jobs.size(); i++)
+	{
+		_results[i].job = _jobs[i];
+	}
+
+	shared_ptr<IoBudget> io_budget{new IoBudget{_max_concurrent_io}};
+	std::vector<std::thread> threads;
+	size_t thread_count = std::min(_worker_count, _jobs.size());
+	for (size_t i = 0; i < thread_count; i++)
+	{
+		threads.emplace_back(&TsFileJobPool::WorkerThreadFunc, this, io_budget, cancel);
+	}
+
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+
+	_running = false;
+	return std::move(_results);
+}
+
+void video::TsFileJobPool::WorkerThreadFunc(shared_ptr<IoBudget> io_budget, shared_ptr<base::CancellationToken> cancel)
+{
+	while (!base::is_cancellation_requested(cancel))
+	{
+		size_t index = _next_job_index++;
+		if (index >= _jobs.size())
+		{
+			return;
+		}
+
+		TsFileJob const &job = _jobs[index];
+		try
+		{
+			_results[index] = RunJob(job, io_budget, cancel);
+		}
+		catch (std::exception &e)
+		{
+			_results[index].success = false;
+			_results[index].error = e.what();
+		}
+		catch (...)
+		{
+			// 其他类型的异常逃出线程函数会调用 std::terminate，结束整个进程。
+			_results[index].success = false;
+			_results[index].error = "未知类型的异常";
+		}
+
+		_finished_job_count++;
+		ReportProgress(job, _results[index].packet_count, true);
+	}
+}
+
+TsFileJobResult video::TsFileJobPool::RunJob(TsFileJob const &job,
+											 shared_ptr<IoBudget> io_budget,
+											 shared_ptr<base::CancellationToken> cancel)
+{
+	TsFileJobResult result;
+	result.job = job;
+
+	shared_ptr<TSPacketStreamReader> reader;
+	{
+		IoBudget::Scope scope{*io_budget};
+		reader = shared_ptr<TSPacketStreamReader>{new TSPacketStreamReader{base::file::OpenExisting(job.input_path)}};
+	}
+
+	shared_ptr<base::Stream> out_stream;
+	shared_ptr<IoBudgetConsumer> writer;
+	if (!job.output_path.empty())
+	{
+		IoBudget::Scope scope{*io_budget};
+		out_stream = base::file::CreateNewAnyway(job.output_path);
+		writer = shared_ptr<IoBudgetConsumer>{
+			new IoBudgetConsumer{
+				io_budget,
+				shared_ptr<TSPacketStreamWriter>{new TSPacketStreamWriter{out_stream}},
+				_window_size,
+			},
+		};
+	}
+
+	shared_ptr<ITSPacketConsumer> chain = writer;
+	if (_on_create_chain)
+	{
+		chain = _on_create_chain(job, writer);
+	}
+
+	// 与 ITSPacketSource::PumpWindowTo 相同，但是读取窗口期间占用 I/O 预算，处理窗口期间不占用。
+	std::vector<ts::TSPacket> packets(_window_size);
+	std::vector<ts::TSPacketMetadata> metadata(_window_size);
+	ts::TSPacketWindow window;
+	uint64_t next_progress = _progress_interval_in_packets;
+	while (!base::is_cancellation_requested(cancel))
+	{
+		ITSPacketSource::ReadPacketResult read_packet_result = ITSPacketSource::ReadPacketResult::Success;
+		size_t count = 0;
+		{
+			IoBudget::Scope scope{*io_budget};
+			while (count < _window_size)
+			{
+				read_packet_result = reader->ReadPacket(packets[count], metadata[count]);
+				if (read_packet_result != ITSPacketSource::ReadPacketResult::Success)
+				{
+					break;
+				}
+
+				count++;
+			}
+		}
+
+		if (count > 0)
+		{
+			result.packet_count += count;
+			if (chain != nullptr)
+			{
+				window.clear();
+				window.addPacketsReference(packets.data(), metadata.data(), count);
+				chain->SendPacketWindow(window);
+			}
+
+			if (writer != nullptr)
+			{
+				// 处理链逐个送出的包在每个窗口结束时一次性写出。
+				writer->Flush();
+			}
+
+			if (result.packet_count >= next_progress)
+			{
+				ReportProgress(job, result.packet_count, false);
+				next_progress = result.packet_count + _progress_interval_in_packets;
+			}
+		}
+
+		result.read_packet_result = read_packet_result;
+		if (read_packet_result != ITSPacketSource::ReadPacketResult::Success)
+		{
+			break;
+		}
+	}
+
+	if (_on_input_exhausted)
+	{
+		_on_input_exhausted(job, chain);
+	}
+
+	if (out_stream != nullptr)
+	{
+		writer->Flush();
+		IoBudget::Scope scope{*io_budget};
+		out_stream->Flush();
+	}
+
+	result.success = true;
+	return result;
+}
+
+void video::TsFileJobPool::ReportProgress(TsFileJob const &job, uint64_t packet_count, bool finished)
+{
+	if (!_on_progress)
+	{
+		return;
+	}
+
+	TsFileJobProgress progress;
+	progress.job = job;
+	progress.packet_count = packet_count;
+	progress.finished = finished;
+	progress.finished_job_count = _finished_job_count;
+	progress.job_count = _jobs.size();
+
+	std::lock_guard l{_progress_lock};
+	try
+	{
+		_on_progress(progress);
+	}
+	catch (std::exception &e)
+	{
+		cerr << CODE_POS_STR << e.what() << endl;
+	}
+	catch (...)
+	{
+		cerr << CODE_POS_STR << "进度回调抛出了未知类型的异常" << endl;
+	}
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include <atomic>
+#include <base/task/CancellationToken.h>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <tsduck/interface/ITSPacketConsumer.h>
+#include <tsduck/interface/ITSPacketSource.h>
+#include <tsFileNameGenerator.h>
+#include <vector>
+
+namespace video
+{
+	/// <summary>
+	///		一个文件任务。
+	/// </summary>
+	struct TsFileJob
+	{
+		/// <summary>
+		///		任务序号，即加入的顺序，从 0 开始。
+		/// </summary>
+		size_t index = 0;
+
+		std::string input_path;
+
+		/// <summary>
+		///		输出文件路径。没有设置输出文件名模板时为空。
+		/// </summary>
+		std::string output_path;
+	};
+
+	/// <summary>
+	///		任务进度。
+	/// </summary>
+	struct TsFileJobProgress
+	{
+		TsFileJob job;
+
+		/// <summary>
+		///		本任务已经读取的包数。
+		/// </summary>
+		uint64_t packet_count = 0;
+
+		/// <summary>
+		///		本任务是否已经结束。
+		/// </summary>
+		bool finished = false;
+
+		/// <summary>
+		///		所有任务中已经结束的任务数。
+		/// </summary>
+		size_t finished_job_count = 0;
+
+		/// <summary>
+		///		任务总数。
+		/// </summary>
+		size_t job_count = 0;
+	};
+
+	/// <summary>
+	///		任务结果。
+	/// </summary>
+	struct TsFileJobResult
+	{
+		TsFileJob job;
+		uint64_t packet_count = 0;
+
+		/// <summary>
+		///		正常读完是 ITSPacketSource::ReadPacketResult::NoMorePacket，被取消是
+		///		ITSPacketSource::ReadPacketResult::Success.
+		/// </summary>
+		ITSPacketSource::ReadPacketResult read_packet_result = ITSPacketSource::ReadPacketResult::Success;
+
+		/// <summary>
+		///		任务抛出异常时为 false，异常信息在 error 中。
+		/// </summary>
+		bool success = false;
+		std::string error;
+	};
+
+	/// <summary>
+	///		用多个线程并行处理互不相关的 ts 文件，例如批量分析或重新复用一批录制文件。
+	///
+	///		* 每个任务有自己的一条处理链：TSPacketStreamReader → _on_create_chain 创建的各级 → TSPacketStreamWriter.
+	///		  各条链之间不共享对象，所以处理链中的各级不需要是线程安全的。
+	///		* 所有任务共享一个 I/O 预算：同一时刻最多有 _max_concurrent_io 个线程在读写文件，
+	///		  其余线程只做计算，避免几十个线程同时读盘导致磁头来回寻道。
+	///		* 输出文件名用 ts::FileNameGenerator 生成，按加入任务的顺序编号，与任务完成的顺序无关。
+	/// </summary>
+	class TsFileJobPool
+	{
+	public:
+		/// <summary>
+		///
+		/// </summary>
+		/// <param name="worker_count">工作线程数。为 0 时使用 CPU 核心数。</param>
+		TsFileJobPool(size_t worker_count = 0);
+
+	private:
+		class IoBudget;
+		class IoBudgetConsumer;
+
+		size_t _worker_count = 1;
+		std::vector<TsFileJob> _jobs;
+		ts::FileNameGenerator _file_name_generator;
+		bool _has_output_name_template = false;
+		bool _running = false;
+
+		std::atomic<size_t> _next_job_index = 0;
+		std::atomic<size_t> _finished_job_count = 0;
+		std::vector<TsFileJobResult> _results;
+		std::mutex _progress_lock;
+
+		void WorkerThreadFunc(shared_ptr<IoBudget> io_budget, shared_ptr<base::CancellationToken> cancel);
+		TsFileJobResult RunJob(TsFileJob const &job, shared_ptr<IoBudget> io_budget, shared_ptr<base::CancellationToken> cancel);
+		void ReportProgress(TsFileJob const &job, uint64_t packet_count, bool finished);
+
+	public:
+		/// <summary>
+		///		为每个任务创建处理链。
+		///		参数是任务和写入输出文件的 consumer，没有输出文件时 consumer 为空指针。
+		///		返回处理链的入口，读到的包会送给它。
+		///
+		///		为空时包直接送给写入输出文件的 consumer.
+		///		会在工作线程中被调用，多个线程可能同时调用。
+		/// </summary>
+		std::function<shared_ptr<ITSPacketConsumer>(TsFileJob const &job, shared_ptr<ITSPacketConsumer> writer)> _on_create_chain;
+
+		/// <summary>
+		///		输入文件读完后，输出文件冲洗前调用。参数是任务和处理链的入口。
+		///		处理链中缓存了包的级，例如 CbrShaper, 应该在这里冲洗。
+		///		会在工作线程中被调用。
+		/// </summary>
+		std::function<void(TsFileJob const &job, shared_ptr<ITSPacketConsumer> chain)> _on_input_exhausted;
+
+		/// <summary>
+		///		报告进度。每读取 _progress_interval_in_packets 个包和每个任务结束时调用。
+		///		会在工作线程中被调用，但是调用之间互斥，不需要加锁。
+		/// </summary>
+		std::function<void(TsFileJobProgress const &progress)> _on_progress;
+
+		/// <summary>
+		///		同一时刻最多有几个线程在读写文件。
+		/// </summary>
+		size_t _max_concurrent_io = 4;
+
+		/// <summary>
+		///		每个任务每次读取的包数。读取一个窗口期间占用一份 I/O 预算。
+		/// </summary>
+		size_t _window_size = 512;
+
+		/// <summary>
+		///		每读取多少个包报告一次进度。
+		/// </summary>
+		uint64_t _progress_interval_in_packets = 100000;
+
+		/// <summary>
+		///		设置输出文件名模板，模板的格式见 ts::FileNameGenerator::initCounter.
+		///		例如 "out.ts" 会生成 out-000000.ts, out-000001.ts ...
+		///		不设置则不写出文件。需要在 AddFile 之前设置。
+		/// </summary>
+		/// <param name="name_template"></param>
+		void SetOutputNameTemplate(std::string const &name_template);
+
+		/// <summary>
+		///		添加一个输入文件。
+		/// </summary>
+		/// <param name="input_path"></param>
+		/// <returns>任务序号。</returns>
+		size_t AddFile(std::string const &input_path);
+
+		/// <summary>
+		///		任务总数。
+		/// </summary>
+		/// <returns></returns>
+		size_t JobCount() const
+		{
+			return _jobs.size();
+		}
+
+		/// <summary>
+		///		运行所有任务，全部结束后返回。一个任务抛出异常不影响其他任务。
+		///		取消后，正在运行的任务会在读完当前窗口后结束，还没开始的任务不再开始，
+		///		它们的结果的 success 为 false.
+		/// </summary>
+		/// <param name="cancel"></param>
+		/// <returns>按任务序号排列的结果。</returns>
+		std::vector<TsFileJobResult> Run(shared_ptr<base::CancellationToken> cancel);
+	};
+} // namespace video
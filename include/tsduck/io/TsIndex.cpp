@@ -0,0 +1,234 @@
+#include "tsduck/io/TsIndex.h"
+#include <algorithm>
+#include <base/string/define.h>
+#include <cstring>
+#include <stdexcept>
+#include <tsMemory.h>
+
+using namespace video;
+using namespace std;
+
+namespace
+{
+	/// <summary>
+	///		读满 count 个字节，除非流结束。
+	/// </summary>
+	/// <returns>读到的字节数。</returns>
+	size_t ReadExactly(base::Stream &stream, uint8_t *buffer, size_t count)
+	{
+		size_t have_read = 0;
+		while (have_read < count)
+		{
+			int32_t n = stream.Read(buffer, static_cast<int32_t>(have_read), static_cast<int32_t>(count - have_read));
+			if (n <= 0)
+			{
+				break;
+			}
+
+			have_read += n;
+		}
+
+		return have_read;
+	}
+} // namespace
+
+video::TsIndex::TsIndex(uint16_t packet_size)
+{
+	if (packet_size < ts::PKT_SIZE)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"包大小不能小于 188."}};
+	}
+
+	_packet_size = packet_size;
+}
+
+void video::TsIndex::Add(TsIndexEntry const &entry)
+{
+	if (!_entries.empty() && entry.packet_index < _entries.back().packet_index)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"条目必须按 packet_index 递增的顺序添加。"}};
+	}
+
+	_entries.push_back(entry);
+}
+
+TsIndexEntry const *video::TsIndex::FindLastBefore(TsIndexEntryType type, uint16_t service_id, uint64_t packet_index) const
+{
+	// 条目按 packet_index 排序，先二分找到上界，再向前找满足条件的条目。
+	auto it = std::upper_bound(_entries.begin(), _entries.end(), packet_index,
+							   [](uint64_t index, TsIndexEntry const &entry)
+							   {
+								   return index < entry.packet_index;
+							   });
+
+	while (it != _entries.begin())
+	{
+		--it;
+		if (it->type == type && (service_id == 0xFFFF || it->service_id == service_id))
+		{
+			return &*it;
+		}
+	}
+
+	return nullptr;
+}
+
+TsIndexEntry const *video::TsIndex::FindRandomAccessPointByPts(uint16_t service_id, int64_t pts) const
+{
+	TsIndexEntry const *result = nullptr;
+	for (TsIndexEntry const &entry : _entries)
+	{
+		if (entry.type != TsIndexEntryType::RandomAccessPoint || entry.pts < 0)
+		{
+			continue;
+		}
+
+		if (service_id == 0xFFFF)
+		{
+			service_id = entry.service_id;
+		}
+
+		if (entry.service_id != service_id)
+		{
+			continue;
+		}
+
+		// PTS 在 B 帧之间不单调，但随机访问点之间是递增的，到第一个超过的就可以停止。
+		if (entry.pts > pts)
+		{
+			break;
+		}
+
+		result = &entry;
+	}
+
+	return result;
+}
+
+uint16_t video::TsIndex::ResolvePcrServiceId(uint16_t service_id) const
+{
+	if (service_id != 0xFFFF)
+	{
+		return service_id;
+	}
+
+	for (TsIndexEntry const &entry : _entries)
+	{
+		if (entry.type == TsIndexEntryType::RandomAccessPoint && entry.pcr >= 0)
+		{
+			return entry.service_id;
+		}
+	}
+
+	return 0xFFFF;
+}
+
+TsIndexEntry const *video::TsIndex::FindRandomAccessPointByPcr(uint16_t service_id, int64_t pcr) const
+{
+	service_id = ResolvePcrServiceId(service_id);
+	if (service_id == 0xFFFF)
+	{
+		return nullptr;
+	}
+
+	TsIndexEntry const *result = nullptr;
+	for (TsIndexEntry const &entry : _entries)
+	{
+		if (entry.type != TsIndexEntryType::RandomAccessPoint || entry.pcr < 0)
+		{
+			continue;
+		}
+
+		if (entry.service_id != service_id)
+		{
+			continue;
+		}
+
+		if (entry.pcr > pcr)
+		{
+			break;
+		}
+
+		result = &entry;
+	}
+
+	return result;
+}
+
+int64_t video::TsIndex::FirstPcr(uint16_t service_id) const
+{
+	service_id = ResolvePcrServiceId(service_id);
+	if (service_id == 0xFFFF)
+	{
+		return -1;
+	}
+
+	for (TsIndexEntry const &entry : _entries)
+	{
+		if (entry.service_id == service_id && entry.pcr >= 0)
+		{
+			return entry.pcr;
+		}
+	}
+
+	return -1;
+}
+
+void video::TsIndex::WriteHeader(base::Stream &stream) const
+{
+	uint8_t buffer[HEADER_SIZE]{};
+	std::memcpy(buffer, "TSIX", 4);
+	ts::PutUInt16(buffer + 4, VERSION);
+	ts::PutUInt16(buffer + 6, _packet_size);
+	stream.Write(buffer, 0, HEADER_SIZE);
+}
+
+void video::TsIndex::WriteEntry(base::Stream &stream, TsIndexEntry const &entry)
+{
+	uint8_t buffer[ENTRY_SIZE]{};
+	buffer[0] = static_cast<uint8_t>(entry.type);
+	ts::PutUInt16(buffer + 2, entry.pid);
+	ts::PutUInt16(buffer + 4, entry.service_id);
+	ts::PutUInt64(buffer + 8, entry.packet_index);
+	ts::PutUInt64(buffer + 16, static_cast<uint64_t>(entry.pcr));
+	ts::PutUInt64(buffer + 24, static_cast<uint64_t>(entry.pts));
+	stream.Write(buffer, 0, ENTRY_SIZE);
+}
+
+void video::TsIndex::Save(base::Stream &stream) const
+{
+	WriteHeader(stream);
+	for (TsIndexEntry const &entry : _entries)
+	{
+		WriteEntry(stream, entry);
+	}
+}
+
+TsIndex video::TsIndex::Load(base::Stream &stream)
+{
+	uint8_t buffer[ENTRY_SIZE];
+	if (ReadExactly(stream, buffer, HEADER_SIZE) != HEADER_SIZE || std::memcmp(buffer, "TSIX", 4) != 0)
+	{
+		throw std::runtime_error{CODE_POS_STR + std::string{"不是 ts 索引文件。"}};
+	}
+
+	if (ts::GetUInt16(buffer + 4) != VERSION)
+	{
+		throw std::runtime_error{CODE_POS_STR + std::string{"不支持的索引文件版本。"}};
+	}
+
+	TsIndex index{ts::GetUInt16(buffer + 6)};
+	while (ReadExactly(stream, buffer, ENTRY_SIZE) == ENTRY_SIZE)
+	{
+		TsIndexEntry entry;
+		entry.type = static_cast<TsIndexEntryType>(buffer[0]);
+		entry.pid = ts::GetUInt16(buffer + 2);
+		entry.service_id = ts::GetUInt16(buffer + 4);
+		entry.packet_index = ts::GetUInt64(buffer + 8);
+		entry.pcr = static_cast<int64_t>(ts::GetUInt64(buffer + 16));
+		entry.pts = static_cast<int64_t>(ts::GetUInt64(buffer + 24));
+		index.Add(entry);
+	}
+
+	return index;
+}
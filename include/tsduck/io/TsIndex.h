@@ -0,0 +1,181 @@
+#pragma once
+#include <base/stream/Stream.h>
+#include <stdint.h>
+#include <tsTS.h>
+#include <vector>
+
+namespace video
+{
+	/// <summary>
+	///		索引条目的类型。
+	/// </summary>
+	enum class TsIndexEntryType : uint8_t
+	{
+		/// <summary>
+		///		PAT 的第一个包。
+		/// </summary>
+		Pat = 1,
+
+		/// <summary>
+		///		PMT 的第一个包。
+		/// </summary>
+		Pmt = 2,
+
+		/// <summary>
+		///		视频的随机访问点。见 RandomAccessPoint::Check.
+		/// </summary>
+		RandomAccessPoint = 3,
+
+		/// <summary>
+		///		按固定间隔记录的 PCR 和 PTS.
+		/// </summary>
+		Time = 4,
+	};
+
+	/// <summary>
+	///		索引条目。
+	/// </summary>
+	struct TsIndexEntry
+	{
+		TsIndexEntryType type = TsIndexEntryType::Time;
+
+		uint16_t pid = ts::PID_NULL;
+
+		/// <summary>
+		///		所属节目。PAT 为 0xFFFF.
+		/// </summary>
+		uint16_t service_id = 0xFFFF;
+
+		/// <summary>
+		///		包在文件中的序号，从 0 开始。文件偏移量 = packet_index * 包大小。
+		/// </summary>
+		uint64_t packet_index = 0;
+
+		/// <summary>
+		///		节目到这个包为止的最后一个 PCR, 已展开回绕。没有时为 -1.
+		/// </summary>
+		int64_t pcr = -1;
+
+		/// <summary>
+		///		随机访问点是这个包的 PTS, Time 条目是节目第一路视频流（没有视频时是第一路流）的最后一个 PTS.
+		///		已展开回绕。没有时为 -1.
+		/// </summary>
+		int64_t pts = -1;
+	};
+
+	/// <summary>
+	///		ts 文件的随机访问索引。由 TsIndexBuilder 生成，TsIndexedSource 用它在文件中定位。
+	///
+	///		文件格式，整数都是大端序：
+	///		* 文件头 16 字节："TSIX", 版本号 uint16, 包大小 uint16, 保留 8 字节。
+	///		* 之后是任意个 32 字节的条目：type uint8, 保留 uint8, pid uint16, service_id uint16,
+	///		  保留 uint16, packet_index uint64, pcr int64, pts int64.
+	///
+	///		条目按 packet_index 递增的顺序排列。没有条目数字段，所以录制过程中可以一边追加一边读取。
+	/// </summary>
+	class TsIndex
+	{
+	public:
+		TsIndex(uint16_t packet_size = ts::PKT_SIZE);
+
+	private:
+		uint16_t _packet_size = ts::PKT_SIZE;
+		std::vector<TsIndexEntry> _entries;
+
+		/// <summary>
+		///		service_id 为 0xFFFF 时返回第一个有 PCR 的随机访问点的节目，没有这样的随机访问点时返回 0xFFFF.
+		///		否则原样返回。
+		/// </summary>
+		/// <param name="service_id"></param>
+		/// <returns></returns>
+		uint16_t ResolvePcrServiceId(uint16_t service_id) const;
+
+	public:
+		static constexpr uint16_t VERSION = 1;
+		static constexpr size_t HEADER_SIZE = 16;
+		static constexpr size_t ENTRY_SIZE = 32;
+
+		/// <summary>
+		///		文件中每个包的大小。ts 为 188, M2TS 为 192.
+		/// </summary>
+		/// <returns></returns>
+		uint16_t PacketSize() const
+		{
+			return _packet_size;
+		}
+
+		std::vector<TsIndexEntry> const &Entries() const
+		{
+			return _entries;
+		}
+
+		/// <summary>
+		///		追加条目。packet_index 不能小于最后一个条目。
+		/// </summary>
+		/// <param name="entry"></param>
+		void Add(TsIndexEntry const &entry);
+
+		/// <summary>
+		///		找出 packet_index 不大于 packet_index 的最后一个满足条件的条目。
+		/// </summary>
+		/// <param name="type"></param>
+		/// <param name="service_id">为 0xFFFF 时不限节目。</param>
+		/// <param name="packet_index"></param>
+		/// <returns>找不到时返回空指针。</returns>
+		TsIndexEntry const *FindLastBefore(TsIndexEntryType type, uint16_t service_id, uint64_t packet_index) const;
+
+		/// <summary>
+		///		找出 PTS 不大于 pts 的最后一个随机访问点。
+		///		PTS 只在同一个节目内比较。
+		/// </summary>
+		/// <param name="service_id">为 0xFFFF 时使用第一个有随机访问点的节目。</param>
+		/// <param name="pts">已展开回绕的 PTS.</param>
+		/// <returns>找不到时返回空指针。</returns>
+		TsIndexEntry const *FindRandomAccessPointByPts(uint16_t service_id, int64_t pts) const;
+
+		/// <summary>
+		///		找出 PCR 不大于 pcr 的最后一个随机访问点。
+		///		各个节目的 PCR 可能来自不同的时钟，所以 PCR 只在同一个节目内比较。
+		/// </summary>
+		/// <param name="service_id">为 0xFFFF 时使用第一个有 PCR 的随机访问点的节目。</param>
+		/// <param name="pcr">已展开回绕的 PCR.</param>
+		/// <returns>找不到时返回空指针。</returns>
+		TsIndexEntry const *FindRandomAccessPointByPcr(uint16_t service_id, int64_t pcr) const;
+
+		/// <summary>
+		///		节目第一个有 PCR 的条目的 PCR. 没有时返回 -1.
+		/// </summary>
+		/// <param name="service_id">
+		///		为 0xFFFF 时使用第一个有 PCR 的随机访问点的节目，与 FindRandomAccessPointByPcr 一致。
+		/// </param>
+		/// <returns></returns>
+		int64_t FirstPcr(uint16_t service_id) const;
+
+		/// <summary>
+		///		写入文件头。
+		/// </summary>
+		/// <param name="stream"></param>
+		void WriteHeader(base::Stream &stream) const;
+
+		/// <summary>
+		///		写入一个条目。
+		/// </summary>
+		/// <param name="stream"></param>
+		/// <param name="entry"></param>
+		static void WriteEntry(base::Stream &stream, TsIndexEntry const &entry);
+
+		/// <summary>
+		///		写入文件头和所有条目。
+		/// </summary>
+		/// <param name="stream"></param>
+		void Save(base::Stream &stream) const;
+
+		/// <summary>
+		///		从流中读取索引。末尾不完整的条目，例如录制中正在写的条目，会被忽略。
+		///		格式不对会抛出 std::runtime_error.
+		/// </summary>
+		/// <param name="stream"></param>
+		/// <returns></returns>
+		static TsIndex Load(base::Stream &stream);
+	};
+} // namespace video
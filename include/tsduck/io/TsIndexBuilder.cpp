@@ -0,0 +1,168 @@
+#include "tsduck/io/TsIndexBuilder.h"
+#include <tsduck/RandomAccessPoint.h>
+
+using namespace video;
+using namespace std;
+
+video::TsIndexBuilder::TsIndexBuilder(shared_ptr<base::Stream> index_stream, uint16_t packet_size)
+{
+	_index = shared_ptr<TsIndex>{new TsIndex{packet_size}};
+	_index_stream = index_stream;
+	if (_index_stream != nullptr)
+	{
+		_index->WriteHeader(*_index_stream);
+	}
+}
+
+void video::TsIndexBuilder::HandlePatVersionChange(ts::PAT &pat)
+{
+	_services.clear();
+	_pmt_pids.clear();
+	_rap_pids.clear();
+	for (auto const &it : pat.pmts)
+	{
+		_services[it.first].pmt_pid = it.second;
+		_pmt_pids[it.second] = it.first;
+	}
+}
+
+void video::TsIndexBuilder::HandlePmtVersionChange(ts::PMT &pmt, uint16_t source_pid)
+{
+	auto it = _services.find(pmt.service_id);
+	if (it == _services.end() || it->second.pmt_pid != source_pid)
+	{
+		return;
+	}
+
+	ServiceState &service = it->second;
+	service.pcr_pid = pmt.pcr_pid;
+	if (service.rap_pid != ts::PID_NULL)
+	{
+		_rap_pids.erase(service.rap_pid);
+	}
+
+	// 第一路视频流，没有视频时用第一路流。
+	service.rap_pid = ts::PID_NULL;
+	service.rap_stream_type = ts::ST_NULL;
+	for (auto const &stream : pmt.streams)
+	{
+		if (stream.second.isVideo(*_duck))
+		{
+			service.rap_pid = stream.first;
+			service.rap_stream_type = stream.second.stream_type;
+			break;
+		}
+	}
+
+	if (service.rap_pid == ts::PID_NULL && !pmt.streams.empty())
+	{
+		service.rap_pid = pmt.streams.begin()->first;
+		service.rap_stream_type = pmt.streams.begin()->second.stream_type;
+	}
+
+	if (service.rap_pid != ts::PID_NULL)
+	{
+		_rap_pids[service.rap_pid] = pmt.service_id;
+	}
+}
+
+int64_t video::TsIndexBuilder::ServicePcr(ServiceState const &service) const
+{
+	ts::TimelineDemux::PIDTimeline const *timeline = _timeline.pidTimeline(service.pcr_pid);
+	if (timeline == nullptr || !timeline->pcr.isValid())
+	{
+		return -1;
+	}
+
+	return timeline->pcr.extended();
+}
+
+int64_t video::TsIndexBuilder::PidPts(uint16_t pid) const
+{
+	ts::TimelineDemux::PIDTimeline const *timeline = _timeline.pidTimeline(pid);
+	if (timeline == nullptr || !timeline->pts.isValid())
+	{
+		return -1;
+	}
+
+	return timeline->pts.extended();
+}
+
+void video::TsIndexBuilder::AddEntry(TsIndexEntryType type, uint16_t pid, uint16_t service_id, int64_t pcr, int64_t pts)
+{
+	TsIndexEntry entry;
+	entry.type = type;
+	entry.pid = pid;
+	entry.service_id = service_id;
+	entry.packet_index = _packet_index;
+	entry.pcr = pcr;
+	entry.pts = pts;
+	_index->Add(entry);
+	if (_index_stream != nullptr)
+	{
+		TsIndex::WriteEntry(*_index_stream, entry);
+	}
+}
+
+void video::TsIndexBuilder::SendPacket(ts::TSPacket *packet)
+{
+	_demux->feedPacket(*packet);
+	_timeline.feedPacket(*packet);
+
+	uint16_t pid = packet->getPID();
+	if (packet->getPUSI())
+	{
+		if (pid == ts::PID_PAT)
+		{
+			int64_t pcr = _timeline.referencePCRPID() == ts::PID_NULL ? -1 : _timeline.referencePCR();
+			AddEntry(TsIndexEntryType::Pat, pid, 0xFFFF, pcr, -1);
+		}
+
+		auto pmt_it = _pmt_pids.find(pid);
+		if (pmt_it != _pmt_pids.end())
+		{
+			AddEntry(TsIndexEntryType::Pmt, pid, pmt_it->second, ServicePcr(_services[pmt_it->second]), -1);
+		}
+
+		auto rap_it = _rap_pids.find(pid);
+		if (rap_it != _rap_pids.end())
+		{
+			ServiceState const &service = _services[rap_it->second];
+			if (RandomAccessPoint::Check(*packet, service.rap_stream_type))
+			{
+				int64_t pts = packet->hasPTS() ? PidPts(pid) : -1;
+				AddEntry(TsIndexEntryType::RandomAccessPoint, pid, rap_it->second, ServicePcr(service), pts);
+			}
+		}
+	}
+
+	if (packet->hasPCR())
+	{
+		for (auto &it : _services)
+		{
+			ServiceState &service = it.second;
+			if (service.pcr_pid != pid)
+			{
+				continue;
+			}
+
+			int64_t pcr = ServicePcr(service);
+			if (service.last_time_entry_pcr < 0 ||
+				ts::TimelineDemux::PCRToMilliSecond(service.last_time_entry_pcr, pcr) >= _time_interval_in_milliseconds)
+			{
+				AddEntry(TsIndexEntryType::Time, pid, it.first, pcr, PidPts(service.rap_pid));
+				service.last_time_entry_pcr = pcr;
+			}
+		}
+	}
+
+	_packet_index++;
+}
+
+void video::TsIndexBuilder::Flush()
+{
+	if (_index_stream != nullptr)
+	{
+		_index_stream->Flush();
+	}
+}
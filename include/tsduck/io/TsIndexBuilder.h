@@ -0,0 +1,111 @@
+#pragma once
+#include <base/stream/Stream.h>
+#include <map>
+#include <tsduck/handler/TableVersionChangeHandler.h>
+#include <tsduck/interface/ITSPacketConsumer.h>
+#include <tsduck/io/TsIndex.h>
+#include <tsTimelineDemux.h>
+
+namespace video
+{
+	/// <summary>
+	///		送入 ts 包，生成随机访问索引。记录：
+	///		* PAT 和每个节目的 PMT 每次出现的位置。
+	///		* 每个节目第一路视频流（没有视频时是第一路流）的随机访问点和它的 PTS.
+	///		* 每个节目每隔 _time_interval_in_milliseconds 的 PCR 和上述流的 PTS.
+	///
+	///		可以和写文件的 consumer 并列挂在同一个源后面，录制的同时生成索引；
+	///		也可以用 TSPacketStreamReader 读已经录好的文件离线生成。
+	///		送入的包必须与文件中的包一一对应，packet_index 才是正确的。
+	/// </summary>
+	class TsIndexBuilder :
+		public ITSPacketConsumer,
+		public TableVersionChangeHandler
+	{
+	public:
+		/// <summary>
+		///
+		/// </summary>
+		/// <param name="index_stream">
+		///		每生成一个条目就追加写入这个流，构造时写入文件头。为空指针时只保存在内存中。
+		/// </param>
+		/// <param name="packet_size">ts 文件中每个包的大小。ts 为 188, M2TS 为 192.</param>
+		TsIndexBuilder(shared_ptr<base::Stream> index_stream = nullptr, uint16_t packet_size = ts::PKT_SIZE);
+
+	private:
+		/// <summary>
+		///		一个节目的索引状态。
+		/// </summary>
+		struct ServiceState
+		{
+			uint16_t pmt_pid = ts::PID_NULL;
+			uint16_t pcr_pid = ts::PID_NULL;
+
+			/// <summary>
+			///		记录随机访问点的流。
+			/// </summary>
+			uint16_t rap_pid = ts::PID_NULL;
+			uint8_t rap_stream_type = ts::ST_NULL;
+
+			int64_t last_time_entry_pcr = -1;
+		};
+
+		shared_ptr<base::Stream> _index_stream;
+		shared_ptr<TsIndex> _index;
+		ts::TimelineDemux _timeline{*_duck};
+		uint64_t _packet_index = 0;
+
+		/// <summary>
+		///		key=service_id
+		/// </summary>
+		std::map<uint16_t, ServiceState> _services;
+
+		/// <summary>
+		///		key=PID, value=service_id. 包含 PMT PID 和记录随机访问点的 PID.
+		/// </summary>
+		std::map<uint16_t, uint16_t> _pmt_pids;
+		std::map<uint16_t, uint16_t> _rap_pids;
+
+		void HandlePatVersionChange(ts::PAT &pat) override;
+		void HandlePmtVersionChange(ts::PMT &pmt, uint16_t source_pid) override;
+
+		/// <summary>
+		///		节目到目前为止的最后一个 PCR. 没有时返回 -1.
+		/// </summary>
+		/// <param name="service"></param>
+		/// <returns></returns>
+		int64_t ServicePcr(ServiceState const &service) const;
+
+		/// <summary>
+		///		流的最后一个 PTS. 没有时返回 -1.
+		/// </summary>
+		/// <param name="pid"></param>
+		/// <returns></returns>
+		int64_t PidPts(uint16_t pid) const;
+
+		void AddEntry(TsIndexEntryType type, uint16_t pid, uint16_t service_id, int64_t pcr, int64_t pts);
+
+	public:
+		/// <summary>
+		///		Time 条目的间隔。单位：毫秒。
+		/// </summary>
+		int64_t _time_interval_in_milliseconds = 1000;
+
+		using ITSPacketConsumer::SendPacket;
+		void SendPacket(ts::TSPacket *packet) override;
+
+		/// <summary>
+		///		冲洗索引流。录制过程中需要让其他进程读到最新的索引时调用。
+		/// </summary>
+		void Flush();
+
+		/// <summary>
+		///		内存中的索引。
+		/// </summary>
+		/// <returns></returns>
+		shared_ptr<TsIndex> Index() const
+		{
+			return _index;
+		}
+	};
+} // namespace video
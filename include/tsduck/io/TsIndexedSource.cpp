@@ -0,0 +1,87 @@
+#include "tsduck/io/TsIndexedSource.h"
+#include <algorithm>
+#include <base/string/define.h>
+
+using namespace video;
+using namespace std;
+
+video::TsIndexedSource::TsIndexedSource(shared_ptr<base::Stream> ts_stream, shared_ptr<TsIndex> index)
+{
+	if (ts_stream == nullptr || index == nullptr)
+	{
+		throw std::invalid_argument{CODE_POS_STR + std::string{"ts_stream 和 index 不能是空指针。"}};
+	}
+
+	_ts_stream = ts_stream;
+	_index = index;
+	_reader = shared_ptr<TSPacketStreamReader>{new TSPacketStreamReader{_ts_stream}};
+}
+
+ITSPacketSource::ReadPacketResult video::TsIndexedSource::ReadPacket(ts::TSPacket &packet)
+{
+	return _reader->ReadPacket(packet);
+}
+
+ITSPacketSource::ReadPacketResult video::TsIndexedSource::ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata)
+{
+	return _reader->ReadPacket(packet, metadata);
+}
+
+void video::TsIndexedSource::SeekToEntry(TsIndexEntry const &entry)
+{
+	uint64_t packet_index = entry.packet_index;
+	TsIndexEntry const *pat = _index->FindLastBefore(TsIndexEntryType::Pat, 0xFFFF, entry.packet_index);
+	if (pat != nullptr)
+	{
+		packet_index = std::min(packet_index, pat->packet_index);
+	}
+
+	TsIndexEntry const *pmt = _index->FindLastBefore(TsIndexEntryType::Pmt, entry.service_id, entry.packet_index);
+	if (pmt != nullptr)
+	{
+		packet_index = std::min(packet_index, pmt->packet_index);
+	}
+
+	_ts_stream->SetPosition(static_cast<int64_t>(packet_index * _index->PacketSize()));
+
+	// 读取器内部有缓冲，定位后要重新创建。
+	_reader = shared_ptr<TSPacketStreamReader>{new TSPacketStreamReader{_ts_stream}};
+}
+
+bool video::TsIndexedSource::SeekToPts(uint16_t service_id, int64_t pts)
+{
+	TsIndexEntry const *entry = _index->FindRandomAccessPointByPts(service_id, pts);
+	if (entry == nullptr)
+	{
+		return false;
+	}
+
+	SeekToEntry(*entry);
+	return true;
+}
+
+bool video::TsIndexedSource::SeekToTime(int64_t millisecond, uint16_t service_id)
+{
+	// 两者对 0xFFFF 的解析一致，用的是同一个节目的时钟。
+	int64_t first_pcr = _index->FirstPcr(service_id);
+	if (first_pcr < 0)
+	{
+		return false;
+	}
+
+	int64_t pcr = first_pcr + millisecond * (ts::SYSTEM_CLOCK_FREQ / 1000);
+	TsIndexEntry const *entry = _index->FindRandomAccessPointByPcr(service_id, pcr);
+	if (entry == nullptr)
+	{
+		return false;
+	}
+
+	SeekToEntry(*entry);
+	return true;
+}
+
+void video::TsIndexedSource::Rewind()
+{
+	_ts_stream->SetPosition(0);
+	_reader = shared_ptr<TSPacketStreamReader>{new TSPacketStreamReader{_ts_stream}};
+}
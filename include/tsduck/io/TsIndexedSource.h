@@ -0,0 +1,63 @@
+#pragma once
+#include <base/stream/Stream.h>
+#include <tsduck/interface/ITSPacketSource.h>
+#include <tsduck/io/TSPacketStreamReader.h>
+#include <tsduck/io/TsIndex.h>
+
+namespace video
+{
+	/// <summary>
+	///		借助 TsIndex 在 ts 文件中定位的源。不定位时与 TSPacketStreamReader 相同，从文件开头读。
+	///
+	///		定位到随机访问点时，实际从它之前最后一个 PAT 和节目的最后一个 PMT 中较早的位置开始读，
+	///		这样下游先收到表格，再收到随机访问点。
+	///		文件流必须支持 SetPosition.
+	/// </summary>
+	class TsIndexedSource :
+		public ITSPacketSource
+	{
+	public:
+		/// <summary>
+		///
+		/// </summary>
+		/// <param name="ts_stream">ts 文件。</param>
+		/// <param name="index">ts 文件的索引。</param>
+		TsIndexedSource(shared_ptr<base::Stream> ts_stream, shared_ptr<TsIndex> index);
+
+	private:
+		shared_ptr<base::Stream> _ts_stream;
+		shared_ptr<TsIndex> _index;
+		shared_ptr<TSPacketStreamReader> _reader;
+
+		/// <summary>
+		///		定位到随机访问点 entry 前面的表格处。
+		/// </summary>
+		/// <param name="entry"></param>
+		void SeekToEntry(TsIndexEntry const &entry);
+
+	public:
+		ReadPacketResult ReadPacket(ts::TSPacket &packet) override;
+		ReadPacketResult ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata) override;
+
+		/// <summary>
+		///		定位到 PTS 不大于 pts 的最后一个随机访问点。
+		/// </summary>
+		/// <param name="service_id">节目。为 0xFFFF 时使用索引中第一个有随机访问点的节目。</param>
+		/// <param name="pts">已展开回绕的 PTS. 文件开头的 PTS 就是它在流中的原始值。</param>
+		/// <returns>索引中没有合适的随机访问点时返回 false，读取位置不变。</returns>
+		bool SeekToPts(uint16_t service_id, int64_t pts);
+
+		/// <summary>
+		///		定位到距离节目在文件中的第一个 PCR millisecond 毫秒之前的最后一个随机访问点。
+		/// </summary>
+		/// <param name="millisecond"></param>
+		/// <param name="service_id">节目。为 0xFFFF 时使用索引中第一个有 PCR 的随机访问点的节目。</param>
+		/// <returns>索引中没有合适的随机访问点时返回 false，读取位置不变。</returns>
+		bool SeekToTime(int64_t millisecond, uint16_t service_id = 0xFFFF);
+
+		/// <summary>
+		///		回到文件开头。
+		/// </summary>
+		void Rewind();
+	};
+} // namespace video
@@ -74,6 +74,12 @@ public:
 		}
 	}
 
+	void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override
+	{
+		MetadataScope scope{*this, metadata};
+		SendPacket(packet);
+	}
+
 	/// <summary>
 	///		输入端 PAT 发生变化后，需要调用此方法通知本对象，这样才能移除过期的服务。
 	/// </summary>
@@ -87,6 +93,56 @@ public:
 		}
 	}
 };
+
+/// <summary>
+///		输入端口。给送入的包的元数据加上端口序号作为标签，然后送给该端口的第一级。
+///		标签加在元数据的副本上，不修改调用者的元数据。同一个源送给多个端口时，各端口的标签互不覆盖。
+/// </summary>
+class AutoChangeIdProgramMux::InputPort :
+	public ITSPacketConsumer
+{
+private:
+	shared_ptr<ITSPacketConsumer> _first_stage;
+	size_t _label = 0;
+
+	/// <summary>
+	///		送给第一级的元数据：送入的元数据的副本，加上本端口的标签。
+	/// </summary>
+	ts::TSPacketMetadata _metadata;
+
+public:
+	InputPort(shared_ptr<ITSPacketConsumer> first_stage, size_t label)
+		: _first_stage(first_stage),
+		  _label(label)
+	{
+	}
+
+	using ITSPacketConsumer::SendPacket;
+
+	void SendPacket(ts::TSPacket *packet) override
+	{
+		SendPacket(packet, nullptr);
+	}
+
+	void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override
+	{
+		if (metadata == nullptr)
+		{
+			_metadata.reset();
+		}
+		else
+		{
+			_metadata = *metadata;
+		}
+
+		if (_label < ts::TSPacketLabelSet::SIZE)
+		{
+			_metadata.setLabel(_label);
+		}
+
+		_first_stage->SendPacket(packet, &_metadata);
+	}
+};
 #pragma endregion
 
 
@@ -122,7 +178,7 @@ shared_ptr<ITSPacketConsumer> video::AutoChangeIdProgramMux::GetNewInputPort()
 	};
 
 	auto_service_id_changer->AddTsPacketConsumer(auto_pid_changer);
-	return auto_service_id_changer;
+	return shared_ptr<ITSPacketConsumer>{new InputPort{auto_service_id_changer, _input_port_count++}};
 }
 
 void video::AutoChangeIdProgramMux::AddTsPacketConsumer(shared_ptr<ITSPacketConsumer> packet_comsumer)
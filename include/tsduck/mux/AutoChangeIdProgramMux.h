@@ -38,12 +38,22 @@ namespace video
 		class ProgramMux;
 		shared_ptr<ProgramMux> _program_mux;
 
+		class InputPort;
+
+		/// <summary>
+		///		已经获取的输入端口数。用作下一个输入端口的序号。
+		/// </summary>
+		size_t _input_port_count = 0;
+
 	public:
 		/// <summary>
 		///		获取一个输入端，可以向此输入端输入一路 ts。每个 ts 必须独自占有一个输入端。
 		///
 		///		获取到输入端口后需要自行保管，如果丢失智能指针，将会无法找回，这会导致输出节目中原本属于该 ts 的流直接中断，
 		///		再次调用 GetNewInputPort 获取输入端口后，也只是让输出多了几个 PID 的流而已，无法从丢失的流继续。
+		///
+		///		输入端口按获取的顺序从 0 开始编号。从输入端口送入的包的元数据会加上与端口序号相同的标签，
+		///		下游可以据此区分包来自哪个输入端口。序号大于等于 ts::TSPacketLabelSet::SIZE 的端口不加标签。
 		/// </summary>
 		/// <returns></returns>
 		shared_ptr<ITSPacketConsumer> GetNewInputPort();
@@ -15,6 +15,19 @@ private:
 	uint8_t _table_version_offset = 0;
 	ts::PIDSet _streams_pid_set;
 
+	/// <summary>
+	///		正在处理的包的元数据。表格包继承触发它的包的元数据。
+	/// </summary>
+	ts::TSPacketMetadata *_metadata = nullptr;
+
+	void SendTablePackets(std::vector<ts::TSPacket> packets)
+	{
+		for (auto &packet : packets)
+		{
+			_ts_packet_queue.SendPacket(&packet, _metadata);
+		}
+	}
+
 public:
 	void HandlePAT(ts::BinaryTable const &table) override
 	{
@@ -24,7 +37,7 @@ public:
 		ResetListenedPids();
 		ListenOnPmtPids(pat);
 		pat.version += _table_version_offset;
-		_ts_packet_queue.SendPacket(TableOperator::ToTsPacket(*_duck, pat));
+		SendTablePackets(TableOperator::ToTsPacket(*_duck, pat));
 		_demux->reset();
 	}
 
@@ -34,7 +47,7 @@ public:
 		pmt.deserialize(*_duck, table);
 		_streams_pid_set << pmt;
 		pmt.version += _table_version_offset;
-		_ts_packet_queue.SendPacket(TableOperator::ToTsPacket(*_duck, pmt, table.sourcePID()));
+		SendTablePackets(TableOperator::ToTsPacket(*_duck, pmt, table.sourcePID()));
 		_demux->reset();
 	}
 
@@ -43,7 +56,7 @@ public:
 		ts::SDT sdt;
 		sdt.deserialize(*_duck, table);
 		sdt.version += _table_version_offset;
-		_ts_packet_queue.SendPacket(TableOperator::ToTsPacket(*_duck, sdt));
+		SendTablePackets(TableOperator::ToTsPacket(*_duck, sdt));
 		_demux->reset();
 	}
 
@@ -52,7 +65,7 @@ public:
 		if (packet == nullptr)
 		{
 			// 冲洗内部队列
-			_ts_packet_queue.SendPacket(packet);
+			_ts_packet_queue.SendPacket(packet, nullptr);
 			return;
 		}
 
@@ -71,7 +84,7 @@ public:
 			{
 				if (_streams_pid_set[packet->getPID()])
 				{
-					_ts_packet_queue.SendPacket(packet);
+					_ts_packet_queue.SendPacket(packet, _metadata);
 				}
 
 				break;
@@ -79,11 +92,24 @@ public:
 		}
 	}
 
+	void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override
+	{
+		ts::TSPacketMetadata *saved = _metadata;
+		_metadata = metadata;
+		SendPacket(packet);
+		_metadata = saved;
+	}
+
 	ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet) override
 	{
 		return _ts_packet_queue.ReadPacket(packet);
 	}
 
+	ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata) override
+	{
+		return _ts_packet_queue.ReadPacket(packet, metadata);
+	}
+
 	void IncreaseVersion()
 	{
 		cout << "递增版本号" << endl;
@@ -93,6 +119,230 @@ public:
 		_demux->reset();
 	}
 };
+
+/// <summary>
+///		包装一个 ITSPacketSource，在构造时预先读出若干个包缓存起来。
+///		读完缓存的包后继续从被包装的 ITSPacketSource 中读取。
+/// </summary>
+class JoinedTsStream::PrefetchedSource :
+	public ITSPacketSource
+{
+private:
+	shared_ptr<ITSPacketSource> _source;
+	std::vector<ts::TSPacket> _packets;
+	std::vector<ts::TSPacketMetadata> _metadata;
+	size_t _position = 0;
+
+	/// <summary>
+	///		预读时 _source 返回的非 Success 结果。_source 在预读时结束后会被置为空指针。
+	/// </summary>
+	ITSPacketSource::ReadPacketResult _end_result = ITSPacketSource::ReadPacketResult::Success;
+
+public:
+	PrefetchedSource(shared_ptr<ITSPacketSource> source, size_t packet_count)
+		: _source(source)
+	{
+		_packets.reserve(packet_count);
+		_metadata.reserve(packet_count);
+		ts::TSPacket packet;
+		ts::TSPacketMetadata metadata;
+		while (_packets.size() < packet_count)
+		{
+			_end_result = _source->ReadPacket(packet, metadata);
+			if (_end_result != ITSPacketSource::ReadPacketResult::Success)
+			{
+				_source = nullptr;
+				break;
+			}
+
+			_packets.push_back(packet);
+			_metadata.push_back(metadata);
+		}
+	}
+
+	ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet) override
+	{
+		ts::TSPacketMetadata metadata;
+		return ReadPacket(packet, metadata);
+	}
+
+	ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata) override
+	{
+		if (_position < _packets.size())
+		{
+			packet = _packets[_position];
+			metadata = _metadata[_position];
+			_position++;
+			if (_position == _packets.size())
+			{
+				// 缓存已读完，释放内存。
+				_packets = std::vector<ts::TSPacket>{};
+				_metadata = std::vector<ts::TSPacketMetadata>{};
+				_position = 0;
+			}
+
+			return ITSPacketSource::ReadPacketResult::Success;
+		}
+
+		if (_source == nullptr)
+		{
+			return _end_result;
+		}
+
+		return _source->ReadPacket(packet, metadata);
+	}
+};
+
+/// <summary>
+///		修改 PCR、PTS、DTS，使拼接起来的各个 ITSPacketSource 的时间轴连续。
+///		偏移量以 27MHz 为单位，对 ts::PCR_SCALE 取模。
+/// </summary>
+class JoinedTsStream::TimelineRestamper
+{
+private:
+	/// <summary>
+	///		超过此间隔的 PCR 跳变需要设置 discontinuity_indicator. ISO 13818-1 规定 PCR 的间隔不超过 100 毫秒。
+	/// </summary>
+	static constexpr uint64_t MAX_PCR_GAP = ts::SYSTEM_CLOCK_FREQ / 10;
+
+	/// <summary>
+	///		还没有测得 PCR 间隔时，拼接处使用的间隔，40 毫秒。
+	/// </summary>
+	static constexpr uint64_t DEFAULT_PCR_GAP = ts::SYSTEM_CLOCK_FREQ / 25;
+
+	/// <summary>
+	///		以 PTS、DTS 确定偏移量时，拼接处使用的间隔，一帧，40 毫秒。
+	/// </summary>
+	static constexpr uint64_t DEFAULT_DTS_GAP = ts::SYSTEM_CLOCK_SUBFREQ / 25;
+
+	uint64_t _offset = 0;
+
+	/// <summary>
+	///		切换了 ITSPacketSource，还没有确定新的偏移量。
+	/// </summary>
+	bool _offset_pending = false;
+
+	/// <summary>
+	///		最后输出的 PCR，修改后的值。
+	/// </summary>
+	uint64_t _last_pcr = ts::INVALID_PCR;
+
+	/// <summary>
+	///		最近测得的相邻 PCR 的间隔。
+	/// </summary>
+	uint64_t _pcr_gap = DEFAULT_PCR_GAP;
+
+	/// <summary>
+	///		最后输出的最大的 DTS（没有 DTS 时为 PTS），修改后的值。
+	/// </summary>
+	uint64_t _last_dts = ts::INVALID_DTS;
+
+	/// <summary>
+	///		切换后还没有检查过 PCR 连续性的 PID.
+	/// </summary>
+	ts::PIDSet _pcr_pids_to_check;
+
+	/// <summary>
+	///		每个 PID 最后输出的 PCR，修改后的值。用来在拼接处检查是否需要设置 discontinuity_indicator.
+	/// </summary>
+	std::map<uint16_t, uint64_t> _last_pcr_by_pid;
+
+public:
+	/// <summary>
+	///		切换到了下一个 ITSPacketSource.
+	/// </summary>
+	void OnSourceChanged()
+	{
+		// 第一个 ITSPacketSource 不需要偏移。
+		if (_last_pcr != ts::INVALID_PCR || _last_dts != ts::INVALID_DTS)
+		{
+			_offset_pending = true;
+			_pcr_pids_to_check.set();
+		}
+	}
+
+	void Restamp(ts::TSPacket &packet)
+	{
+		if (packet.hasPCR())
+		{
+			RestampPCR(packet);
+		}
+
+		if (packet.getPUSI() && (packet.hasPTS() || packet.hasDTS()))
+		{
+			RestampPTSAndDTS(packet);
+		}
+	}
+
+private:
+	void RestampPCR(ts::TSPacket &packet)
+	{
+		uint64_t pcr = packet.getPCR();
+		if (_offset_pending)
+		{
+			_offset_pending = false;
+			_offset = _last_pcr == ts::INVALID_PCR
+				? 0
+				: (_last_pcr + _pcr_gap + ts::PCR_SCALE - pcr) % ts::PCR_SCALE;
+		}
+		else if (_last_pcr != ts::INVALID_PCR)
+		{
+			uint64_t gap = ts::DiffPCR(_last_pcr, (pcr + _offset) % ts::PCR_SCALE);
+			if (gap > 0 && gap <= MAX_PCR_GAP)
+			{
+				_pcr_gap = gap;
+			}
+		}
+
+		pcr = (pcr + _offset) % ts::PCR_SCALE;
+		packet.setPCR(pcr);
+
+		uint16_t pid = packet.getPID();
+		if (_pcr_pids_to_check.test(pid))
+		{
+			_pcr_pids_to_check.reset(pid);
+			auto it = _last_pcr_by_pid.find(pid);
+			if (it != _last_pcr_by_pid.end() && ts::DiffPCR(it->second, pcr) > MAX_PCR_GAP)
+			{
+				// 倒退或跳变过大，无法做到连续。
+				packet.setDiscontinuityIndicator();
+			}
+		}
+
+		_last_pcr_by_pid[pid] = pcr;
+		_last_pcr = pcr;
+	}
+
+	void RestampPTSAndDTS(ts::TSPacket &packet)
+	{
+		uint64_t dts = packet.hasDTS() ? packet.getDTS() : packet.getPTS();
+		if (_offset_pending)
+		{
+			// PES 先于 PCR 出现，用 DTS 确定偏移量。
+			_offset_pending = false;
+			_offset = _last_dts == ts::INVALID_DTS
+				? 0
+				: ((_last_dts + DEFAULT_DTS_GAP + ts::PTS_DTS_SCALE - dts) & ts::PTS_DTS_MASK) * ts::SYSTEM_CLOCK_SUBFACTOR;
+		}
+
+		uint64_t offset = _offset / ts::SYSTEM_CLOCK_SUBFACTOR;
+		if (packet.hasPTS())
+		{
+			packet.setPTS((packet.getPTS() + offset) & ts::PTS_DTS_MASK);
+		}
+
+		if (packet.hasDTS())
+		{
+			packet.setDTS((packet.getDTS() + offset) & ts::PTS_DTS_MASK);
+		}
+
+		dts = (dts + offset) & ts::PTS_DTS_MASK;
+		if (_last_dts == ts::INVALID_DTS || ts::SequencedPTS(_last_dts, dts))
+		{
+			_last_dts = dts;
+		}
+	}
+};
 #pragma endregion
 
 
@@ -101,7 +351,22 @@ JoinedTsStream::JoinedTsStream()
 	_table_version_changer = shared_ptr<TableVersionChanger>{ new TableVersionChanger{} };
 }
 
+JoinedTsStream::~JoinedTsStream()
+{
+	// 后台任务引用了本对象，必须等待它结束。
+	if (_prefetch_future.valid())
+	{
+		_prefetch_future.wait();
+	}
+}
+
 ITSPacketSource::ReadPacketResult video::JoinedTsStream::ReadPacket(ts::TSPacket &packet)
+{
+	ts::TSPacketMetadata metadata;
+	return ReadPacket(packet, metadata);
+}
+
+ITSPacketSource::ReadPacketResult video::JoinedTsStream::ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata)
 {
 	while (1)
 	{
@@ -113,7 +378,7 @@ ITSPacketSource::ReadPacketResult video::JoinedTsStream::ReadPacket(ts::TSPacket
 		}
 
 		// 到这里说明 _current_ts_packet_source 不为空
-		ITSPacketSource::ReadPacketResult read_packet_result = _current_ts_packet_source->ReadPacket(packet);
+		ITSPacketSource::ReadPacketResult read_packet_result = _current_ts_packet_source->ReadPacket(packet, metadata);
 		if (read_packet_result != ITSPacketSource::ReadPacketResult::Success)
 		{
 			// 读取失败，进入下一轮循环
@@ -121,10 +386,15 @@ ITSPacketSource::ReadPacketResult video::JoinedTsStream::ReadPacket(ts::TSPacket
 			continue;
 		}
 
-		_table_version_changer->SendPacket(&packet);
-		read_packet_result = _table_version_changer->ReadPacket(packet);
+		_table_version_changer->SendPacket(&packet, &metadata);
+		read_packet_result = _table_version_changer->ReadPacket(packet, metadata);
 		if (read_packet_result == ITSPacketSource::ReadPacketResult::Success)
 		{
+			if (_timeline_restamper != nullptr)
+			{
+				_timeline_restamper->Restamp(packet);
+			}
+
 			return ITSPacketSource::ReadPacketResult::Success;
 		}
 	}
@@ -137,9 +407,44 @@ void video::JoinedTsStream::AddSource(shared_ptr<ITSPacketSource> source)
 		throw std::invalid_argument{ "source 不能是空指针" };
 	}
 
+	std::lock_guard l{_ts_packet_source_queue_lock};
 	_ts_packet_source_queue.Enqueue(source);
 }
 
+size_t video::JoinedTsStream::SourceCount()
+{
+	std::lock_guard l{_ts_packet_source_queue_lock};
+	return _ts_packet_source_queue.Count();
+}
+
+shared_ptr<ITSPacketSource> video::JoinedTsStream::TryDequeueSource()
+{
+	std::lock_guard l{_ts_packet_source_queue_lock};
+	if (_ts_packet_source_queue.Count() == 0)
+	{
+		return nullptr;
+	}
+
+	return _ts_packet_source_queue.Dequeue();
+}
+
+void video::JoinedTsStream::EnablePrefetch(size_t packet_count)
+{
+	_prefetch_packet_count = packet_count;
+}
+
+void video::JoinedTsStream::EnableContinuousTimeline(bool enable)
+{
+	if (!enable)
+	{
+		_timeline_restamper = nullptr;
+	}
+	else if (_timeline_restamper == nullptr)
+	{
+		_timeline_restamper = shared_ptr<TimelineRestamper>{new TimelineRestamper{}};
+	}
+}
+
 /// <summary>
 ///		尝试获取下一个 ITSPacketSource。
 ///		需要先将 _current_ts_packet_source 赋值为空指针，否则检测到 _current_ts_packet_source
@@ -154,16 +459,65 @@ void video::JoinedTsStream::TryGetNextSourceIfNullAndIncreaseVersion()
 
 	try
 	{
-		if (_ts_packet_source_queue.Count() == 0 && _on_ts_packet_source_list_exhausted != nullptr)
+		if (_prefetch_future.valid())
+		{
+			_current_ts_packet_source = _prefetch_future.get();
+		}
+
+		if (_current_ts_packet_source == nullptr)
 		{
-			_on_ts_packet_source_list_exhausted();
+			// 没有预读，或者预读任务取不到下一个 ITSPacketSource. 预读之后可能又有 ITSPacketSource
+			// 入队了，所以预读失败时也要马上走一遍同步流程，再给回调一次机会。
+			if (SourceCount() == 0 && _on_ts_packet_source_list_exhausted != nullptr)
+			{
+				_on_ts_packet_source_list_exhausted();
+			}
+
+			_current_ts_packet_source = TryDequeueSource();
+			if (_current_ts_packet_source == nullptr)
+			{
+				return;
+			}
 		}
 
-		_current_ts_packet_source = _ts_packet_source_queue.Dequeue();
 		_table_version_changer->IncreaseVersion();
+		if (_timeline_restamper != nullptr)
+		{
+			_timeline_restamper->OnSourceChanged();
+		}
+
+		StartPrefetch();
 	}
 	catch (...)
 	{
 		cout << CODE_POS_STR << "退队失败，将结束包流" << endl;
 	}
 }
+
+void video::JoinedTsStream::StartPrefetch()
+{
+	if (_prefetch_packet_count == 0)
+	{
+		return;
+	}
+
+	size_t packet_count = _prefetch_packet_count;
+	_prefetch_future = std::async(
+		std::launch::async,
+		[this, packet_count]() -> shared_ptr<ITSPacketSource>
+		{
+			if (SourceCount() == 0 && _on_ts_packet_source_list_exhausted != nullptr)
+			{
+				_on_ts_packet_source_list_exhausted();
+			}
+
+			// 只在退队时加锁，打开和预读不阻塞 AddSource.
+			shared_ptr<ITSPacketSource> source = TryDequeueSource();
+			if (source == nullptr)
+			{
+				return nullptr;
+			}
+
+			return shared_ptr<ITSPacketSource>{new PrefetchedSource{source, packet_count}};
+		});
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include <base/string/define.h>
 #include <functional>
+#include <future>
+#include <mutex>
 #include <tsduck/container/TSPacketQueue.h>
 #include <tsduck/handler/TableHandler.h>
 #include <tsduck/interface/ITSPacketConsumer.h>
@@ -12,10 +14,17 @@ namespace video
 	{
 	public:
 		JoinedTsStream();
+		~JoinedTsStream();
 
 	private:
 		base::Queue<shared_ptr<ITSPacketSource>> _ts_packet_source_queue;
 
+		/// <summary>
+		///		保护 _ts_packet_source_queue. AddSource 可能在调用者的线程中执行，同时预读任务在后台线程中退队。
+		///		调用 _on_ts_packet_source_list_exhausted 时不能持有此锁，因为回调会调用 AddSource.
+		/// </summary>
+		std::mutex _ts_packet_source_queue_lock;
+
 		/// <summary>
 		///		当前正在被读取的 ITSPacketSource。
 		/// </summary>
@@ -24,6 +33,21 @@ namespace video
 		class TableVersionChanger;
 		shared_ptr<TableVersionChanger> _table_version_changer;
 
+		class PrefetchedSource;
+
+		class TimelineRestamper;
+		shared_ptr<TimelineRestamper> _timeline_restamper;
+
+		/// <summary>
+		///		预读的包数。为 0 表示不预读。
+		/// </summary>
+		size_t _prefetch_packet_count = 0;
+
+		/// <summary>
+		///		后台线程中正在打开和预读的下一个 ITSPacketSource。
+		/// </summary>
+		std::future<shared_ptr<ITSPacketSource>> _prefetch_future;
+
 	public:
 		/// <summary>
 		///		当一个 ITSPacketSource 对象无包可读，准备取出下一个 ITSPacketSource 时，
@@ -43,8 +67,16 @@ namespace video
 		ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet) override;
 
 		/// <summary>
-		///		向队列添加一个 ITSPacketSource 对象。不要在 _on_ts_packet_source_list_exhausted
-		///		回调以外的地方调用本方法，内部队列不是线程安全的，不能边退队边入队。
+		///		读取包和元数据。元数据来自当前的 ITSPacketSource，重新生成的表格包继承触发它的包的元数据。
+		/// </summary>
+		/// <param name="packet"></param>
+		/// <param name="metadata"></param>
+		/// <returns></returns>
+		ITSPacketSource::ReadPacketResult ReadPacket(ts::TSPacket &packet, ts::TSPacketMetadata &metadata) override;
+
+		/// <summary>
+		///		向队列添加一个 ITSPacketSource 对象。可以在任何线程中调用，包括 _on_ts_packet_source_list_exhausted
+		///		回调和启用预读后正在运行的后台任务期间。
 		///
 		///		送进来的 ITSPacketSource 对象的 ReadPacket 方法返回任何非 ITSPacketSource::ReadPacketResult::Success
 		///		的值都会丢弃这个 ITSPacketSource，去从队列中取出下一个 ITSPacketSource。
@@ -52,7 +84,55 @@ namespace video
 		/// <param name="source"></param>
 		void AddSource(shared_ptr<ITSPacketSource> source);
 
+		/// <summary>
+		///		启用预读。每当切换到一个 ITSPacketSource 后，就在后台线程中取出下一个 ITSPacketSource，
+		///		从中预先读出 packet_count 个包，其中包括开头的 PAT、PMT 等表格。当前的 ITSPacketSource
+		///		结束时直接切换到预读好的 ITSPacketSource，打开文件和读取开头的数据不会造成输出中断。
+		///
+		///		启用预读后，_on_ts_packet_source_list_exhausted 会在后台线程中被调用，调用的时机也会
+		///		提前到上一个 ITSPacketSource 刚开始被读取的时候。回调中除了 AddSource 不要访问本对象，
+		///		回调不会与 ReadPacket 同时执行。预读时队列为空的话，当前的 ITSPacketSource
+		///		结束时还会在 ReadPacket 的线程中再调用一次回调。
+		///
+		///		应该在开始读取前调用。
+		/// </summary>
+		/// <param name="packet_count">预读的包数。为 0 表示禁用预读。</param>
+		void EnablePrefetch(size_t packet_count);
+
+		/// <summary>
+		///		启用或禁用连续时间轴。
+		///
+		///		启用后，每次切换 ITSPacketSource 时，根据上一个 ITSPacketSource 输出的最后一个 PCR 和
+		///		PTS/DTS 计算一个偏移量，就地修改后续包的 PCR 和 PES 头部的 PTS、DTS，使拼接后的时间轴连续。
+		///		同一个 ITSPacketSource 的所有 PID 使用同一个偏移量，所以 PCR 与 PTS、DTS 之间的关系保持不变。
+		///		偏移量由新的 ITSPacketSource 中第一个出现的 PCR（或者 PTS、DTS）确定。
+		///
+		///		只有在拼接处某个 PID 的 PCR 仍然倒退或者跳变超过 100 毫秒时，才会在该包设置 discontinuity_indicator.
+		///
+		///		假设每个 ITSPacketSource 内只有一条时间轴，即单节目流，或者各节目共用同一个时钟的多节目流。
+		///		应该在开始读取前调用。
+		/// </summary>
+		/// <param name="enable"></param>
+		void EnableContinuousTimeline(bool enable);
+
 	private:
 		void TryGetNextSourceIfNullAndIncreaseVersion();
+
+		/// <summary>
+		///		加锁取得 _ts_packet_source_queue 中的元素个数。
+		/// </summary>
+		/// <returns></returns>
+		size_t SourceCount();
+
+		/// <summary>
+		///		加锁从 _ts_packet_source_queue 退队。队列为空时返回空指针。
+		/// </summary>
+		/// <returns></returns>
+		shared_ptr<ITSPacketSource> TryDequeueSource();
+
+		/// <summary>
+		///		如果启用了预读，启动后台任务打开并预读下一个 ITSPacketSource.
+		/// </summary>
+		void StartPrefetch();
 	};
 }
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "tsduck/mux/MptsSplitter.h"
+#include <tsduck/TableOperator.h>
+
+using namespace video;
+using namespace std;
+
+void video::MptsSplitter::Output::Send(std::vector<ts::TSPacket> const &packets, uint8_t &cc)
+{
+	for (ts::TSPacket packet : packets)
+	{
+		packet.setCC(cc);
+		cc = (cc + 1) & ts::CC_MASK;
+		SendPacketToEachConsumer(&packet);
+	}
+}
+
+video::MptsSplitter::MptsSplitter()
+{
+	_routes.resize(ts::PID_MAX);
+}
+
+shared_ptr<IPipeTsPacketSource> video::MptsSplitter::GetOutput(uint16_t service_id)
+{
+	auto it = _output_map.find(service_id);
+	if (it != _output_map.end())
+	{
+		return it->second;
+	}
+
+	shared_ptr<Output> output{new Output{}};
+	output->_service_id = service_id;
+	_output_map[service_id] = output;
+	if (_has_pat)
+	{
+		UpdatePat(*output);
+	}
+
+	if (_has_sdt)
+	{
+		UpdateSdt(*output);
+	}
+
+	RebuildRoutes();
+	return output;
+}
+
+bool video::MptsSplitter::RemoveOutput(uint16_t service_id)
+{
+	if (_output_map.erase(service_id) == 0)
+	{
+		return false;
+	}
+
+	RebuildRoutes();
+	return true;
+}
+
+void video::MptsSplitter::RebuildRoutes()
+{
+	for (std::vector<Output *> &route : _routes)
+	{
+		route.clear();
+	}
+
+	for (auto &pair : _output_map)
+	{
+		Output *output = pair.second.get();
+		ts::PIDSet pid_set;
+		for (uint16_t pid = 0x01; pid < 0x20; pid++)
+		{
+			pid_set[pid] = 1;
+		}
+
+		pid_set[0] = 0;
+		pid_set[0x11] = 0;
+		if (output->_pmt_pid != ts::PID_NULL)
+		{
+			pid_set[output->_pmt_pid] = 1;
+		}
+
+		if (output->_has_pmt)
+		{
+			pid_set << output->_pmt;
+		}
+
+		for (uint16_t pid = 0; pid < ts::PID_MAX; pid++)
+		{
+			if (pid_set[pid])
+			{
+				_routes[pid].push_back(output);
+			}
+		}
+	}
+}
+
+void video::MptsSplitter::UpdatePat(Output &output)
+{
+	ts::PAT pat{_pat};
+	pat.pmts.clear();
+	output._pat_packets.clear();
+
+	auto it = _pat.pmts.find(output._service_id);
+	if (it == _pat.pmts.end())
+	{
+		// 节目不存在了，发送空的 PAT.
+		output._pmt_pid = ts::PID_NULL;
+		output._has_pmt = false;
+	}
+	else
+	{
+		pat.pmts[it->first] = it->second;
+		if (output._pmt_pid != it->second)
+		{
+			output._pmt_pid = it->second;
+			output._has_pmt = false;
+		}
+	}
+
+	output._pat_packets = TableOperator::ToTsPacket(*_duck, pat);
+}
+
+void video::MptsSplitter::UpdateSdt(Output &output)
+{
+	ts::SDT sdt{_sdt};
+	sdt.services.clear();
+	auto it = _sdt.services.find(output._service_id);
+	if (it != _sdt.services.end())
+	{
+		sdt.services[it->first] = it->second;
+	}
+
+	output._sdt_packets = TableOperator::ToTsPacket(*_duck, sdt);
+}
+
+void video::MptsSplitter::HandlePAT(ts::BinaryTable const &table)
+{
+	ts::PAT pat;
+	pat.deserialize(*_duck, table);
+	if (!pat.isValid())
+	{
+		return;
+	}
+
+	_pat = pat;
+	_has_pat = true;
+	ResetListenedPids();
+	ListenOnPmtPids(_pat);
+	for (auto &pair : _output_map)
+	{
+		UpdatePat(*pair.second);
+	}
+
+	RebuildRoutes();
+}
+
+void video::MptsSplitter::HandlePMT(ts::BinaryTable const &table)
+{
+	ts::PMT pmt;
+	pmt.deserialize(*_duck, table);
+	if (!pmt.isValid())
+	{
+		return;
+	}
+
+	auto it = _output_map.find(pmt.service_id);
+	if (it == _output_map.end())
+	{
+		return;
+	}
+
+	Output &output = *it->second;
+	output._pmt = pmt;
+	output._has_pmt = true;
+	RebuildRoutes();
+}
+
+void video::MptsSplitter::HandleSDT(ts::BinaryTable const &table)
+{
+	ts::SDT sdt;
+	sdt.deserialize(*_duck, table);
+	if (!sdt.isValid())
+	{
+		return;
+	}
+
+	_sdt = sdt;
+	_has_sdt = true;
+	for (auto &pair : _output_map)
+	{
+		UpdateSdt(*pair.second);
+	}
+}
+
+void video::MptsSplitter::SendPacket(ts::TSPacket *packet)
+{
+	_demux->feedPacket(*packet);
+	uint16_t pid = packet->getPID();
+	if (pid == ts::PID_PAT || pid == ts::PID_SDT)
+	{
+		if (!packet->getPUSI())
+		{
+			return;
+		}
+
+		// 输入的 PAT、SDT 每开始一个段，就向各个输出端口发送一次重新生成的表格。
+		for (auto &pair : _output_map)
+		{
+			Output &output = *pair.second;
+			if (pid == ts::PID_PAT)
+			{
+				output.Send(output._pat_packets, output._pat_cc);
+			}
+			else
+			{
+				output.Send(output._sdt_packets, output._sdt_cc);
+			}
+		}
+
+		return;
+	}
+
+	std::vector<Output *> const &route = _routes[pid];
+	if (route.size() == 1)
+	{
+		route[0]->Send(packet);
+		return;
+	}
+
+	// 下游可能会修改包，每个输出端口都要有自己的副本。
+	for (Output *output : route)
+	{
+		ts::TSPacket copy = *packet;
+		output->Send(&copy);
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <map>
+#include <tsduck/handler/TableHandler.h>
+#include <tsduck/interface/ITSPacketConsumer.h>
+#include <tsduck/PipeTsPacketSource.h>
+#include <tsSDT.h>
+#include <vector>
+
+namespace video
+{
+	/// <summary>
+	///		将多节目的 ts 一次性拆分成多个单节目的 ts。
+	///
+	///		* 只解析一次 PAT、PMT、SDT，据此建立 PID 到输出端口的路由表，每个包只送给需要它的输出端口。
+	///		  输入的开销与节目数无关。
+	///		* 每个输出端口有自己的 PAT 和 SDT，只包含该节目。每当输入的 PAT、SDT 开始一个新的段时，
+	///		  就向各个输出端口发送一次，所以输出的 PAT、SDT 重复频率与输入相同。
+	///		* PMT 原样转发。PMT 版本变化时会重建该节目的路由。
+	///		* 除了 PAT 和 SDT 以外的 PSI/SI PID（0x01 到 0x1F）发送给所有输出端口。
+	///
+	///		多个 MptsToSpts 串联也能达到同样的效果，但每个 MptsToSpts 都要解析表格，都要过滤所有的包。
+	/// </summary>
+	class MptsSplitter :
+		public ITSPacketConsumer,
+		public TableHandler
+	{
+	private:
+		/// <summary>
+		///		一个节目的输出端口。
+		/// </summary>
+		class Output :
+			public PipeTsPacketSource
+		{
+		public:
+			uint16_t _service_id = 0;
+			uint16_t _pmt_pid = ts::PID_NULL;
+			bool _has_pmt = false;
+			ts::PMT _pmt;
+
+			std::vector<ts::TSPacket> _pat_packets;
+			std::vector<ts::TSPacket> _sdt_packets;
+			uint8_t _pat_cc = 0;
+			uint8_t _sdt_cc = 0;
+
+			void Send(ts::TSPacket *packet)
+			{
+				SendPacketToEachConsumer(packet);
+			}
+
+			/// <summary>
+			///		发送重新生成的表格。会设置连续性计数，否则下游会把重复的包当作冗余包丢弃。
+			/// </summary>
+			/// <param name="packets"></param>
+			/// <param name="cc"></param>
+			void Send(std::vector<ts::TSPacket> const &packets, uint8_t &cc);
+		};
+
+		/// <summary>
+		///		键是 service_id.
+		/// </summary>
+		std::map<uint16_t, shared_ptr<Output>> _output_map;
+
+		/// <summary>
+		///		下标是 PID，元素是需要该 PID 的输出端口。
+		/// </summary>
+		std::vector<std::vector<Output *>> _routes;
+
+		bool _has_pat = false;
+		ts::PAT _pat;
+		bool _has_sdt = false;
+		ts::SDT _sdt;
+
+		void RebuildRoutes();
+		void UpdatePat(Output &output);
+		void UpdateSdt(Output &output);
+
+		// 通过 TableHandler 继承
+		void HandlePAT(ts::BinaryTable const &table) override;
+		void HandlePMT(ts::BinaryTable const &table) override;
+		void HandleSDT(ts::BinaryTable const &table) override;
+
+	public:
+		MptsSplitter();
+
+		/// <summary>
+		///		获取节目 service_id 的输出端口。不存在则创建。
+		///		可以在输入开始之前调用，也可以在输入过程中调用。
+		/// </summary>
+		/// <param name="service_id"></param>
+		/// <returns></returns>
+		shared_ptr<IPipeTsPacketSource> GetOutput(uint16_t service_id);
+
+		/// <summary>
+		///		移除节目 service_id 的输出端口。
+		/// </summary>
+		/// <param name="service_id"></param>
+		/// <returns>存在该输出端口且移除成功则返回 true，否则返回 false。</returns>
+		bool RemoveOutput(uint16_t service_id);
+
+		using ITSPacketConsumer::SendPacket;
+		void SendPacket(ts::TSPacket *packet) override;
+	};
+} // namespace video
@@ -1,27 +1,21 @@
 #include "PidChanger.h"
+#include <tsduck/SectionPatcher.h>
 
 using namespace video;
 
 void PidChanger::HandlePatVersionChange(ts::PAT &pat)
 {
-	// 更改 PMT PID。
-	for (auto &pmt : pat.pmts)
-	{
-		// 看映射表里面有没有该 PMT
-		auto it = _pid_map.find(pmt.second);
-		if (it != _pid_map.end())
-		{
-			// 更改 PAT 中此 PMT 的 PID。
-			pmt.second = it->second;
-		}
-	}
-
-	SendPacketToEachConsumer(TableOperator::ToTsPacket(*_duck, pat));
+	// 直接在原始段上更改 PMT PID，不重新序列化，并沿用原始包的布局。
+	ts::BinaryTable table{CurrentTable(), ts::ShareMode::COPY};
+	SectionPatcher::ChangePmtPidInPat(table, _pid_map);
+	SendPacketToEachConsumer(ToTsPacketLikeCurrentTable(table, ts::PID_PAT));
 }
 
 void PidChanger::HandlePmtVersionChange(ts::PMT &pmt, uint16_t source_pid)
 {
-	ChangeStreamPidAndPcrPid(pmt);
+	// 直接在原始段上更改 PCR PID 和各个流的 PID，流的描述符原样保留。
+	ts::BinaryTable table{CurrentTable(), ts::ShareMode::COPY};
+	SectionPatcher::ChangeStreamPidAndPcrPidInPmt(table, _pid_map);
 
 	// 更改 PMT PID。
 	uint16_t out_pmt_pid = source_pid;
@@ -31,46 +25,12 @@ void PidChanger::HandlePmtVersionChange(ts::PMT &pmt, uint16_t source_pid)
 		out_pmt_pid = it->second;
 	}
 
-	SendPacketToEachConsumer(TableOperator::ToTsPacket(*_duck, pmt, out_pmt_pid));
-}
-
-void PidChanger::ChangeStreamPidAndPcrPid(ts::PMT &pmt)
-{
-	// 更改 PCR PID。
-	auto it = _pid_map.find(pmt.pcr_pid);
-	if (it != _pid_map.end())
-	{
-		// 如果映射表中找得到 PCR PID，将 PCR PID 改掉。
-		pmt.pcr_pid = it->second;
-	}
-
-	// 更改各个流的 PID。
-	ts::PMT backup_pmt{pmt};
-	for (auto &map_pair : _pid_map)
-	{
-		auto it = pmt.streams.find(map_pair.first);
-		if (it != pmt.streams.end())
-		{
-			// 如果该 PMT 里有流的 PID 在映射表里找得到，删除该流。
-			pmt.streams.erase(it);
-		}
-	}
-
-	for (auto &map_pair : _pid_map)
-	{
-		auto it = backup_pmt.streams.find(map_pair.first);
-		if (it != backup_pmt.streams.end())
-		{
-			/* 如果先前备份的 PMT 中有流的 PID 在映射表中找得到，
-			将这个流用映射后的 PID 放入原来的 PMT 中。*/
-			pmt.streams[map_pair.second] = it->second;
-		}
-	}
+	SendPacketToEachConsumer(ToTsPacketLikeCurrentTable(table, out_pmt_pid));
 }
 
 void PidChanger::SendPacket(ts::TSPacket *packet)
 {
-	_demux->feedPacket(*packet);
+	FeedAndRecordPacket(*packet);
 	if (_streams_pid_set[packet->getPID()])
 	{
 		uint16_t src_pid = packet->getPID();
@@ -91,6 +51,44 @@ void PidChanger::SendPacket(ts::TSPacket *packet)
 	}
 }
 
+void PidChanger::SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata)
+{
+	MetadataScope scope{*this, metadata};
+	SendPacket(packet);
+}
+
+void PidChanger::SendPacketWindow(ts::TSPacketWindow &window)
+{
+	BeginWindow(window);
+	for (size_t i = 0; i < window.size(); i++)
+	{
+		ts::TSPacket *packet = window.packet(i);
+		if (!packet)
+		{
+			continue;
+		}
+
+		// 解析出的表格插入到当前包之前。
+		SetWindowPosition(i);
+		FeedAndRecordPacket(*packet);
+		uint16_t src_pid = packet->getPID();
+		if (_streams_pid_set[src_pid])
+		{
+			auto it = _pid_map.find(src_pid);
+			if (it != _pid_map.end())
+			{
+				packet->setPID(it->second);
+			}
+		}
+		else if (src_pid != 0x11)
+		{
+			window.drop(i);
+		}
+	}
+
+	EndWindow();
+}
+
 void PidChanger::SetPidMap(std::map<uint16_t, uint16_t> const &pid_map)
 {
 	auto it = pid_map.find(0);
@@ -32,18 +32,19 @@ namespace video
 	private:
 		std::map<uint16_t, uint16_t> _pid_map;
 
-		/// <summary>
-		///		更改 PMT 中各个流的 PID。
-		/// </summary>
-		/// <param name="pmt"></param>
-		void ChangeStreamPidAndPcrPid(ts::PMT &pmt);
-
 		void HandlePatVersionChange(ts::PAT &pat) override;
 		void HandlePmtVersionChange(ts::PMT &pmt, uint16_t source_pid) override;
 
 	public:
 		using ITSPacketConsumer::SendPacket;
 		void SendPacket(ts::TSPacket *packet) override;
+		void SendPacket(ts::TSPacket *packet, ts::TSPacketMetadata *metadata) override;
+
+		/// <summary>
+		///		就地修改窗口中的包的 PID，不会恢复。不输出的包会被丢弃，表格包会被拼接进窗口。
+		/// </summary>
+		/// <param name="window"></param>
+		void SendPacketWindow(ts::TSPacketWindow &window) override;
 
 		/// <summary>
 		///		调用者可能需要边解析 ts 边设置映射规则。例如，解析完 PAT 后可以先设置
@@ -7,3 +7,15 @@ target_compile_definitions(${ProjectName} PRIVATE TS_NO_RIST=1)
 target_import_src(${ProjectName})
 target_import_base(${ProjectName} PUBLIC)
 target_link_libraries(${ProjectName} PUBLIC winmm Userenv Ws2_32)
+
+# 编译期把 src/dtv 下的 .names 文件生成为常量表，运行时 NamesFile 直接使用，不再读取和解析文件。
+add_executable(tsNamesCompiler tools/tsNamesCompiler.cpp)
+file(GLOB_RECURSE ts_dtv_names_files CONFIGURE_DEPENDS ${CMAKE_CURRENT_SOURCE_DIR}/src/dtv/*.names)
+list(SORT ts_dtv_names_files)
+add_custom_command(
+	OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/tsDtvNamesTables.cpp
+	COMMAND tsNamesCompiler ${CMAKE_CURRENT_BINARY_DIR}/tsDtvNamesTables.cpp tsduck.dtv.names ${ts_dtv_names_files}
+	DEPENDS tsNamesCompiler ${ts_dtv_names_files}
+	VERBATIM
+)
+target_sources(${ProjectName} PRIVATE ${CMAKE_CURRENT_BINARY_DIR}/tsDtvNamesTables.cpp)
@@ -54,11 +54,16 @@ namespace
 		void addExtensionFile(ts::UString const &fileName);
 		void removeExtensionFile(ts::UString const &fileName);
 		void getExtensionFiles(ts::UStringList &fileNames);
+		void addCompiledFile(ts::UString const &fileName, ts::NamesFile::CompiledSection const *sections, size_t count);
+		bool getCompiledFile(ts::UString const &fileName, ts::NamesFile::CompiledSection const *&sections, size_t &count);
 
 	private:
 		std::recursive_mutex _mutex{};                         // Protected access to other fields.
 		std::map<ts::UString, ts::NamesFile const *> _files{}; // Loaded instances by name.
 		ts::UStringList _extFiles{};                           // Additional names files.
+
+		// Names files which are compiled into the executable, by name.
+		std::map<ts::UString, std::pair<ts::NamesFile::CompiledSection const *, size_t>> _compiledFiles{};
 	};
 } // namespace
 
@@ -170,6 +175,27 @@ void AllInstances::getExtensionFiles(ts::UStringList &fileNames)
 	fileNames = _extFiles;
 }
 
+// Register a compiled names file.
+void AllInstances::addCompiledFile(ts::UString const &fileName, ts::NamesFile::CompiledSection const *sections, size_t count)
+{
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+	_compiledFiles[fileName] = std::make_pair(sections, count);
+}
+
+// Get a compiled names file.
+bool AllInstances::getCompiledFile(ts::UString const &fileName, ts::NamesFile::CompiledSection const *&sections, size_t &count)
+{
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+	auto const it = _compiledFiles.find(fileName);
+	if (it == _compiledFiles.end())
+	{
+		return false;
+	}
+	sections = it->second.first;
+	count = it->second.second;
+	return true;
+}
+
 //----------------------------------------------------------------------------
 // Get a common instance of NamesFile for a given configuration file.
 //----------------------------------------------------------------------------
@@ -221,6 +247,15 @@ void ts::NamesFile::UnregisterExtensionFile(UString const &filename)
 	AllInstances::Instance().removeExtensionFile(filename);
 }
 
+//----------------------------------------------------------------------------
+// A class to register names files which are compiled into the executable.
+//----------------------------------------------------------------------------
+
+ts::NamesFile::RegisterCompiledFile::RegisterCompiledFile(UString const &filename, CompiledSection const *sections, size_t count)
+{
+	AllInstances::Instance().addCompiledFile(filename, sections, count);
+}
+
 //----------------------------------------------------------------------------
 // Constructor (load the configuration file).
 //----------------------------------------------------------------------------
@@ -228,8 +263,16 @@ void ts::NamesFile::UnregisterExtensionFile(UString const &filename)
 ts::NamesFile::NamesFile(UString const &fileName, bool mergeExtensions)
 	: _log(CERR)
 {
+	// Use the tables compiled into the executable when there are some.
+	CompiledSection const *compiled = nullptr;
+	size_t compiledCount = 0;
+	if (AllInstances::Instance().getCompiledFile(fileName, compiled, compiledCount))
+	{
+		_log.debug(u"using compiled names file %s", {fileName});
+		loadCompiled(compiled, compiledCount);
+	}
 	// Locate the configuration file.
-	if (_configFile.empty())
+	else if (_configFile.empty())
 	{
 		// Cannot load configuration, names will not be available.
 		_log.error(u"configuration file '%s' not found", {fileName});
@@ -327,6 +370,55 @@ void ts::NamesFile::loadFile(UString const &fileName)
 	strm.close();
 }
 
+//----------------------------------------------------------------------------
+// Load compiled tables into this instance.
+//----------------------------------------------------------------------------
+
+void ts::NamesFile::loadCompiled(CompiledSection const *sections, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		CompiledSection const &compiled(sections[i]);
+		auto const it = _sections.find(compiled.name);
+		if (it == _sections.end())
+		{
+			// New section, use the compiled entries in place.
+			ConfigSection *section = new ConfigSection;
+			CheckNonNull(section);
+			section->bits = compiled.bits;
+			section->inherit = UString(compiled.inherit);
+			section->setCompiledEntries(compiled.entries, compiled.count);
+			_sections.insert(std::make_pair(UString(compiled.name), section));
+		}
+		else
+		{
+			// Merge into an existing section.
+			ConfigSection *section = it->second;
+			if (compiled.bits != 0)
+			{
+				section->bits = compiled.bits;
+			}
+			if (!compiled.inherit.empty())
+			{
+				section->inherit = UString(compiled.inherit);
+			}
+			for (size_t e = 0; e < compiled.count; ++e)
+			{
+				ConfigEntry const &entry(compiled.entries[e]);
+				if (section->freeRange(entry.first, entry.last))
+				{
+					section->addEntry(entry.first, entry.last, UString(entry.name));
+				}
+				else
+				{
+					_configErrors++;
+					_log.error(u"section %s: range 0x%X-0x%X overlaps with an existing range", {UString(compiled.name), entry.first, entry.last});
+				}
+			}
+		}
+	}
+}
+
 //----------------------------------------------------------------------------
 // Decode a line as "first[-last] = name". Return true on success.
 //----------------------------------------------------------------------------
@@ -410,84 +502,109 @@ ts::NamesFile::~NamesFile()
 }
 
 //----------------------------------------------------------------------------
-// Configuration section.
+// Case-insensitive comparison of section names.
 //----------------------------------------------------------------------------
 
-ts::NamesFile::ConfigSection::~ConfigSection()
+bool ts::NamesFile::SectionNameLess::operator()(std::u16string_view a, std::u16string_view b) const
+{
+	// Section names are almost always ASCII, avoid the generic case conversion for them.
+	auto const lower = [](UChar c) { return c < 0x80 ? (c >= u'A' && c <= u'Z' ? UChar(c + (u'a' - u'A')) : c) : ToLower(c); };
+	size_t const size = std::min(a.size(), b.size());
+	for (size_t i = 0; i < size; ++i)
+	{
+		UChar const ca = lower(a[i]);
+		UChar const cb = lower(b[i]);
+		if (ca != cb)
+		{
+			return ca < cb;
+		}
+	}
+	return a.size() < b.size();
+}
+
+std::u16string_view ts::NamesFile::TrimmedSectionName(std::u16string_view sectionName)
 {
-	// Deallocate all configuration entries.
-	for (auto const &it : entries)
+	while (!sectionName.empty() && IsSpace(sectionName.front()))
 	{
-		delete it.second;
+		sectionName.remove_prefix(1);
 	}
-	entries.clear();
+	while (!sectionName.empty() && IsSpace(sectionName.back()))
+	{
+		sectionName.remove_suffix(1);
+	}
+	return sectionName;
 }
 
 //----------------------------------------------------------------------------
-// Check if a range is free, ie no value is defined in the range.
+// Index of the last entry with a first value lower than or equal to val.
 //----------------------------------------------------------------------------
 
-bool ts::NamesFile::ConfigSection::freeRange(Value first, Value last) const
+size_t ts::NamesFile::ConfigSection::find(Value val) const
 {
-	// Get an iterator pointing to the first element that is "not less" than 'first'.
-	auto it = entries.lower_bound(first);
-
-	if (it != entries.end() && it->first <= last)
-	{
-		// This is an existing range which starts inside [first..last].
-		assert(it->first >= first);
-		return false;
-	}
+	ConfigEntry const *const end = _entries + _count;
+	ConfigEntry const *const it = std::upper_bound(_entries, end, val, [](Value v, ConfigEntry const &e) { return v < e.first; });
+	return it == _entries ? NPOS : size_t(it - _entries) - 1;
+}
 
-	if (it != entries.begin() && (--it)->second->last >= first)
-	{
-		// The previous range ends inside [first..last].
-		assert(it->first < first);
-		return false;
-	}
+//----------------------------------------------------------------------------
+// Use a compiled table in place.
+//----------------------------------------------------------------------------
 
-	// No overlap found.
-	return true;
+void ts::NamesFile::ConfigSection::setCompiledEntries(ConfigEntry const *entries, size_t count)
+{
+	_ownedEntries.clear();
+	_ownedNames.clear();
+	_entries = entries;
+	_count = count;
 }
 
 //----------------------------------------------------------------------------
-// Add a new configuration entry.
+// Check if a range is free, ie no value is defined in the range.
 //----------------------------------------------------------------------------
 
-void ts::NamesFile::ConfigSection::addEntry(Value first, Value last, UString const &name)
+bool ts::NamesFile::ConfigSection::freeRange(Value first, Value last) const
 {
-	ConfigEntry *entry = new ConfigEntry(last, name);
-	CheckNonNull(entry);
-	entries.insert(std::make_pair(first, entry));
+	// Last entry starting at or before 'last'.
+	size_t const index = find(last);
+
+	// Since the ranges do not overlap, only this entry can overlap [first..last].
+	return index == NPOS || _entries[index].last < first;
 }
 
 //----------------------------------------------------------------------------
-// Get a name from a value, empty if not found.
+// Add a new configuration entry.
 //----------------------------------------------------------------------------
 
-ts::UString ts::NamesFile::ConfigSection::getName(Value val) const
+void ts::NamesFile::ConfigSection::addEntry(Value first, Value last, UString const &name)
 {
-	// Eliminate trivial cases which would cause issues with code below.
-	if (entries.empty())
+	// A compiled table is read-only, copy it before the first modification.
+	// The copied entries still point to the compiled names.
+	if (_entries != _ownedEntries.data())
 	{
-		return UString();
+		_ownedEntries.assign(_entries, _entries + _count);
+		_entries = _ownedEntries.data();
 	}
 
-	// The key in the 'entries' map is the _first_ value of a range.
-	// Get an iterator pointing to the first element that is "not less" than 'val'.
-	auto it = entries.lower_bound(val);
+	// Names files are usually sorted, the new entry is then appended at end.
+	_ownedNames.push_back(name);
+	size_t const index = find(first);
+	_ownedEntries.insert(_ownedEntries.begin() + (index == NPOS ? 0 : index + 1), ConfigEntry{first, last, _ownedNames.back()});
+	_entries = _ownedEntries.data();
+	_count = _ownedEntries.size();
+}
 
-	if (it == entries.end() || (it != entries.begin() && it->first != val))
+//----------------------------------------------------------------------------
+// Get a name from a value, empty if not found.
+//----------------------------------------------------------------------------
+
+std::u16string_view ts::NamesFile::ConfigSection::getName(Value val) const
+{
+	size_t const index = find(val);
+	if (index == NPOS || val > _entries[index].last)
 	{
-		// There is no entry with a value range starting at 'val'.
-		// Maybe 'val' is in the range of the previous entry.
-		--it;
+		return std::u16string_view();
 	}
-
-	assert(it != entries.end());
-	assert(it->second != nullptr);
-
-	return val >= it->first && val <= it->second->last ? it->second->name : UString();
+	return _entries[index].name;
 }
 
 //----------------------------------------------------------------------------
@@ -596,10 +713,10 @@ ts::UString ts::NamesFile::Formatted(Value value, UString const &name, NamesFlag
 // Get the section and name from a value, empty if not found.
 //----------------------------------------------------------------------------
 
-void ts::NamesFile::getName(UString const &sectionName, Value value, ConfigSection *&section, UString &name) const
+void ts::NamesFile::getName(std::u16string_view sectionName, Value value, ConfigSection const *&section, std::u16string_view &name) const
 {
-	// Normalized section name.
-	UString sname(NormalizedSectionName(sectionName));
+	// The section map is case-insensitive, only remove spaces.
+	std::u16string_view sname(TrimmedSectionName(sectionName));
 
 	// Limit the number of inheritance levels to avoid infinite loop.
 	int levels = 16;
@@ -613,7 +730,7 @@ void ts::NamesFile::getName(UString const &sectionName, Value value, ConfigSecti
 		{
 			// Section not found, no name.
 			section = nullptr;
-			name.clear();
+			name = std::u16string_view();
 			return;
 		}
 
@@ -628,7 +745,7 @@ void ts::NamesFile::getName(UString const &sectionName, Value value, ConfigSecti
 		}
 
 		// Loop on "superclass".
-		sname = NormalizedSectionName(section->inherit);
+		sname = TrimmedSectionName(section->inherit);
 	}
 }
 
@@ -638,10 +755,19 @@ void ts::NamesFile::getName(UString const &sectionName, Value value, ConfigSecti
 
 bool ts::NamesFile::nameExists(UString const &sectionName, Value value) const
 {
-	ConfigSection *section = nullptr;
-	UString name;
+	return !nameView(sectionName, value).empty();
+}
+
+//----------------------------------------------------------------------------
+// Get a raw name from a specified section, without copy.
+//----------------------------------------------------------------------------
+
+std::u16string_view ts::NamesFile::nameView(std::u16string_view sectionName, Value value) const
+{
+	ConfigSection const *section = nullptr;
+	std::u16string_view name;
 	getName(sectionName, value, section, name);
-	return !name.empty();
+	return name;
 }
 
 //----------------------------------------------------------------------------
@@ -650,8 +776,8 @@ bool ts::NamesFile::nameExists(UString const &sectionName, Value value) const
 
 ts::UString ts::NamesFile::nameFromSection(UString const &sectionName, Value value, NamesFlags flags, size_t bits, Value alternateValue) const
 {
-	ConfigSection *section = nullptr;
-	UString name;
+	ConfigSection const *section = nullptr;
+	std::u16string_view name;
 	getName(sectionName, value, section, name);
 
 	if (section == nullptr)
@@ -661,7 +787,7 @@ ts::UString ts::NamesFile::nameFromSection(UString const &sectionName, Value val
 	}
 	else
 	{
-		return Formatted(value, name, flags, bits != 0 ? bits : section->bits, alternateValue);
+		return Formatted(value, UString(name), flags, bits != 0 ? bits : section->bits, alternateValue);
 	}
 }
 
@@ -671,8 +797,8 @@ ts::UString ts::NamesFile::nameFromSection(UString const &sectionName, Value val
 
 ts::UString ts::NamesFile::nameFromSectionWithFallback(UString const &sectionName, Value value1, Value value2, NamesFlags flags, size_t bits, Value alternateValue) const
 {
-	ConfigSection *section = nullptr;
-	UString name;
+	ConfigSection const *section = nullptr;
+	std::u16string_view name;
 	getName(sectionName, value1, section, name);
 
 	if (section == nullptr)
@@ -683,7 +809,7 @@ ts::UString ts::NamesFile::nameFromSectionWithFallback(UString const &sectionNam
 	else if (!name.empty())
 	{
 		// value1 has a name
-		return Formatted(value1, name, flags, bits != 0 ? bits : section->bits, alternateValue);
+		return Formatted(value1, UString(name), flags, bits != 0 ? bits : section->bits, alternateValue);
 	}
 	else
 	{
@@ -147,6 +147,15 @@ namespace ts
 		//!
 		bool nameExists(UString const &sectionName, Value value) const;
 
+		//!
+		//! Get a raw name from a specified section, without formatting and without copy.
+		//! @param [in] sectionName Name of section to search. Not case-sensitive.
+		//! @param [in] value Value to get the name for.
+		//! @return A view on the name for @a value in @a sectionName, empty if there is no name.
+		//! The view remains valid as long as this instance exists.
+		//!
+		std::u16string_view nameView(std::u16string_view sectionName, Value value) const;
+
 		//!
 		//! Get a name from a specified section.
 		//! @param [in] sectionName Name of section to search. Not case-sensitive.
@@ -209,24 +218,53 @@ namespace ts
 		//!
 		static void UnregisterExtensionFile(UString const &filename);
 
-	private:
-		// Description of a configuration entry.
-		// The first value of the range is the key in a map.
-		class ConfigEntry
+		//!
+		//! One entry of a names table which is compiled into the executable.
+		//! Such tables are generated at build time from the ".names" files by the
+		//! tsNamesCompiler tool, see project.cmake.
+		//!
+		struct CompiledEntry
+		{
+			Value first;                 //!< First value in the range.
+			Value last;                  //!< Last value in the range.
+			std::u16string_view name;    //!< Associated name.
+		};
+
+		//!
+		//! One section of a names table which is compiled into the executable.
+		//!
+		struct CompiledSection
+		{
+			std::u16string_view name;        //!< Section name, lowercase.
+			size_t bits;                     //!< Number of significant bits in values of the type, zero if unspecified.
+			std::u16string_view inherit;     //!< Redirect to this section if value not found, empty if none.
+			CompiledEntry const *entries;    //!< Entries, sorted by first value, non-overlapping.
+			size_t count;                    //!< Number of entries.
+		};
+
+		//!
+		//! A class to register a names file which was compiled into the executable.
+		//! When the corresponding NamesFile instance is created, the compiled tables are used
+		//! in place, the ".names" file is neither searched nor parsed.
+		//! The registration is performed in the source file which is generated by tsNamesCompiler.
+		//!
+		class TSDUCKDLL RegisterCompiledFile
 		{
+			TS_NOBUILD_NOCOPY(RegisterCompiledFile);
+
 		public:
-			Value last = 0; // Last value in the range.
-			UString name{}; // Associated name.
-
-			ConfigEntry(Value l = 0, UString const &n = UString())
-				: last(l),
-				  name(n)
-			{
-			}
+			//!
+			//! Register a compiled names file.
+			//! @param [in] filename Name of the names file, as used in Instance().
+			//! @param [in] sections Address of the compiled sections. Must remain valid for the whole execution.
+			//! @param [in] count Number of compiled sections.
+			//!
+			RegisterCompiledFile(UString const &filename, CompiledSection const *sections, size_t count);
 		};
 
-		// Map of configuration entries, indexed by first value of the range.
-		typedef std::map<Value, ConfigEntry *> ConfigEntryMap;
+	private:
+		// Description of a configuration entry.
+		typedef CompiledEntry ConfigEntry;
 
 		// Description of a configuration section.
 		// The name of the section is the key in a map.
@@ -235,25 +273,51 @@ namespace ts
 			TS_NOCOPY(ConfigSection);
 
 		public:
-			size_t bits = 0;          // Number of significant bits in values of the type.
-			ConfigEntryMap entries{}; // All entries, indexed by names.
-			UString inherit{};        // Redirect to this section if value not found.
+			size_t bits = 0;    // Number of significant bits in values of the type.
+			UString inherit{};  // Redirect to this section if value not found.
 
 			ConfigSection() = default;
-			~ConfigSection();
+			~ConfigSection() = default;
+
+			// Use a compiled table in place, without copy.
+			void setCompiledEntries(ConfigEntry const *entries, size_t count);
 
 			// Check if a range is free, ie no value is defined in the range.
 			bool freeRange(Value first, Value last) const;
 
-			// Add a new entry.
+			// Add a new entry. The range must be free.
 			void addEntry(Value first, Value last, UString const &name);
 
 			// Get a name from a value, empty if not found.
-			UString getName(Value val) const;
+			std::u16string_view getName(Value val) const;
+
+		private:
+			// All entries, sorted by first value. Point either to a compiled table or to _ownedEntries.
+			// Lookups are binary searches on contiguous memory.
+			ConfigEntry const *_entries = nullptr;
+			size_t _count = 0;
+
+			// Entries and names which were added at run time. A compiled table is copied here
+			// when an entry is added to it. A deque never moves its elements, the entries can
+			// keep views on the names.
+			std::vector<ConfigEntry> _ownedEntries{};
+			std::deque<UString> _ownedNames{};
+
+			// Index of the last entry with a first value lower than or equal to val, NPOS if none.
+			size_t find(Value val) const;
+		};
+
+		// Case-insensitive comparison of section names. Transparent, so that a section
+		// can be searched from a string view, without building a normalized name.
+		class SectionNameLess
+		{
+		public:
+			using is_transparent = void;
+			bool operator()(std::u16string_view a, std::u16string_view b) const;
 		};
 
 		// Map of configuration sections, indexed by name.
-		typedef std::map<UString, ConfigSection *> ConfigSectionMap;
+		typedef std::map<UString, ConfigSection *, SectionNameLess> ConfigSectionMap;
 
 		// Decode a line as "first[-last] = name". Return true on success, false on error.
 		bool decodeDefinition(UString const &line, ConfigSection *section);
@@ -267,14 +331,14 @@ namespace ts
 		// Load a configuration file and merge its content into this instance.
 		void loadFile(UString const &fileName);
 
+		// Load compiled tables into this instance, without copying the entries.
+		void loadCompiled(CompiledSection const *sections, size_t count);
+
 		// Get the section and name from a value, empty if not found. Section can be null.
-		void getName(UString const &sectionName, Value value, ConfigSection *&section, UString &name) const;
+		void getName(std::u16string_view sectionName, Value value, ConfigSection const *&section, std::u16string_view &name) const;
 
-		// Normalized section name.
-		static UString NormalizedSectionName(UString const &sectionName)
-		{
-			return sectionName.toTrimmed().toLower();
-		}
+		// Section name without leading and trailing spaces. Case is handled by SectionNameLess.
+		static std::u16string_view TrimmedSectionName(std::u16string_view sectionName);
 
 		// Names private fields.
 		Report &_log;                 // Error logger.
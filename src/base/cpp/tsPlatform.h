@@ -852,6 +852,7 @@ TS_MSC_NOWARNING(5045) // Compiler will insert Spectre mitigation for memory loa
 #include <thread>
 #include <type_traits>
 #include <typeinfo>
+#include <unordered_map>
 #include <vector>
 #if defined(TS_WINDOWS)
 #include <windows.h>
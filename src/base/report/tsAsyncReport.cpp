@@ -0,0 +1,424 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsAsyncReport.h"
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::AsyncReport::AsyncReport(int max_severity, std::ostream &output, size_t queue_size, size_t site_rate_limit)
+	: Report(max_severity),
+	  _output(output),
+	  _site_rate_limit(site_rate_limit),
+	  _start(std::chrono::steady_clock::now())
+{
+	size_t size = 2;
+	while (size < queue_size)
+	{
+		size *= 2;
+	}
+
+	_mask = size - 1;
+	_slots.reset(new Slot[size]);
+	for (size_t i = 0; i < size; i++)
+	{
+		_slots[i].seq.store(i, std::memory_order_relaxed);
+	}
+
+	_thread = std::thread(&AsyncReport::main, this);
+}
+
+ts::AsyncReport::~AsyncReport()
+{
+	terminate();
+}
+
+void ts::AsyncReport::terminate()
+{
+	if (!_terminate.exchange(true, std::memory_order_acq_rel))
+	{
+		_wake.notify_one();
+		if (_thread.joinable())
+		{
+			_thread.join();
+		}
+	}
+}
+
+//----------------------------------------------------------------------------
+// Logging methods, called by any thread.
+//----------------------------------------------------------------------------
+
+void ts::AsyncReport::log(int severity, UString const &msg)
+{
+	recordSeverity(severity);
+	if (severity <= _max_severity && allowSite(Hash(msg.c_str()), severity))
+	{
+		writeLog(severity, msg);
+	}
+}
+
+void ts::AsyncReport::log(int severity, UChar const *fmt, std::initializer_list<ArgMixIn> args)
+{
+	// The address of a literal format identifies the message site, without reading it.
+	if (severity <= _max_severity)
+	{
+		logFormat(severity, fmt, std::hash<UChar const *>()(fmt), args);
+	}
+}
+
+void ts::AsyncReport::log(int severity, UString const &fmt, std::initializer_list<ArgMixIn> args)
+{
+	if (severity <= _max_severity)
+	{
+		logFormat(severity, fmt.c_str(), Hash(fmt.c_str()), args);
+	}
+}
+
+void ts::AsyncReport::writeLog(int severity, UString const &msg)
+{
+	Message m;
+	m.severity = severity;
+	m.text = msg;
+	push(std::move(m));
+}
+
+void ts::AsyncReport::logFormat(int severity, UChar const *fmt, size_t site_hash, std::initializer_list<ArgMixIn> args)
+{
+	recordSeverity(severity);
+	if (!allowSite(site_hash, severity))
+	{
+		return;
+	}
+
+	Message m;
+	m.severity = severity;
+	if (CaptureArguments(m.args, args))
+	{
+		m.format = true;
+		m.text = fmt;
+	}
+	else
+	{
+		// Some arguments are only referenced, format now.
+		m.args.clear();
+		m.text = UString::Format(fmt, args);
+	}
+
+	push(std::move(m));
+}
+
+void ts::AsyncReport::push(Message &&msg)
+{
+	if (_terminate.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	if (enqueue(std::move(msg)))
+	{
+		_wake.notify_one();
+	}
+	else
+	{
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		_dropped_total.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+//----------------------------------------------------------------------------
+// Copy the arguments by value.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncReport::CaptureArguments(std::vector<Argument> &out, std::initializer_list<ArgMixIn> args)
+{
+	out.resize(args.size());
+	auto it = out.begin();
+	for (auto const &arg : args)
+	{
+		Argument &a(*it++);
+		a.size = arg.size();
+		if (arg.isBool())
+		{
+			a.kind = Argument::BOOLEAN;
+			a.u = arg.toUInt64();
+		}
+		else if (arg.isSigned())
+		{
+			a.kind = Argument::SIGNED;
+			a.i = arg.toInt64();
+		}
+		else if (arg.isInteger())
+		{
+			a.kind = Argument::UNSIGNED;
+			a.u = arg.toUInt64();
+		}
+		else if (arg.isDouble())
+		{
+			a.kind = Argument::DOUBLE;
+			a.d = arg.toDouble();
+		}
+		else if (arg.isAnyString())
+		{
+			a.kind = Argument::STRING;
+			a.s = arg.toUString();
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//----------------------------------------------------------------------------
+// Per-site rate limitation.
+//----------------------------------------------------------------------------
+
+int64_t ts::AsyncReport::currentSecond() const
+{
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - _start).count();
+}
+
+size_t ts::AsyncReport::Hash(UChar const *str)
+{
+	// FNV-1a.
+	size_t h = 2166136261u;
+	for (; *str != 0; str++)
+	{
+		h = (h ^ size_t(*str)) * 16777619u;
+	}
+
+	return h;
+}
+
+bool ts::AsyncReport::allowSite(size_t site_hash, int severity)
+{
+	if (_site_rate_limit == 0)
+	{
+		return true;
+	}
+
+	Site &site(_sites[(site_hash ^ (site_hash >> 16)) % SITE_COUNT]);
+	int64_t const now = currentSecond();
+	int64_t second = site.second.load(std::memory_order_relaxed);
+	if (second != now && site.second.compare_exchange_strong(second, now, std::memory_order_relaxed))
+	{
+		// First message of the site in this second.
+		site.count.store(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	if (site.count.fetch_add(1, std::memory_order_relaxed) < _site_rate_limit)
+	{
+		return true;
+	}
+
+	// Reported later by the background thread.
+	site.severity.store(severity, std::memory_order_relaxed);
+	site.suppressed.fetch_add(1, std::memory_order_relaxed);
+	_suppressed_total.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+//----------------------------------------------------------------------------
+// Bounded multiple-producer queue (D. Vyukov).
+// A slot is free for the producer at position pos when its sequence number
+// is pos, it contains a message for the consumer when it is pos + 1.
+//----------------------------------------------------------------------------
+
+bool ts::AsyncReport::enqueue(Message &&msg)
+{
+	Slot *slot = nullptr;
+	size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		slot = &_slots[pos & _mask];
+		size_t const seq = slot->seq.load(std::memory_order_acquire);
+		intptr_t const diff = intptr_t(seq) - intptr_t(pos);
+		if (diff == 0)
+		{
+			if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			// Queue full.
+			return false;
+		}
+		else
+		{
+			pos = _enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->msg = std::move(msg);
+	slot->seq.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool ts::AsyncReport::dequeue(Message &msg)
+{
+	Slot &slot(_slots[_dequeue_pos & _mask]);
+	if (slot.seq.load(std::memory_order_acquire) != _dequeue_pos + 1)
+	{
+		return false;
+	}
+
+	msg = std::move(slot.msg);
+	slot.msg = Message();
+	slot.seq.store(_dequeue_pos + _mask + 1, std::memory_order_release);
+	_dequeue_pos++;
+	return true;
+}
+
+//----------------------------------------------------------------------------
+// Background thread.
+//----------------------------------------------------------------------------
+
+void ts::AsyncReport::main()
+{
+	Message msg;
+	for (;;)
+	{
+		// Messages which were queued before termination are still written.
+		bool const stop = _terminate.load(std::memory_order_acquire);
+		bool written = false;
+		while (dequeue(msg))
+		{
+			write(msg);
+			written = true;
+		}
+
+		reportLosses(stop);
+		if (written)
+		{
+			_output.flush();
+		}
+
+		if (stop)
+		{
+			_output.flush();
+			break;
+		}
+
+		// Producers do not lock the mutex when notifying, a lost wake-up is caught by the timeout.
+		std::unique_lock<std::mutex> lock(_wake_mutex);
+		_wake.wait_for(lock, std::chrono::milliseconds(10));
+	}
+}
+
+void ts::AsyncReport::write(Message const &msg)
+{
+	if (!msg.format)
+	{
+		_output << Severity::Header(msg.severity) << msg.text << std::endl;
+		return;
+	}
+
+	// Rebuild the arguments with their original types, the format depends on them.
+	std::vector<ArgMixIn> args;
+	args.reserve(msg.args.size());
+	for (auto const &a : msg.args)
+	{
+		switch (a.kind)
+		{
+		case Argument::BOOLEAN:
+			args.emplace_back(a.u != 0);
+			break;
+
+		case Argument::SIGNED:
+			switch (a.size)
+			{
+			case 1:
+				args.emplace_back(int8_t(a.i));
+				break;
+			case 2:
+				args.emplace_back(int16_t(a.i));
+				break;
+			case 4:
+				args.emplace_back(int32_t(a.i));
+				break;
+			default:
+				args.emplace_back(int64_t(a.i));
+				break;
+			}
+			break;
+
+		case Argument::UNSIGNED:
+			switch (a.size)
+			{
+			case 1:
+				args.emplace_back(uint8_t(a.u));
+				break;
+			case 2:
+				args.emplace_back(uint16_t(a.u));
+				break;
+			case 4:
+				args.emplace_back(uint32_t(a.u));
+				break;
+			default:
+				args.emplace_back(uint64_t(a.u));
+				break;
+			}
+			break;
+
+		case Argument::DOUBLE:
+			args.emplace_back(a.d);
+			break;
+
+		case Argument::STRING:
+		default:
+			args.emplace_back(a.s);
+			break;
+		}
+	}
+
+	UString text;
+	text.format(msg.text.c_str(), args);
+	_output << Severity::Header(msg.severity) << text << std::endl;
+}
+
+void ts::AsyncReport::reportLosses(bool force)
+{
+	size_t const dropped = _dropped.exchange(0, std::memory_order_relaxed);
+	if (dropped > 0)
+	{
+		_output << Severity::Header(Severity::Warning)
+				<< UString::Format(u"%'d log messages dropped, logging queue full", {dropped})
+				<< std::endl;
+	}
+
+	// Suppressed messages are reported at most once per second.
+	int64_t const now = currentSecond();
+	if (_site_rate_limit == 0 || (now == _last_sweep && !force))
+	{
+		return;
+	}
+
+	_last_sweep = now;
+	for (auto &site : _sites)
+	{
+		if (site.suppressed.load(std::memory_order_relaxed) == 0)
+		{
+			continue;
+		}
+
+		uint32_t const suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+		if (suppressed > 0)
+		{
+			_output << Severity::Header(site.severity.load(std::memory_order_relaxed))
+					<< UString::Format(u"%'d similar log messages suppressed", {suppressed})
+					<< std::endl;
+		}
+	}
+}
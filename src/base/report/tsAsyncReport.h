@@ -0,0 +1,204 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Asynchronous message report.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsReport.h"
+#include "tsUString.h"
+
+namespace ts
+{
+	//!
+	//! Asynchronous message report.
+	//! @ingroup log
+	//!
+	//! Messages are queued in a lock-free bounded queue by the logging threads and
+	//! are formatted and written by a background thread. A thread which logs a message
+	//! never waits for the output stream, nor for another logging thread.
+	//!
+	//! With the variants of log() which use a format and arguments, the formatting is
+	//! deferred to the background thread: the format and the values of the arguments
+	//! are copied into the queue. Arguments which cannot be copied by value (AbstractNumber)
+	//! are formatted in the logging thread.
+	//!
+	//! Each message site, identified by its format string, is rate-limited: beyond a
+	//! maximum number of messages per second, messages from the same site are counted
+	//! and discarded. The number of discarded messages is reported later. Sites are
+	//! hashed into a fixed table, two sites may share the same limit.
+	//!
+	//! When the queue is full, messages are dropped and counted. The number of dropped
+	//! messages is reported as soon as the background thread catches up.
+	//!
+	//! This class is thread-safe. The log methods can be called from any thread.
+	//!
+	class TSDUCKDLL AsyncReport : public Report
+	{
+		TS_NOBUILD_NOCOPY(AsyncReport);
+
+	public:
+		//!
+		//! Default maximum number of messages in the queue.
+		//!
+		static constexpr size_t DEFAULT_QUEUE_SIZE = 1024;
+
+		//!
+		//! Default maximum number of messages per second and per message site.
+		//!
+		static constexpr size_t DEFAULT_SITE_RATE_LIMIT = 20;
+
+		//!
+		//! Constructor.
+		//! The background thread is started immediately.
+		//! @param [in] max_severity Set initial level report to that level.
+		//! @param [in] output Output stream. Must remain valid until terminate() or the destructor.
+		//! @param [in] queue_size Maximum number of messages in the queue. Rounded up to a power of 2.
+		//! @param [in] site_rate_limit Maximum number of messages per second and per message site.
+		//! Zero means unlimited.
+		//!
+		AsyncReport(int max_severity = Severity::Info,
+					std::ostream &output = std::cerr,
+					size_t queue_size = DEFAULT_QUEUE_SIZE,
+					size_t site_rate_limit = DEFAULT_SITE_RATE_LIMIT);
+
+		//!
+		//! Destructor.
+		//! Write all pending messages and stop the background thread.
+		//!
+		virtual ~AsyncReport() override;
+
+		//!
+		//! Write all pending messages and stop the background thread.
+		//! Subsequent messages are ignored.
+		//!
+		void terminate();
+
+		//!
+		//! Get the total number of messages which were dropped because the queue was full.
+		//! @return The total number of dropped messages.
+		//!
+		size_t droppedCount() const
+		{
+			return _dropped_total.load(std::memory_order_relaxed);
+		}
+
+		//!
+		//! Get the total number of messages which were discarded by the per-site rate limit.
+		//! @return The total number of discarded messages.
+		//!
+		size_t suppressedCount() const
+		{
+			return _suppressed_total.load(std::memory_order_relaxed);
+		}
+
+		// Inherited from Report.
+		virtual void log(int severity, UString const &msg) override;
+		virtual void log(int severity, UChar const *fmt, std::initializer_list<ArgMixIn> args) override;
+		virtual void log(int severity, UString const &fmt, std::initializer_list<ArgMixIn> args) override;
+
+	protected:
+		// Inherited from Report.
+		virtual void writeLog(int severity, UString const &msg) override;
+
+	private:
+		// Value of an argument, copied from an ArgMixIn.
+		struct Argument
+		{
+			enum Kind : uint8_t
+			{
+				SIGNED,
+				UNSIGNED,
+				BOOLEAN,
+				DOUBLE,
+				STRING
+			};
+			Kind kind = SIGNED;
+			size_t size = 0;
+			int64_t i = 0;
+			uint64_t u = 0;
+			double d = 0.0;
+			UString s{};
+		};
+
+		// A queued message. When args is empty, text is the message, otherwise it is the format.
+		struct Message
+		{
+			int severity = 0;
+			bool format = false;
+			UString text{};
+			std::vector<Argument> args{};
+		};
+
+		// One slot in the queue, the sequence number synchronizes producers and the consumer.
+		struct Slot
+		{
+			std::atomic<size_t> seq{0};
+			Message msg{};
+		};
+
+		// Rate limitation state of a message site.
+		struct Site
+		{
+			std::atomic<int64_t> second{-1};
+			std::atomic<uint32_t> count{0};
+			std::atomic<uint32_t> suppressed{0};
+			std::atomic<int> severity{0};
+		};
+
+		static constexpr size_t SITE_COUNT = 256;
+
+		std::ostream &_output;
+		size_t const _site_rate_limit;
+		size_t _mask = 0;
+		std::unique_ptr<Slot[]> _slots{};
+		std::atomic<size_t> _enqueue_pos{0};
+		size_t _dequeue_pos = 0;                    // Accessed by the background thread only.
+		std::atomic<size_t> _dropped{0};            // Dropped and not yet reported.
+		std::atomic<size_t> _dropped_total{0};
+		std::atomic<size_t> _suppressed_total{0};
+		std::atomic<bool> _terminate{false};
+		int64_t _last_sweep = -1;                   // Accessed by the background thread only.
+		Site _sites[SITE_COUNT]{};
+		std::mutex _wake_mutex{};
+		std::condition_variable _wake{};
+		std::chrono::steady_clock::time_point const _start;
+		std::thread _thread{};
+
+		// Check the rate limitation of a message site. Return false if the message shall be discarded.
+		bool allowSite(size_t site_hash, int severity);
+
+		// Queue a message. Return false if the queue is full.
+		bool enqueue(Message &&msg);
+
+		// Dequeue a message in the background thread. Return false if the queue is empty.
+		bool dequeue(Message &msg);
+
+		// Copy the arguments by value. Return false if some of them cannot be copied.
+		static bool CaptureArguments(std::vector<Argument> &out, std::initializer_list<ArgMixIn> args);
+
+		// Queue a message with a format and arguments.
+		void logFormat(int severity, UChar const *fmt, size_t site_hash, std::initializer_list<ArgMixIn> args);
+
+		// Queue a message, count it if the queue is full.
+		void push(Message &&msg);
+
+		// Current second since the creation of the report.
+		int64_t currentSecond() const;
+
+		// Hash of a string, used as site identifier.
+		static size_t Hash(UChar const *str);
+
+		// Background thread.
+		void main();
+		void write(Message const &msg);
+		void reportLosses(bool force);
+	};
+} // namespace ts
@@ -389,6 +389,19 @@ namespace ts
 		//!
 		int volatile _max_severity = Severity::Info;
 
+		//!
+		//! Record that a message of the specified severity was reported.
+		//! For subclasses which override log() without calling the log() of this class.
+		//! @param [in] severity Message severity.
+		//!
+		void recordSeverity(int severity)
+		{
+			if (severity <= Severity::Error)
+			{
+				_got_errors = true;
+			}
+		}
+
 		//!
 		//! Actual message reporting method.
 		//!
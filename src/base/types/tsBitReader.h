@@ -0,0 +1,204 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Word-at-a-time big-endian bit reader.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMemory.h"
+
+#if defined(TS_MSC)
+#include <intrin.h>
+#endif
+
+namespace ts {
+    //!
+    //! Count the number of leading zero bits in a 64-bit integer.
+    //! @param [in] x A 64-bit unsigned integer.
+    //! @return The number of leading zero bits in @a x, 64 when @a x is zero.
+    //!
+    TSDUCKDLL inline size_t LeadingZeros64(uint64_t x)
+    {
+        if (x == 0) {
+            return 64;
+        }
+    #if defined(TS_MSC)
+        unsigned long index = 0;
+        _BitScanReverse64(&index, x);
+        return 63 - size_t(index);
+    #else
+        return size_t(__builtin_clzll(x));
+    #endif
+    }
+
+    //!
+    //! Big-endian bit reader over a memory area, reading up to 64 bits at a time.
+    //! @ingroup cpp
+    //!
+    //! Instead of extracting one bit at a time, the next 64 bits of the stream are
+    //! loaded with one unaligned big-endian word read and the requested bits are
+    //! extracted by shifting. Exp-Golomb codes are decoded with one leading zero count.
+    //!
+    //! This class performs no error bookkeeping: the callers check remainingBits()
+    //! before reading. Bits past the end of the memory area read as zero.
+    //! The memory area is not copied and must remain valid while it is read.
+    //!
+    class TSDUCKDLL BitReader
+    {
+    public:
+        //!
+        //! Number of bits which are always valid in peekWord(), when available in the stream.
+        //!
+        static constexpr size_t PEEK_BITS = 57;
+
+        //!
+        //! Constructor.
+        //! @param [in] data Address of the memory area to read.
+        //! @param [in] size Size in bytes of the memory area.
+        //!
+        BitReader(const uint8_t* data = nullptr, size_t size = 0) : _data(data), _size(size) {}
+
+        //!
+        //! Reset with a new memory area, at bit position zero.
+        //! @param [in] data Address of the memory area to read.
+        //! @param [in] size Size in bytes of the memory area.
+        //!
+        void reset(const uint8_t* data, size_t size)
+        {
+            _data = data;
+            _size = size;
+            _pos = 0;
+        }
+
+        //!
+        //! Get the size of the memory area.
+        //! @return The size in bytes of the memory area.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Get the current read position.
+        //! @return The current bit offset from the beginning of the memory area.
+        //!
+        size_t position() const { return _pos; }
+
+        //!
+        //! Set the current read position.
+        //! @param [in] bit_offset The new bit offset, bounded by the end of the memory area.
+        //!
+        void setPosition(size_t bit_offset) { _pos = std::min(bit_offset, 8 * _size); }
+
+        //!
+        //! Get the number of remaining bits.
+        //! @return The number of remaining bits.
+        //!
+        size_t remainingBits() const { return 8 * _size - _pos; }
+
+        //!
+        //! Check if the read position is at a byte boundary.
+        //! @return True if the read position is at a byte boundary.
+        //!
+        bool byteAligned() const { return (_pos & 7) == 0; }
+
+        //!
+        //! Get the next 64 bits without advancing the read position.
+        //! @return The next bits, the next bit to read is the most significant bit.
+        //! At least PEEK_BITS bits are valid. Bits past the end of the memory area are zero.
+        //!
+        uint64_t peekWord() const
+        {
+            const size_t byte = _pos >> 3;
+            uint64_t word = 0;
+            if (byte + 8 <= _size) {
+                word = GetUInt64BE(_data + byte);
+            }
+            else {
+                for (size_t i = byte; i < _size; ++i) {
+                    word |= uint64_t(_data[i]) << (56 - 8 * (i - byte));
+                }
+            }
+            return word << (_pos & 7);
+        }
+
+        //!
+        //! Read bits and advance the read position.
+        //! The caller must check that enough bits remain.
+        //! @param [in] n Number of bits to read, from 0 to 64.
+        //! @return The value of the @a n bits.
+        //!
+        uint64_t readBits(size_t n)
+        {
+            if (n == 0) {
+                return 0;
+            }
+            else if (n <= PEEK_BITS) {
+                const uint64_t value = peekWord() >> (64 - n);
+                _pos += n;
+                return value;
+            }
+            else {
+                const uint64_t high = readBits(n - 32);
+                return (high << 32) | readBits(32);
+            }
+        }
+
+        //!
+        //! Advance the read position.
+        //! @param [in] n Number of bits to skip, bounded by the end of the memory area.
+        //!
+        void skipBits(size_t n) { setPosition(_pos + n); }
+
+        //!
+        //! Count the number of consecutive zero bits at the read position, without advancing.
+        //! @return The number of zero bits before the next one bit or the end of the memory area.
+        //!
+        size_t leadingZeros() const
+        {
+            const uint64_t word = peekWord();
+            if (word != 0) {
+                return std::min(LeadingZeros64(word), remainingBits());
+            }
+            // Long run of zeroes, continue word by word.
+            size_t count = 0;
+            BitReader next(*this);
+            while (next.remainingBits() > 0) {
+                const size_t zeros = std::min(LeadingZeros64(next.peekWord()), PEEK_BITS);
+                count += std::min(zeros, next.remainingBits());
+                if (zeros < PEEK_BITS) {
+                    break;
+                }
+                next.skipBits(zeros);
+            }
+            return std::min(count, remainingBits());
+        }
+
+        //!
+        //! Read an unsigned Exp-Golomb-coded value, as defined in ISO/IEC 14496-10 section 9.1.
+        //! @param [out] value The decoded value.
+        //! @return True on success, false if the code is truncated or larger than 64 bits.
+        //! On error, the read position is undefined.
+        //!
+        bool readExpGolomb(uint64_t& value)
+        {
+            const size_t zeros = leadingZeros();
+            if (zeros > 63 || remainingBits() < 2 * zeros + 1) {
+                return false;
+            }
+            _pos += zeros;
+            value = readBits(zeros + 1) - 1;
+            return true;
+        }
+
+    private:
+        const uint8_t* _data = nullptr;  // Base address of the memory area.
+        size_t         _size = 0;        // Size in bytes of the memory area.
+        size_t         _pos = 0;         // Current bit offset in the memory area.
+    };
+}
@@ -879,6 +879,18 @@ bool ts::Buffer::backBits(size_t bits)
 bool ts::Buffer::skipReservedBits(size_t bits, int expected)
 {
     expected &= 1;  // force 0 or 1
+
+    // Fast path: all reserved bits are read at once and have the expected value.
+    if (_big_endian && !_read_error && bits > 0 && bits <= BitReader::PEEK_BITS && remainingReadBits() >= bits) {
+        BitReader reader(bitReader());
+        const uint64_t mask = ~uint64_t(0) >> (64 - bits);
+        if (reader.readBits(bits) == (expected == 0 ? 0 : mask)) {
+            setReadPosition(reader);
+            return true;
+        }
+    }
+
+    // Bit by bit, to locate the invalid reserved bits.
     while (!_read_error && bits-- > 0) {
         if (getBit() != expected && !_read_error) {
             // Invalid reserved bit.
@@ -13,6 +13,7 @@
 
 #pragma once
 #include "tsMemory.h"
+#include "tsBitReader.h"
 #include "tsByteBlock.h"
 #include "tsFloatUtils.h"
 #include "tsUString.h"
@@ -1398,6 +1399,21 @@ namespace ts {
         // - Advance read pointer.
         const uint8_t* rdb(size_t bytes);
 
+        // Big endian bit reader on the readable part of the buffer, at the current read position.
+        BitReader bitReader() const
+        {
+            BitReader reader(_buffer, _state.wbyte + (_state.wbit != 0 ? 1 : 0));
+            reader.setPosition(8 * _state.rbyte + _state.rbit);
+            return reader;
+        }
+
+        // Move the read position to the position of a bit reader from bitReader().
+        void setReadPosition(const BitReader& reader)
+        {
+            _state.rbyte = reader.position() >> 3;
+            _state.rbit = reader.position() & 7;
+        }
+
         // Internal put integer method.
         template <typename INT, typename std::enable_if<std::is_integral<INT>::value || std::is_floating_point<INT>::value, int>::type = 0>
         bool putint(INT value, size_t bytes, void (*putBE)(void*,INT), void (*putLE)(void*,INT));
@@ -1502,23 +1518,14 @@ INT ts::Buffer::getBits(size_t bits)
     INT val = 0;
 
     if (_big_endian) {
-        // Read leading bits up to byte boundary
-        while (bits > 0 && _state.rbit != 0) {
-            val = INT(val << 1) | INT(getBit());
-            --bits;
-        }
-
-        // Read complete bytes
-        while (bits > 7) {
-            val = INT(val << 8) | INT(_buffer[_state.rbyte++]);
-            bits -= 8;
-        }
-
-        // Read trailing bits
-        while (bits > 0) {
-            val = INT(val << 1) | INT(getBit());
-            --bits;
+        // Read up to 64 bits at a time. Only the least significant bits fit in val.
+        BitReader reader(bitReader());
+        if (bits > 64) {
+            reader.skipBits(bits - 64);
+            bits = 64;
         }
+        val = static_cast<INT>(reader.readBits(bits));
+        setReadPosition(reader);
     }
     else {
         // Little endian decoding
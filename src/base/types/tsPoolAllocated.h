@@ -0,0 +1,134 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Base class for objects which are allocated from a thread-local pool.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Base class template for objects which are allocated from a thread-local pool.
+    //! @ingroup cpp
+    //!
+    //! A class which derives from PoolAllocated<T> gets class-specific operators
+    //! @c new and @c delete. Deleted objects are not returned to the heap, their
+    //! memory is kept in a free list of the current thread and reused by the next
+    //! allocations of the same class in this thread. This is useful for small objects
+    //! which are allocated and deleted at a high rate, typically sections or their
+    //! safe pointer control blocks in a demux.
+    //!
+    //! Each memory block is individually allocated from the heap. Therefore, an object
+    //! can be deleted in another thread than the one which allocated it. Its memory
+    //! block simply moves into the free list of the deleting thread.
+    //!
+    //! The size of the free list of each thread is bounded by @a MAX_FREE. Beyond that
+    //! limit, deleted objects are returned to the heap. The free list of a thread is
+    //! returned to the heap when the thread terminates.
+    //!
+    //! Allocations of a subclass of @a T with a different size are not pooled.
+    //!
+    //! @tparam T The class which derives from PoolAllocated<T>.
+    //! @tparam MAX_FREE Maximum number of free blocks to keep per thread.
+    //!
+    template <class T, size_t MAX_FREE = 1024>
+    class PoolAllocated
+    {
+    public:
+        //!
+        //! Class-specific allocation operator.
+        //! @param [in] size Size in bytes of the object to allocate.
+        //! @return Address of the allocated memory.
+        //!
+        static void* operator new(size_t size)
+        {
+            FreeList& list(freeList());
+            if (size == sizeof(T) && list.head != nullptr) {
+                FreeBlock* const block = list.head;
+                list.head = block->next;
+                list.count--;
+                return block;
+            }
+            return ::operator new(size);
+        }
+
+        //!
+        //! Class-specific deallocation operator.
+        //! @param [in] ptr Address of the object memory.
+        //! @param [in] size Size in bytes of the object.
+        //!
+        static void operator delete(void* ptr, size_t size)
+        {
+            if (ptr == nullptr) {
+                return;
+            }
+            FreeList& list(freeList());
+            if (size == sizeof(T) && !list.closed && list.count < MAX_FREE) {
+                FreeBlock* const block = static_cast<FreeBlock*>(ptr);
+                block->next = list.head;
+                list.head = block;
+                list.count++;
+            }
+            else {
+                ::operator delete(ptr);
+            }
+        }
+
+    private:
+        // A free memory block is linked using its own storage.
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        // The free list is trivially destructible so that it remains usable while the
+        // thread terminates, after the cleaner below has run (objects deleted by static
+        // destructors of the main thread).
+        struct FreeList
+        {
+            FreeBlock* head;
+            size_t     count;
+            bool       closed;
+        };
+
+        // Return the free list to the heap when the thread terminates.
+        struct Cleaner
+        {
+            ~Cleaner()
+            {
+                FreeList& list(freeListStorage());
+                while (list.head != nullptr) {
+                    FreeBlock* const block = list.head;
+                    list.head = block->next;
+                    ::operator delete(block);
+                }
+                list.count = 0;
+                list.closed = true;
+            }
+        };
+
+        static FreeList& freeListStorage()
+        {
+            static thread_local FreeList list {nullptr, 0, false};
+            return list;
+        }
+
+        static FreeList& freeList()
+        {
+            FreeList& list(freeListStorage());
+            if (!list.closed) {
+                static thread_local Cleaner cleaner;
+                (void)cleaner;
+            }
+            return list;
+        }
+    };
+}
@@ -13,6 +13,7 @@
 
 #pragma once
 #include "tsPlatform.h"
+#include "tsPoolAllocated.h"
 
 namespace ts {
     //!
@@ -392,7 +393,9 @@ namespace ts {
 
     private:
         // All safe pointers which reference the same T object share one single SafePtrShared object.
-        class SafePtrShared
+        // Control blocks are allocated from a thread-local pool because one is
+        // created for each new safe pointer, even null ones.
+        class SafePtrShared : public PoolAllocated<SafePtrShared>
         {
             TS_NOBUILD_NOCOPY(SafePtrShared);
         private:
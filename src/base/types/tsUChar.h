@@ -182,7 +182,8 @@ namespace ts {
     //!
     TSDUCKDLL inline bool IsCombiningDiacritical(UChar c)
     {
-        return (UCharacteristics(c) & CCHAR_CDIACRIT) != 0;
+        // No ASCII character is a combining diacritical, avoid the table lookup.
+        return c >= 0x80 && (UCharacteristics(c) & CCHAR_CDIACRIT) != 0;
     }
 
     //!
@@ -17,6 +17,15 @@
 #include "tsIntegerUtils.h"
 #include "tsUString.h"
 
+#if defined(TS_X86_64) || defined(_M_X64) || defined(__SSE2__)
+#define TS_UTF_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define TS_UTF_AVX2 1
+#include <immintrin.h>
+#endif
+
 // The UTF-8 Byte Order Mark
 const char *const ts::UString::UTF8_BOM = "\xEF\xBB\xBF";
 
@@ -76,6 +85,136 @@ const ::WCHAR *ts::UString::wc_str() const
 #endif
 
 
+//----------------------------------------------------------------------------
+// ASCII fast paths for the UTF-8 / UTF-16 conversions.
+// Convert the longest run of ASCII characters which fits in the output,
+// by blocks of 32 (AVX2), 16 (SSE2) or 8 (64-bit words) characters, then
+// one by one. Stop at the first non-ASCII character.
+//----------------------------------------------------------------------------
+
+namespace {
+	void ConvertASCII8To16(const char *&in, const char *in_end, ts::UChar *&out, ts::UChar *out_end)
+	{
+		size_t count = std::min<size_t>(in_end - in, out_end - out);
+		const char *const end = in + count;
+
+#if defined(TS_UTF_AVX2)
+		while (end - in >= 32)
+		{
+			const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+			if (_mm256_movemask_epi8(bytes) != 0)
+			{
+				break;
+			}
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+			in += 32;
+			out += 32;
+		}
+#endif
+
+#if defined(TS_UTF_SSE2)
+		const __m128i zero = _mm_setzero_si128();
+		while (end - in >= 16)
+		{
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+			if (_mm_movemask_epi8(bytes) != 0)
+			{
+				break;
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi8(bytes, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8), _mm_unpackhi_epi8(bytes, zero));
+			in += 16;
+			out += 16;
+		}
+#else
+		while (end - in >= 8)
+		{
+			uint64_t word = 0;
+			::memcpy(&word, in, 8);
+			if ((word & 0x8080808080808080) != 0)
+			{
+				break;
+			}
+			for (size_t i = 0; i < 8; ++i)
+			{
+				out[i] = ts::UChar(uint8_t(in[i]));
+			}
+			in += 8;
+			out += 8;
+		}
+#endif
+
+		while (in < end && (*in & 0x80) == 0)
+		{
+			*out++ = ts::UChar(*in++);
+		}
+	}
+
+	void ConvertASCII16To8(const ts::UChar *&in, const ts::UChar *in_end, char *&out, char *out_end)
+	{
+		size_t count = std::min<size_t>(in_end - in, out_end - out);
+		const ts::UChar *const end = in + count;
+
+#if defined(TS_UTF_AVX2)
+		const __m256i mask256 = _mm256_set1_epi16(int16_t(0xFF80));
+		while (end - in >= 32)
+		{
+			const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+			const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 16));
+			if (!_mm256_testz_si256(_mm256_or_si256(low, high), mask256))
+			{
+				break;
+			}
+			// The packing is done inside each 128-bit lane, reorder the 64-bit quarters.
+			const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(out), packed);
+			in += 32;
+			out += 32;
+		}
+#endif
+
+#if defined(TS_UTF_SSE2)
+		const __m128i mask = _mm_set1_epi16(int16_t(0xFF80));
+		const __m128i zero = _mm_setzero_si128();
+		while (end - in >= 16)
+		{
+			const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+			const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 8));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(low, high), mask), zero)) != 0xFFFF)
+			{
+				break;
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(low, high));
+			in += 16;
+			out += 16;
+		}
+#else
+		while (end - in >= 4)
+		{
+			uint64_t word = 0;
+			::memcpy(&word, in, 8);
+			if ((word & 0xFF80FF80FF80FF80) != 0)
+			{
+				break;
+			}
+			for (size_t i = 0; i < 4; ++i)
+			{
+				out[i] = char(in[i]);
+			}
+			in += 4;
+			out += 4;
+		}
+#endif
+
+		while (in < end && *in < 0x80)
+		{
+			*out++ = char(*in++);
+		}
+	}
+}
+
+
 //----------------------------------------------------------------------------
 // General routine to convert from UTF-16 to UTF-8.
 //----------------------------------------------------------------------------
@@ -87,6 +226,12 @@ void ts::UString::ConvertUTF16ToUTF8(const UChar *&inStart, const UChar *inEnd,
 
 	while (inStart < inEnd && outStart < outEnd)
 	{
+		// Bulk conversion of ASCII characters.
+		ConvertASCII16To8(inStart, inEnd, outStart, outEnd);
+		if (inStart >= inEnd || outStart >= outEnd)
+		{
+			break;
+		}
 
 		// Get current code point as 16-bit value.
 		code = *inStart++;
@@ -212,6 +357,12 @@ void ts::UString::ConvertUTF8ToUTF16(const char *&inStart, const char *inEnd, UC
 
 	while (inStart < inEnd && outStart < outEnd)
 	{
+		// Bulk conversion of ASCII characters.
+		ConvertASCII8To16(inStart, inEnd, outStart, outEnd);
+		if (inStart >= inEnd || outStart >= outEnd)
+		{
+			break;
+		}
 
 		// Get current code point at 8-bit value.
 		code = *inStart++ & 0xFF;
@@ -389,6 +540,14 @@ void ts::UString::toUTF8(std::string &utf8) const
 	utf8.resize(outStart - utf8.data());
 }
 
+size_t ts::UString::toUTF8(char *utf8, size_t size) const
+{
+	const UChar *inStart = data();
+	char *outStart = utf8;
+	ConvertUTF16ToUTF8(inStart, inStart + this->size(), outStart, outStart + size);
+	return outStart - utf8;
+}
+
 std::string ts::UString::toUTF8() const
 {
 	std::string utf8;
@@ -2147,6 +2306,12 @@ void ts::UString::format(const UChar *fmt, std::initializer_list<ArgMixIn> args)
 	ArgMixInContext ctx(*this, fmt, args);
 }
 
+void ts::UString::format(const UChar *fmt, const std::vector<ArgMixIn> &args)
+{
+	reserve(256);
+	ArgMixInContext ctx(*this, fmt, args.data(), args.data() + args.size());
+}
+
 ts::UString ts::UString::Format(const UChar *fmt, std::initializer_list<ArgMixIn> args)
 {
 	UString result;
@@ -2211,12 +2376,12 @@ void ts::UString::ArgMixContext::debug(const UString &message, UChar cmd) const
 // Analysis context of a Format string.
 //----------------------------------------------------------------------------
 
-ts::UString::ArgMixInContext::ArgMixInContext(UString &result, const UChar *fmt, std::initializer_list<ArgMixIn> args) :
+ts::UString::ArgMixInContext::ArgMixInContext(UString &result, const UChar *fmt, const ArgMixIn *begin, const ArgMixIn *end) :
 	ArgMixContext(fmt, true),
 	_result(result),
-	_arg(args.begin()),
-	_prev(args.end()),
-	_end(args.end())
+	_arg(begin),
+	_prev(end),
+	_end(end)
 {
 	// Loop into format, stop at each '%' sequence.
 	while (*_fmt != CHAR_NULL)
@@ -14,6 +14,7 @@
 #pragma once
 #include "tsUChar.h"
 #include "tsArgMix.h"
+#include <string_view>
 
 namespace ts {
 
@@ -407,6 +408,16 @@ namespace ts {
         //!
         static UString FromUTF8(const char* utf8, size_type count);
 
+        //!
+        //! Convert an UTF-8 string view into UTF-16.
+        //! @param [in] utf8 A string view in UTF-8 representation.
+        //! @return The equivalent UTF-16 string.
+        //!
+        static UString FromUTF8(std::string_view utf8)
+        {
+            return FromUTF8(utf8.data(), utf8.size());
+        }
+
         //!
         //! Convert an UTF-8 string into this object.
         //! @param [in] utf8 A string in UTF-8 representation.
@@ -417,6 +428,17 @@ namespace ts {
             return assignFromUTF8(utf8.data(), utf8.size());
         }
 
+        //!
+        //! Convert an UTF-8 string view into this object.
+        //! The memory of this object is reused, there is no allocation when its capacity is sufficient.
+        //! @param [in] utf8 A string view in UTF-8 representation.
+        //! @return A reference to this object.
+        //!
+        UString& assignFromUTF8(std::string_view utf8)
+        {
+            return assignFromUTF8(utf8.data(), utf8.size());
+        }
+
         //!
         //! Convert an UTF-8 string into this object.
         //! @param [in] utf8 Address of a nul-terminated string in UTF-8 representation.
@@ -444,6 +466,16 @@ namespace ts {
         //!
         void toUTF8(std::string& utf8) const;
 
+        //!
+        //! Convert this UTF-16 string into UTF-8 in a memory area, without allocation.
+        //! Stop when the output area is full. A character is never partially written.
+        //! @param [out] utf8 Address of the output UTF-8 memory area. No nul character is added.
+        //! @param [in] size Size in bytes of the output memory area. Three times the length
+        //! of this string is always sufficient.
+        //! @return The number of bytes written in @a utf8.
+        //!
+        size_t toUTF8(char* utf8, size_t size) const;
+
         //!
         //! General routine to convert from UTF-16 to UTF-8.
         //! Stop when the input buffer is empty or the output buffer is full, whichever comes first.
@@ -1871,6 +1903,15 @@ namespace ts {
             format(fmt.c_str(), args);
         }
 
+        //!
+        //! Format a string using a template and arguments which were collected at run time.
+        //! The formatted string is appended to this string object.
+        //! @param [in] fmt Format string with embedded '\%' sequences.
+        //! @param [in] args Vector of arguments to substitute in the format string.
+        //! @see format()
+        //!
+        void format(const UChar* fmt, const std::vector<ArgMixIn>& args);
+
         //!
         //! Format a string using a template and arguments.
         //! @param [in] fmt Format string with embedded '\%' sequences.
@@ -2366,10 +2407,22 @@ namespace ts {
             //! @param [in] fmt Format string with embedded '\%' sequences.
             //! @param [in] args List of arguments to substitute in the format string.
             //!
-            ArgMixInContext(UString& result, const UChar* fmt, std::initializer_list<ArgMixIn> args);
+            ArgMixInContext(UString& result, const UChar* fmt, std::initializer_list<ArgMixIn> args) :
+                ArgMixInContext(result, fmt, args.begin(), args.end())
+            {
+            }
+
+            //!
+            //! Constructor, format the string.
+            //! @param [in,out] result The formatted string is appended here
+            //! @param [in] fmt Format string with embedded '\%' sequences.
+            //! @param [in] begin First argument to substitute in the format string.
+            //! @param [in] end After the last argument to substitute in the format string.
+            //!
+            ArgMixInContext(UString& result, const UChar* fmt, const ArgMixIn* begin, const ArgMixIn* end);
 
         private:
-            typedef std::initializer_list<ts::ArgMixIn>::const_iterator ArgIterator;
+            typedef const ts::ArgMixIn* ArgIterator;
 
             UString&          _result;  //!< Result string.
             ArgIterator       _arg;     //!< Current argument.
@@ -134,3 +134,47 @@ void ts::CRC32::add(const void* data, size_t size)
         }
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Update the CRC32 of a data area after some bytes of it were modified.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Multiply two polynomials modulo the FCS-32 generator polynomial.
+    uint32_t MultiplyModulo(uint32_t a, uint32_t b)
+    {
+        uint32_t result = 0;
+        for (int bit = 31; bit >= 0; --bit) {
+            result = (result << 1) ^ ((result & 0x80000000) != 0 ? 0x04C11DB7 : 0);
+            if ((a & (uint32_t(1) << bit)) != 0) {
+                result ^= b;
+            }
+        }
+        return result;
+    }
+}
+
+uint32_t ts::CRC32::Update(uint32_t crc, const void* old_data, const void* new_data, size_t size, size_t trailing_size)
+{
+    // CRC32 of the difference, starting from a null register.
+    const uint8_t* op = reinterpret_cast<const uint8_t*>(old_data);
+    const uint8_t* np = reinterpret_cast<const uint8_t*>(new_data);
+    uint32_t diff = 0;
+    while (size-- > 0) {
+        diff = (diff << 8) ^ _fcstab_32[((diff >> 24) ^ *op++ ^ *np++) & 0xFF];
+    }
+
+    // Feeding a zero byte multiplies the register by x**8. Feeding the trailing
+    // bytes of the difference (all zeroes) multiplies it by x**(8*trailing_size).
+    uint32_t power = 0x00000100;
+    while (trailing_size > 0 && diff != 0) {
+        if ((trailing_size & 1) != 0) {
+            diff = MultiplyModulo(diff, power);
+        }
+        power = MultiplyModulo(power, power);
+        trailing_size >>= 1;
+    }
+
+    return crc ^ diff;
+}
@@ -68,6 +68,19 @@ namespace ts {
         bool operator==(const CRC32& c) const { return _fcs == c._fcs; }
         TS_UNEQUAL_OPERATOR(CRC32)
 
+        //!
+        //! Update the CRC32 of a data area after some bytes of it were modified, without
+        //! reprocessing the unmodified bytes. The CRC32 is affine in the data, so only the
+        //! difference between the old and new bytes needs to be shifted to the end of the area.
+        //! @param [in] crc CRC32 of the complete data area before the modification.
+        //! @param [in] old_data Address of the modified bytes, before modification.
+        //! @param [in] new_data Address of the modified bytes, after modification.
+        //! @param [in] size Number of modified bytes.
+        //! @param [in] trailing_size Number of bytes after the modified ones, up to the end of the data area.
+        //! @return The CRC32 of the complete data area after the modification.
+        //!
+        static uint32_t Update(uint32_t crc, const void* old_data, const void* new_data, size_t size, size_t trailing_size);
+
         //!
         //! Reset the CRC32 computation, restart a new computation.
         //!
@@ -185,14 +185,26 @@ void ts::ARIBCharset::Decoder::decodeAll(const uint8_t* data, size_t size)
             _str.push_back(_G[_GR] == &ALPHANUMERIC_MAP ? SPACE : IDEOGRAPHIC_SPACE);
         }
         else if (*_data >= GL_FIRST && *_data <= GL_LAST) {
-            // A left-side code.
-            _success = decodeOneChar(_G[_GL]) && _success;
-            // Restore locked shift if a single shift was used.
-            _GL = _lockedGL;
+            if (_GL == _lockedGL && IsDirectMap(_G[_GL])) {
+                // A run of left-side codes in a locked 1-byte character set.
+                decodeRun(_G[_GL], 0x00);
+            }
+            else {
+                // A left-side code.
+                _success = decodeOneChar(_G[_GL]) && _success;
+                // Restore locked shift if a single shift was used.
+                _GL = _lockedGL;
+            }
         }
         else if (*_data >= GR_FIRST && *_data <= GR_LAST) {
-            // A right-side code.
-            _success = decodeOneChar(_G[_GR]) && _success;
+            if (IsDirectMap(_G[_GR])) {
+                // A run of right-side codes in a 1-byte character set.
+                decodeRun(_G[_GR], 0x80);
+            }
+            else {
+                // A right-side code.
+                _success = decodeOneChar(_G[_GR]) && _success;
+            }
         }
         else if (match(LS0)) {
             // Locking shift G0.
@@ -318,6 +330,50 @@ bool ts::ARIBCharset::Decoder::decodeOneChar(const CharMap* gset)
 }
 
 
+//----------------------------------------------------------------------------
+// Decode a run of characters from a 1-byte single-row character set.
+//----------------------------------------------------------------------------
+
+bool ts::ARIBCharset::Decoder::IsDirectMap(const CharMap* gset)
+{
+    return gset != nullptr && !gset->byte2 && !gset->macro && gset->rows[0].first == 0 && gset->rows[0].count > 0 && gset->rows[0].rows != nullptr;
+}
+
+void ts::ARIBCharset::Decoder::decodeRun(const CharMap* gset, uint8_t area)
+{
+    // Direct lookup in the first row, no need to search the rows for each character.
+    const CharRow& row(*gset->rows[0].rows);
+    const UChar space = gset == &ALPHANUMERIC_MAP ? SPACE : IDEOGRAPHIC_SPACE;
+    const uint8_t first = GL_FIRST | area;
+    const uint8_t last = GL_LAST | area;
+
+    while (_size > 0) {
+        const uint8_t b = *_data;
+        if (b >= first && b <= last) {
+            const char32_t cp = row[b - first];
+            if (cp == 0) {
+                _success = false;
+            }
+            else if (cp < 0x10000) {
+                _str.push_back(UChar(cp));
+            }
+            else {
+                _str.append(static_cast<uint32_t>(cp));
+            }
+        }
+        else if (b == (SP | area)) {
+            // Always a space in all character sets.
+            _str.push_back(space);
+        }
+        else {
+            break;
+        }
+        _data++;
+        _size--;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Process an escape sequence starting at current byte.
 //----------------------------------------------------------------------------
@@ -235,6 +235,13 @@ namespace ts {
             // Decode one character and append to str. Update data and size.
             bool decodeOneChar(const CharMap* gset);
 
+            // Check if a character set is a 1-byte table with one single row, decoded by direct lookup.
+            static bool IsDirectMap(const CharMap* gset);
+
+            // Decode a run of characters and spaces from a direct map, in GL (area = 0x00) or GR (area = 0x80).
+            // Stop at the first byte which is outside the area. Update data and size.
+            void decodeRun(const CharMap* gset, uint8_t area);
+
             // Process an escape sequence starting at current byte (after ESC).
             bool escape();
 
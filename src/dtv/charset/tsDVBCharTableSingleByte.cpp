@@ -8,7 +8,6 @@
 
 #include "tsDVBCharTableSingleByte.h"
 #include "tsUString.h"
-#include "tsAlgorithm.h"
 
 // Static instances of corresponding DVB charsets.
 const ts::DVBCharset ts::DVBCharTableSingleByte::DVB_ISO_6937(u"ISO-6937", &RAW_ISO_6937);
@@ -33,34 +32,47 @@ const ts::DVBCharset ts::DVBCharTableSingleByte::DVB_ISO_8859_15(u"ISO-8859-15",
 //----------------------------------------------------------------------------
 
 ts::DVBCharTableSingleByte::DVBCharTableSingleByte(const UChar* name, uint32_t tableCode, std::initializer_list<uint16_t> init, std::initializer_list<uint8_t> revDiac) :
-    DVBCharTable(name, tableCode),
-    _upperCodePoints(init)
+    DVBCharTable(name, tableCode)
 {
     // Check the size of the upper code point table.
-    if (_upperCodePoints.size() != (0x100 - 0xA0)) {
+    if (init.size() != (0x100 - 0xA0)) {
         unregister();
-        throw InvalidCharset(UString::Format(u"%s (%d entries)", {name, _upperCodePoints.size()}));
+        throw InvalidCharset(UString::Format(u"%s (%d entries)", {name, init.size()}));
     }
 
-    // Code point to byte mapping for ASCII range
+    // Decoding and encoding tables for ASCII range.
     for (size_t i = 0x20; i <= 0x7E; i++) {
-        _bytesMap.insert(std::make_pair(UChar(i), uint8_t(i)));
+        _decodeTable[i] = uint16_t(i);
+        _encodeTable[i] = uint8_t(i);
     }
 
     // Control codes
-    _bytesMap.insert(std::make_pair(LINE_FEED, DVB_SINGLE_BYTE_CRLF));
-
-    // Code point to byte mapping for 0xA0-0xFF range
-    for (size_t i = 0; i < _upperCodePoints.size(); i++) {
-        if (_upperCodePoints[i] != 0) {
-            _bytesMap.insert(std::make_pair(UChar(_upperCodePoints[i]), uint8_t(0xA0 + i)));
+    _decodeTable[DVB_SINGLE_BYTE_CRLF] = LINE_FEED;
+    _encodeTable[LINE_FEED] = DVB_SINGLE_BYTE_CRLF;
+
+    // Decoding and encoding tables for 0xA0-0xFF range.
+    // When a code point is mapped twice, the first byte value is used for encoding.
+    size_t b = 0xA0;
+    for (auto cp : init) {
+        _decodeTable[b] = cp;
+        if (IsCombiningDiacritical(UChar(cp))) {
+            _decodeFlags[b] |= COMBINING;
+        }
+        if (cp != 0 && cp < _encodeTable.size()) {
+            if (_encodeTable[cp] == 0) {
+                _encodeTable[cp] = uint8_t(b);
+            }
         }
+        else if (cp != 0) {
+            _bytesMap.insert(std::make_pair(UChar(cp), uint8_t(b)));
+        }
+        b++;
     }
 
     // Combining diacritical marks which precede their base letter (and must be reversed from Unicode).
     for (auto it : revDiac) {
         if (it >= 0xA0) {
-            _reversedDiacritical.set(it - 0xA0);
+            _decodeFlags[it] |= REVERSED;
         }
     }
 }
@@ -72,53 +84,73 @@ ts::DVBCharTableSingleByte::DVBCharTableSingleByte(const UChar* name, uint32_t t
 
 bool ts::DVBCharTableSingleByte::decode(UString& str, const uint8_t* dvb, size_t dvbSize) const
 {
-    str.clear();
-    str.reserve(dvbSize);
+    // There is at most one character per byte, decode in place in the string.
     bool status = true;
-    bool reverseNext = false;  // after decoding next character, it shall be swapped with previous one.
     bool hasDiacritical = false;
+    if (dvb == nullptr) {
+        dvbSize = 0;
+    }
+    str.resize(dvbSize);
+    str.resize(decodeChars(&str[0], dvb, dvbSize, status, hasDiacritical));
 
-    for (; dvb != nullptr && dvbSize > 0; --dvbSize) {
-        // Get next byte
-        const uint8_t b = *dvb++;
-        // Convert it to a code point
-        uint16_t cp = 0;
-        if (b >= 0x20 && b <= 0x7E) {
-            cp = b; // ASCII range = identity
-        }
-        else if (b >= 0xA0) {
-            cp = _upperCodePoints[b - 0xA0];
-        }
-        else if (b == DVB_SINGLE_BYTE_CRLF) {
-            cp = LINE_FEED;
+    // If some diacritical mark was found, try to combine them.
+    if (hasDiacritical) {
+        str.combineDiacritical();
+    }
+    return status;
+}
+
+bool ts::DVBCharTableSingleByte::decode(UChar* buffer, size_t& count, const uint8_t* dvb, size_t dvbSize) const
+{
+    bool status = true;
+    bool hasDiacritical = false;
+    count = buffer == nullptr || dvb == nullptr ? 0 : decodeChars(buffer, dvb, dvbSize, status, hasDiacritical);
+    return status;
+}
+
+size_t ts::DVBCharTableSingleByte::decodeChars(UChar* buffer, const uint8_t* dvb, size_t dvbSize, bool& status, bool& hasDiacritical) const
+{
+    const uint8_t* const end = dvb + dvbSize;
+    UChar* out = buffer;
+    bool reverseNext = false;  // after decoding next character, it shall be swapped with previous one.
+
+    while (dvb < end) {
+        // Fast copy of ASCII runs, which are identical in all tables.
+        // The first character after a reversed diacritical mark takes the slow path.
+        if (!reverseNext) {
+            while (dvb < end && *dvb >= 0x20 && *dvb <= 0x7E) {
+                *out++ = UChar(*dvb++);
+            }
+            if (dvb >= end) {
+                break;
+            }
         }
-        // Add in result if no error.
+
+        // Convert next byte using the table.
+        const uint8_t b = *dvb++;
+        const UChar cp = UChar(_decodeTable[b]);
         if (cp == 0) {
             // Untranslatable character.
             status = false;
         }
-        else if (reverseNext && !str.empty()) {
+        else if (reverseNext && out > buffer) {
             // Insert decoded character before the previous one.
             // This is typically a letter coming after a reversable diacritical mark.
             // In Unicode, the letter must preceed the diacritical mark.
-            str.insert(str.length() - 1, 1, UChar(cp));
+            out[0] = out[-1];
+            out[-1] = cp;
+            out++;
         }
         else {
             // Simply add the decoded character.
-            str.push_back(UChar(cp));
+            *out++ = cp;
         }
         // Try the presence of diacritical, reversable or not.
-        hasDiacritical = hasDiacritical || IsCombiningDiacritical(UChar(cp));
+        hasDiacritical = hasDiacritical || (_decodeFlags[b] & COMBINING) != 0;
         // Shall we perform mark/letter swap next time?
-        reverseNext = b >= 0xA0 && _reversedDiacritical.test(b - 0xA0);
-    }
-
-    // If some diacritical mark was found, try to combine them.
-    if (hasDiacritical) {
-        str.combineDiacritical();
+        reverseNext = (_decodeFlags[b] & REVERSED) != 0;
     }
-
-    return status;
+    return out - buffer;
 }
 
 
@@ -128,9 +160,10 @@ bool ts::DVBCharTableSingleByte::decode(UString& str, const uint8_t* dvb, size_t
 
 bool ts::DVBCharTableSingleByte::canEncode(const UString& str, size_t start, size_t count) const
 {
-    for (size_t i = 0; i < str.length(); ++i) {
+    const size_t end = count < str.length() - std::min(start, str.length()) ? start + count : str.length();
+    for (size_t i = start; i < end; ++i) {
         const UChar cp = str[i];
-        if (!Contains(_bytesMap, cp) && cp != CARRIAGE_RETURN) {
+        if (encodeChar(cp) == 0 && cp != CARRIAGE_RETURN) {
             // Untranslatable character.
             return false;
         }
@@ -145,29 +178,39 @@ bool ts::DVBCharTableSingleByte::canEncode(const UString& str, size_t start, siz
 
 size_t ts::DVBCharTableSingleByte::encode(uint8_t*& buffer, size_t& size, const UString& str, size_t start, size_t count) const
 {
+    if (buffer == nullptr || start >= str.length()) {
+        return 0;
+    }
+
     uint8_t* const base = buffer;
-    size_t result = 0;
+    const UChar* in = str.data() + start;
+    const UChar* const end = in + std::min(count, str.length() - start);
 
     // Serialize characters as long as there is free space.
-    while (buffer != nullptr && size > 0 && start < str.length() && count > 0) {
-        const UChar cp = str[start];
-        const auto it = _bytesMap.find(cp);
-        if (cp != ts::CARRIAGE_RETURN && it != _bytesMap.end()) {
+    while (size > 0 && in < end) {
+        // Fast copy of ASCII runs, which are identical in all tables.
+        while (size > 0 && in < end && *in >= 0x20 && *in <= 0x7E) {
+            *buffer++ = uint8_t(*in++);
+            size--;
+        }
+        if (size == 0 || in >= end) {
+            break;
+        }
+        const uint8_t b = encodeChar(*in++);
+        if (b != 0) {
             // Encode character.
-            *buffer = it->second;
+            *buffer = b;
             size--;
             // Reverse letter and diacritical mark when necessary.
-            if (buffer > base && *buffer >= 0xA0 && _reversedDiacritical.test(*buffer - 0xA0)) {
+            if (buffer > base && (_decodeFlags[b] & REVERSED) != 0) {
                 // Reverse order of letter/mark into mark/letter.
                 std::swap(buffer[-1], buffer[0]);
             }
             buffer++;
         }
-        result++; // include CR characters, not physically encoded, but still taken into account.
-        start++;
-        count--;
+        // CR characters are not physically encoded, but still taken into account.
     }
-    return result;
+    return in - (str.data() + start);
 }
 
 
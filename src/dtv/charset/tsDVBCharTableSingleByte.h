@@ -73,6 +73,18 @@ namespace ts {
         virtual bool canEncode(const UString& str, size_t start = 0, size_t count = NPOS) const override;
         virtual size_t encode(uint8_t*& buffer, size_t& size, const UString& str, size_t start = 0, size_t count = NPOS) const override;
 
+        //!
+        //! Decode a DVB string into a caller-provided buffer, without memory allocation.
+        //! Unlike decode(UString&,...), combining diacritical marks are not merged with their
+        //! base letter. They are only reordered as in Unicode (letter first, then mark).
+        //! @param [out] buffer Address of the output buffer. It must contain at least @a dvbSize characters.
+        //! @param [out] count Returned number of characters in @a buffer.
+        //! @param [in] dvb Address of a DVB string, without leading table code.
+        //! @param [in] dvbSize Size in bytes of the DVB string.
+        //! @return True on success, false if some characters could not be decoded. They are skipped.
+        //!
+        bool decode(UChar* buffer, size_t& count, const uint8_t* dvb, size_t dvbSize) const;
+
     private:
         //!
         //! Private constructor since no external instance can be defined.
@@ -84,15 +96,32 @@ namespace ts {
         //!
         DVBCharTableSingleByte(const UChar* name, uint32_t tableCode, std::initializer_list<uint16_t> init, std::initializer_list<uint8_t> revDiac = std::initializer_list<uint8_t>());
 
-        // List of code points for byte values 0xA0-0xFF. Always contain 96 values.
-        const std::vector<uint16_t> _upperCodePoints {};
+        // Flags in the decoding table.
+        static constexpr uint8_t COMBINING = 0x01;  // Combining diacritical mark.
+        static constexpr uint8_t REVERSED  = 0x02;  // Combining mark which precedes its base letter.
 
-        // Reverse mapping for complete character set (key = code point, value = byte rep).
+        // Code point and flags for all byte values, zero code point means untranslatable.
+        std::array<uint16_t, 256> _decodeTable {};
+        std::array<uint8_t, 256> _decodeFlags {};
+
+        // Byte value of code points 0x0000-0x00FF, zero means not encodable.
+        std::array<uint8_t, 256> _encodeTable {};
+
+        // Reverse mapping for code points above 0x00FF (key = code point, value = byte rep).
         std::map<UChar, uint8_t> _bytesMap {};
 
-        // Bitmap of combining diacritical marks which precede their base letter (and must be reversed from Unicode).
-        // This only applies to byte values 0xA0-0xFF (96 values).
-        std::bitset<96> _reversedDiacritical {};
+        // Decode into a buffer of at least dvbSize characters, return the number of characters.
+        size_t decodeChars(UChar* buffer, const uint8_t* dvb, size_t dvbSize, bool& status, bool& hasDiacritical) const;
+
+        // Get the byte value of a code point, zero if not encodable.
+        uint8_t encodeChar(UChar cp) const
+        {
+            if (cp < _encodeTable.size()) {
+                return _encodeTable[cp];
+            }
+            const auto it = _bytesMap.find(cp);
+            return it == _bytesMap.end() ? 0 : it->second;
+        }
     };
 }
 
@@ -6,21 +6,42 @@
 //
 //----------------------------------------------------------------------------
 
-#define TS_AVCPARSER_CPP 1 // used in tsAVCParser.h
 #include "tsAVCParser.h"
 
 
+//----------------------------------------------------------------------------
+// Start code emulation prevention: sequences 00 00 03 are used when 00 00 00
+// or 00 00 01 would be present. In that case, the 00 00 is part of the raw byte
+// sequence payload (rbsp) but the 03 shall be discarded.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Find the next emulation prevention byte at or after index, return size if there is none.
+    size_t NextEmulationPrevention(const uint8_t* data, size_t size, size_t index)
+    {
+        while (index < size) {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(::memchr(data + index, 0x03, size - index));
+            if (p == nullptr) {
+                break;
+            }
+            index = p - data;
+            if (index >= 2 && data[index - 1] == 0x00 && data[index - 2] == 0x00) {
+                return index;
+            }
+            index++;
+        }
+        return size;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor.
 //----------------------------------------------------------------------------
 
-ts::AVCParser::AVCParser(const void* data, size_t size_in_bytes) :
-    _base(reinterpret_cast<const uint8_t*>(data)),
-    _end(_base + size_in_bytes),
-    _total_size(size_in_bytes),
-    _byte(_base)
+ts::AVCParser::AVCParser(const void* data, size_t size_in_bytes)
 {
-    ts_avcparser_assert_consistent();
+    reset(data, size_in_bytes);
 }
 
 
@@ -31,12 +52,26 @@ ts::AVCParser::AVCParser(const void* data, size_t size_in_bytes) :
 void ts::AVCParser::reset(const void* data, size_t size_in_bytes)
 {
     _base = reinterpret_cast<const uint8_t*>(data);
-    _end = _base + size_in_bytes;
-    _total_size = size_in_bytes;
-    _byte = _base;
-    _bit = 0;
+    _total_size = _base == nullptr ? 0 : size_in_bytes;
+    _rbsp.clear();
+
+    size_t index = NextEmulationPrevention(_base, _total_size, 0);
+    if (index >= _total_size) {
+        // Most common case, no emulation prevention byte, read in place.
+        _reader.reset(_base, _total_size);
+        return;
+    }
 
-    ts_avcparser_assert_consistent();
+    // Copy the RBSP in chunks between emulation prevention bytes.
+    _rbsp.reserve(_total_size);
+    size_t start = 0;
+    while (index < _total_size) {
+        _rbsp.append(_base + start, index - start);
+        start = index + 1;
+        index = NextEmulationPrevention(_base, _total_size, start);
+    }
+    _rbsp.append(_base + start, _total_size - start);
+    _reader.reset(_rbsp.data(), _rbsp.size());
 }
 
 
@@ -46,10 +81,17 @@ void ts::AVCParser::reset(const void* data, size_t size_in_bytes)
 
 void ts::AVCParser::reset(size_t byte_offset, size_t bit_offset)
 {
-    _byte = _base + std::min(byte_offset + bit_offset / 8, _total_size);
-    _bit = _byte == _end ? 0 : bit_offset % 8;
+    byte_offset = std::min(byte_offset + bit_offset / 8, _total_size);
+
+    // Convert the offset in the original memory area into an offset in the RBSP.
+    size_t removed = 0;
+    if (!_rbsp.empty()) {
+        for (size_t index = NextEmulationPrevention(_base, _total_size, 0); index < byte_offset; index = NextEmulationPrevention(_base, _total_size, index + 1)) {
+            removed++;
+        }
+    }
 
-    ts_avcparser_assert_consistent();
+    _reader.setPosition(8 * (byte_offset - removed) + (byte_offset < _total_size ? bit_offset % 8 : 0));
 }
 
 
@@ -59,8 +101,7 @@ void ts::AVCParser::reset(size_t byte_offset, size_t bit_offset)
 
 size_t ts::AVCParser::remainingBytes() const
 {
-    ts_avcparser_assert_consistent();
-    return _end - _byte - (_bit != 0);
+    return _reader.remainingBits() / 8;
 }
 
 
@@ -70,8 +111,7 @@ size_t ts::AVCParser::remainingBytes() const
 
 size_t ts::AVCParser::remainingBits() const
 {
-    ts_avcparser_assert_consistent();
-    return 8 * (_end - _byte) - _bit;
+    return _reader.remainingBits();
 }
 
 
@@ -82,61 +122,12 @@ size_t ts::AVCParser::remainingBits() const
 
 bool ts::AVCParser::rbspTrailingBits()
 {
-    ts_avcparser_assert_consistent();
-
-    const uint8_t* saved_byte = _byte;
-    size_t saved_bit = _bit;
-    uint8_t bit = 0;
-
-    bool valid = readBits(bit, 1) && bit == 1;
-    while (valid && !byteAligned()) {
-        valid = readBits(bit, 1) && bit == 0;
-    }
+    // rbsp_stop_one_bit followed by rbsp_alignment_zero_bit up to the byte boundary.
+    const size_t saved_position = _reader.position();
+    const size_t count = 8 - saved_position % 8;
+    const bool valid = _reader.remainingBits() >= count && _reader.readBits(count) == (uint64_t(1) << (count - 1));
     if (!valid) {
-        _byte = saved_byte;
-        _bit = saved_bit;
+        _reader.setPosition(saved_position);
     }
     return valid;
 }
-
-
-//----------------------------------------------------------------------------
-// Advance pointer to next byte boundary.
-//----------------------------------------------------------------------------
-
-void ts::AVCParser::nextByte()
-{
-    // Internal method, must be called when next byte is available.
-    assert(_byte >= _base);
-    assert(_byte < _end);
-    assert(_bit <= 8); // can be called internally when _bit == 8
-
-    // Next byte boundary
-    ++_byte;
-    _bit = 0;
-
-    // Process start code emulation prevention: sequences 00 00 03
-    // are used when 00 00 00 or 00 00 01 would be present. In that
-    // case, the 00 00 is part of the raw byte sequence payload (rbsp)
-    // but the 03 shall be discarded.
-    if (_byte < _end && *_byte == 0x03 && _byte > _base+1 && _byte[-1] == 0x00 && _byte[-2] == 0x00) {
-        // Skip 03 after 00 00
-        ++_byte;
-    }
-}
-
-
-//----------------------------------------------------------------------------
-// Advance pointer by one bit and return the bit value
-//----------------------------------------------------------------------------
-
-uint8_t ts::AVCParser::nextBit()
-{
-    ts_avcparser_assert_consistent();
-
-    uint8_t b = (*_byte >> (7 - _bit)) & 0x01;
-    if (++_bit > 7) {
-        nextByte();
-    }
-    return b;
-}
@@ -12,7 +12,8 @@
 //----------------------------------------------------------------------------
 
 #pragma once
-#include "tsPlatform.h"
+#include "tsBitReader.h"
+#include "tsByteBlock.h"
 
 namespace ts {
     //!
@@ -27,6 +28,12 @@ namespace ts {
     //! The naming of methods such as readBits(), i(), u(), etc. is
     //! directly transposed from ISO/IEC 14496-10, ITU-T Rec. H.264.
     //!
+    //! The start code emulation prevention bytes are removed from the whole memory
+    //! area at once, when the area is set. The resulting raw byte sequence payload
+    //! (RBSP) is then read up to 64 bits at a time using a BitReader. All bit counts
+    //! and bit positions apply to the RBSP. When the memory area contains no emulation
+    //! prevention byte, the RBSP is read in place without copy.
+    //!
     class TSDUCKDLL AVCParser
     {
         TS_NOBUILD_NOCOPY(AVCParser);
@@ -49,7 +56,7 @@ namespace ts {
 
         //!
         //! Reset parsing at the specified point.
-        //! @param [in] byte_offset Offset of first byte to analyze.
+        //! @param [in] byte_offset Offset of first byte to analyze, in the original memory area.
         //! @param [in] bit_offset Offset of first bit in first byte.
         //! The bit offset zero is the most significant bit.
         //!
@@ -71,13 +78,13 @@ namespace ts {
         //! Check end of stream.
         //! @return True if at end of stream.
         //!
-        bool endOfStream() const { return _byte >= _end; }
+        bool endOfStream() const { return _reader.remainingBits() == 0; }
 
         //!
         //! Check if the current bit pointer is on a byte boundary.
         //! @return True if the current bit pointer is on a byte boundary.
         //!
-        bool byteAligned() const { return _bit == 0; }
+        bool byteAligned() const { return _reader.byteAligned(); }
 
         //!
         //! Skip an rbsp_trailing_bits() as defined by ISO/EIC 14496-10 7.3.2.11.
@@ -162,28 +169,9 @@ namespace ts {
 
     private:
         const uint8_t* _base = nullptr;   // Base address of the memory area to parse.
-        const uint8_t* _end = nullptr;    // End address + 1 of the memory area.
         size_t         _total_size = 0;   // Size in bytes of the memory area.
-        const uint8_t* _byte = nullptr;   // Current byte pointer inside memory area.
-        size_t         _bit = 0;          // Current bit offset into *_byte
-
-        //! @cond nodoxygen
-        // A macro asserting the consistent state of this object.
-        // Must be a macro to preserve the use of assert().
-        #define ts_avcparser_assert_consistent() \
-            assert(_base != nullptr);            \
-            assert(_end == _base + _total_size); \
-            assert(_byte >= _base);              \
-            assert(_byte <= _end);               \
-            assert(_byte < _end || _bit == 0);   \
-            assert(_bit < 8)
-        //! @endcond
-
-        // Advance pointer to next byte boundary.
-        void nextByte();
-
-        // Advance pointer by one bit and return the bit value
-        uint8_t nextBit();
+        ByteBlock      _rbsp {};          // RBSP when emulation prevention bytes were removed.
+        BitReader      _reader {};        // Bit reader on the RBSP.
 
         // Extract Exp-Golomb-coded value using n bits.
         template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type* = nullptr>
@@ -199,15 +187,9 @@ namespace ts {
 template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type*>
 bool ts::AVCParser::nextBits(INT& val, size_t n)
 {
-    ts_avcparser_assert_consistent();
-
-    const uint8_t* saved_byte = _byte;
-    size_t saved_bit = _bit;
-
+    const size_t saved_position = _reader.position();
     bool result = readBits(val, n);
-    _byte = saved_byte;
-    _bit = saved_bit;
-
+    _reader.setPosition(saved_position);
     return result;
 }
 
@@ -215,34 +197,18 @@ bool ts::AVCParser::nextBits(INT& val, size_t n)
 template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type*>
 bool ts::AVCParser::readBits(INT& val, size_t n)
 {
-    ts_avcparser_assert_consistent();
-
-    val = 0;
-
     // Check that there are enough bits
-    if (remainingBits() < n) {
+    if (_reader.remainingBits() < n) {
+        val = 0;
         return false;
     }
 
-    // Read leading bits up to byte boundary
-    while (n > 0 && _bit != 0) {
-        val = INT(val << 1) | nextBit();
-        --n;
-    }
-
-    // Read complete bytes
-    while (n > 7) {
-        val = INT(val << 8) | *_byte;
-        nextByte();
-        n -= 8;
+    // Only the least significant bits fit in val when n is larger than the size of INT.
+    if (n > 64) {
+        _reader.skipBits(n - 64);
+        n = 64;
     }
-
-    // Read trailing bits
-    while (n > 0) {
-        val = INT(val << 1) | nextBit();
-        --n;
-    }
-
+    val = static_cast<INT>(_reader.readBits(n));
     return true;
 }
 
@@ -250,23 +216,11 @@ bool ts::AVCParser::readBits(INT& val, size_t n)
 template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type*>
 bool ts::AVCParser::expColomb(INT& val)
 {
-    ts_avcparser_assert_consistent();
-
     // See ISO/IEC 14496-10 section 9.1
-    val = 0;
-    int leading_zero_bits = -1;
-    for (uint8_t b = 0; b == 0; leading_zero_bits++) {
-        if (_byte >= _end) {
-            return false;
-        }
-        b = nextBit();
-    }
-    if (!readBits(val, leading_zero_bits)) {
-        return false;
-    }
-
-    val += (INT (1) << leading_zero_bits) - 1;
-    return true;
+    uint64_t code_num = 0;
+    const bool ok = _reader.readExpGolomb(code_num);
+    val = static_cast<INT>(code_num);
+    return ok;
 }
 
 // Signed integer Exp-Golomb-coded using n bits.
@@ -282,7 +236,3 @@ bool ts::AVCParser::se(INT& val)
         return false;
     }
 }
-
-#if !defined(TS_AVCPARSER_CPP)
-#undef ts_avcparser_assert_consistent
-#endif
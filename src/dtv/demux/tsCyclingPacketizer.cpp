@@ -70,47 +70,45 @@ void ts::CyclingPacketizer::addTable(DuckContext& duck, const AbstractTable& tab
 
 
 //----------------------------------------------------------------------------
-// Check if this section shall be inserted after some other one.
+// Get the lookup key of the section.
 //----------------------------------------------------------------------------
 
-bool ts::CyclingPacketizer::SectionDesc::insertAfter(const SectionDesc& other) const
+uint32_t ts::CyclingPacketizer::SectionDesc::key() const
 {
-    // Insert sections according due time when due times are different.
-    if (due_packet != other.due_packet) {
-        return due_packet > other.due_packet;
+    const Section& sect(*section);
+    if (sect.isLongSection()) {
+        return (uint32_t(sect.tableId()) << 24) | (uint32_t(sect.tableIdExtension()) << 8) | sect.sectionNumber();
     }
+    else {
+        return uint32_t(sect.tableId()) << 24;
+    }
+}
 
-    // At this point, the two sections have the same due time.
-    // Decide insertion order based on the sections contents.
-    const Section& sec1(*section);
-    const Section& sec2(*(other.section));
 
-    if (sec1.tableId() != sec2.tableId() || (sec1.isLongSection() && sec1.tableIdExtension() != sec2.tableIdExtension())) {
-        // Sections do not belong to the same table => insert before
-        return false;
-    }
-    else if (last_cycle > other.last_cycle) {
-        // This section in one cycle in advance => insert after
-        return true;
-    }
-    else if (last_cycle < other.last_cycle) {
-        // This section in one cycle late => insert before
-        return false;
+//----------------------------------------------------------------------------
+// Heap ordering: true if the section a shall be sent after the section b.
+//----------------------------------------------------------------------------
+
+bool ts::CyclingPacketizer::sendAfter(const SectionDescPtr& a, const SectionDescPtr& b)
+{
+    // Send sections according to due time when due times are different.
+    if (a->due_packet != b->due_packet) {
+        return a->due_packet > b->due_packet;
     }
-    else if (sec1.isShortSection() || sec2.isShortSection() || sec1.tableIdExtension() != sec2.tableIdExtension()) {
-        // Both sections have the same due packet and in the same cycle. They also have the same table id.
-        // Either they are short equivalent sections or do not have the same table id ext => insert after.
-        return true;
+    // Same due time: a section which is one cycle in advance is sent after.
+    else if (a->last_cycle != b->last_cycle) {
+        return a->last_cycle > b->last_cycle;
     }
+    // Same due time and cycle: keep scheduling order. Since the sections of a table
+    // are added in order, this keeps the order of section numbers in a table.
     else {
-        // Same due packet, same cycle, same long table => insert in order of section number.
-        return sec1.sectionNumber() >= sec2.sectionNumber();
+        return a->sched_order > b->sched_order;
     }
 }
 
 
 //----------------------------------------------------------------------------
-// Insert a scheduled section in the list, sorted by due_packet.
+// Insert a scheduled section in the heap, sorted by due_packet.
 //----------------------------------------------------------------------------
 
 void ts::CyclingPacketizer::addScheduledSection(const SectionDescPtr& sect)
@@ -120,11 +118,34 @@ void ts::CyclingPacketizer::addScheduledSection(const SectionDescPtr& sect)
                   sect->section->sectionNumber(), sect->section->lastSectionNumber(),
                   sect->last_cycle, sect->last_packet, sect->due_packet});
 
-    auto it = _sched_sections.begin();
-    while (it != _sched_sections.end() && sect->insertAfter(**it)) {
-        ++it;
-    }
-    _sched_sections.insert(it, sect);
+    sect->sched_order = _sched_order++;
+    _sched_sections.push_back(sect);
+    std::push_heap(_sched_sections.begin(), _sched_sections.end(), sendAfter);
+}
+
+
+//----------------------------------------------------------------------------
+// Remove the next due scheduled section from the heap.
+//----------------------------------------------------------------------------
+
+ts::CyclingPacketizer::SectionDescPtr ts::CyclingPacketizer::popScheduledSection()
+{
+    assert(!_sched_sections.empty());
+    std::pop_heap(_sched_sections.begin(), _sched_sections.end(), sendAfter);
+    const SectionDescPtr sp(_sched_sections.back());
+    _sched_sections.pop_back();
+    return sp;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a section is in the scheduled heap.
+//----------------------------------------------------------------------------
+
+bool ts::CyclingPacketizer::isScheduled(const SectionDesc& desc) const
+{
+    // Same rule as in addSection() and setBitRate().
+    return desc.repetition != 0 && _bitrate != 0;
 }
 
 
@@ -148,62 +169,136 @@ void ts::CyclingPacketizer::addSection(const SectionPtr& sect, MilliSecond rep_r
             _sched_packets += sect->packetCount();
         }
 
+        _index.insert(std::make_pair(desc->key(), desc));
         _section_count++;
         _remain_in_cycle++;
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Replace sections in place.
+//----------------------------------------------------------------------------
+
+void ts::CyclingPacketizer::replaceSection(const SectionPtr& sect, MilliSecond rep_rate)
+{
+    if (sect.isNull() || !sect->isValid()) {
+        return;
+    }
+
+    SectionDesc tmp(sect, rep_rate);
+    const auto it = _index.find(tmp.key());
+    if (it == _index.end()) {
+        addSection(sect, rep_rate);
+    }
+    else {
+        // Keep the schedule of the previous section, only the content changes.
+        SectionDesc& desc(*it->second);
+        if (isScheduled(desc)) {
+            assert(_sched_packets >= desc.section->packetCount());
+            _sched_packets = _sched_packets - desc.section->packetCount() + sect->packetCount();
+        }
+        desc.section = sect;
+    }
+}
+
+void ts::CyclingPacketizer::replaceTable(const BinaryTable& table, MilliSecond rep_rate)
+{
+    if (table.sectionCount() == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < table.sectionCount(); ++i) {
+        replaceSection(table.sectionAt(i), rep_rate);
+    }
+
+    // Remove sections beyond the last section number of the new version of the table.
+    const SectionPtr first(table.sectionAt(0));
+    if (!first.isNull() && first->isLongSection() && first->lastSectionNumber() < 0xFF) {
+        removeSections(table.tableId(), table.tableIdExtension(), uint8_t(first->lastSectionNumber() + 1), 0xFF, true);
+    }
+}
+
+void ts::CyclingPacketizer::replaceTable(DuckContext& duck, const AbstractTable& table, MilliSecond rep_rate)
+{
+    BinaryTable bin;
+    table.serialize(duck, bin);
+    replaceTable(bin, rep_rate);
+}
+
+
 //----------------------------------------------------------------------------
 // Remove all sections with the specified table id.
 //----------------------------------------------------------------------------
 
 void ts::CyclingPacketizer::removeSections(TID tid)
 {
-    removeSections(_sched_sections, tid, 0, 0, false, false, true);
-    removeSections(_other_sections, tid, 0, 0, false, false, false);
+    removeSections(tid, 0, 0x00, 0xFF, false);
 }
 
 void ts::CyclingPacketizer::removeSections(TID tid, uint16_t tid_ext)
 {
-    removeSections(_sched_sections, tid, tid_ext, 0, true, false, true);
-    removeSections(_other_sections, tid, tid_ext, 0, true, false, false);
+    removeSections(tid, tid_ext, 0x00, 0xFF, true);
 }
 
 void ts::CyclingPacketizer::removeSections(TID tid, uint16_t tid_ext, uint8_t sec_number)
 {
-    removeSections(_sched_sections, tid, tid_ext, sec_number, true, true, true);
-    removeSections(_other_sections, tid, tid_ext, sec_number, true, true, false);
+    removeSections(tid, tid_ext, sec_number, sec_number, true);
 }
 
 
 //----------------------------------------------------------------------------
-// Remove all sections with the specified tid/tid_ext in the specified list.
+// Remove all sections with the specified tid/tid_ext and a range of section numbers.
 //----------------------------------------------------------------------------
 
-void ts::CyclingPacketizer::removeSections(SectionDescList& list, TID tid, uint16_t tid_ext, uint8_t sec_number, bool use_tid_ext, bool use_sec_number, bool scheduled)
+void ts::CyclingPacketizer::removeSections(TID tid, uint16_t tid_ext, uint8_t first_sec, uint8_t last_sec, bool use_tid_ext)
 {
-    for (auto it = list.begin(); it != list.end(); ) {
-        const SectionDescPtr& sp(*it);
-        const Section& sect(*sp->section);
-        if (sect.tableId() == tid && (!use_tid_ext || sect.tableIdExtension() == tid_ext) && (!use_sec_number || sect.sectionNumber() == sec_number)) {
-            // Section match, remove it
-            assert(_section_count > 0);
-            _section_count--;
-            if (sp->last_cycle != _current_cycle) {
-                assert(_remain_in_cycle > 0);
-                _remain_in_cycle--;
-            }
-            if (scheduled) {
-                assert(_sched_packets >= sect.packetCount());
-                _sched_packets -= sect.packetCount();
-            }
-            it = list.erase(it);
+    // The index is sorted by tid, tid_ext, sec_number: locate the range of matching keys.
+    const uint32_t first = (uint32_t(tid) << 24) | (use_tid_ext ? uint32_t(tid_ext) << 8 : 0) | first_sec;
+    const uint32_t last = (uint32_t(tid) << 24) | (use_tid_ext ? uint32_t(tid_ext) << 8 : 0x00FFFF00) | last_sec;
+
+    bool removed = false;
+    for (auto it = _index.lower_bound(first); it != _index.end() && it->first <= last; ) {
+        const Section& sect(*it->second->section);
+        if (sect.tableId() == tid && (!use_tid_ext || sect.tableIdExtension() == tid_ext) && sect.sectionNumber() >= first_sec && sect.sectionNumber() <= last_sec) {
+            // Section match, remove it. Its content is cleared here and the
+            // section descriptor is removed from the lists below.
+            forgetSection(*it->second, isScheduled(*it->second));
+            it->second->section.clear();
+            it = _index.erase(it);
+            removed = true;
         }
         else {
             ++it;
         }
     }
+
+    if (removed) {
+        // Sections without content are the removed ones.
+        const auto is_removed = [](const SectionDescPtr& sp) { return sp->section.isNull(); };
+        _other_sections.remove_if(is_removed);
+        _sched_sections.erase(std::remove_if(_sched_sections.begin(), _sched_sections.end(), is_removed), _sched_sections.end());
+        std::make_heap(_sched_sections.begin(), _sched_sections.end(), sendAfter);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Update the counters when a section is removed.
+//----------------------------------------------------------------------------
+
+void ts::CyclingPacketizer::forgetSection(const SectionDesc& desc, bool scheduled)
+{
+    assert(_section_count > 0);
+    _section_count--;
+    if (desc.last_cycle != _current_cycle) {
+        assert(_remain_in_cycle > 0);
+        _remain_in_cycle--;
+    }
+    if (scheduled) {
+        assert(_sched_packets >= desc.section->packetCount());
+        _sched_packets -= desc.section->packetCount();
+    }
 }
 
 
@@ -218,6 +313,7 @@ void ts::CyclingPacketizer::removeAll()
     _sched_packets = 0;
     _sched_sections.clear();
     _other_sections.clear();
+    _index.clear();
 }
 
 
@@ -249,8 +345,7 @@ void ts::CyclingPacketizer::setBitRate(const BitRate& new_bitrate)
         // Bitrate now unknown, unable to schedule sections, move them all
         // into the list of unscheduled sections.
         while (!_sched_sections.empty()) {
-            _other_sections.push_back(_sched_sections.front());
-            _sched_sections.pop_front();
+            _other_sections.push_back(popScheduledSection());
         }
         _sched_packets = 0;
     }
@@ -277,15 +372,11 @@ void ts::CyclingPacketizer::setBitRate(const BitRate& new_bitrate)
     }
     else {
         // Old and new bitrate not null. Compute new due packet for all
-        // scheduled sections and re-sort list according to new due packet.
-        SectionDescList tmp_list;
-        tmp_list.swap(_sched_sections);
-        while (!tmp_list.empty()) {
-            SectionDesc* sp(tmp_list.back().pointer());
+        // scheduled sections and re-sort the heap according to new due packet.
+        for (const auto& sp : _sched_sections) {
             sp->due_packet = sp->last_packet + PacketDistance(new_bitrate, sp->repetition);
-            addScheduledSection(tmp_list.back());
-            tmp_list.pop_back();
         }
+        std::make_heap(_sched_sections.begin(), _sched_sections.end(), sendAfter);
     }
 
     // Remember new bitrate
@@ -302,6 +393,7 @@ void ts::CyclingPacketizer::provideSection(SectionCounter counter, SectionPtr& s
 {
     const PacketCounter current_packet(packetCount());
     SectionDescPtr sp(nullptr);
+    bool reschedule = false;
 
     // Cycle end is initially undefined.
     // Will be defined only if end of cycle encountered.
@@ -323,13 +415,10 @@ void ts::CyclingPacketizer::provideSection(SectionCounter counter, SectionPtr& s
          spp->last_packet + spp->section->packetCount() + _sched_packets < current_packet);
 
     if (!force_unscheduled && !_sched_sections.empty() && _sched_sections.front()->due_packet <= current_packet) {
-        // One scheduled section is ready
-        sp = _sched_sections.front();
-        _sched_sections.pop_front();
-        // Reschedule the section. Make sure we add at least one packet to
-        // ensure that all scheduled sections may pass.
-        sp->due_packet = current_packet + std::max(PacketCounter(1), PacketDistance(_bitrate, sp->repetition));
-        addScheduledSection(sp);
+        // One scheduled section is ready. It is rescheduled below, once its
+        // last_cycle is updated, because last_cycle is a key of the heap.
+        sp = popScheduledSection();
+        reschedule = true;
     }
     else if (!_other_sections.empty()) {
         // An unscheduled section is ready
@@ -360,6 +449,12 @@ void ts::CyclingPacketizer::provideSection(SectionCounter counter, SectionPtr& s
                 _remain_in_cycle = _section_count;
             }
         }
+        if (reschedule) {
+            // Reschedule the section. Make sure we add at least one packet to
+            // ensure that all scheduled sections may pass.
+            sp->due_packet = current_packet + std::max(PacketCounter(1), PacketDistance(_bitrate, sp->repetition));
+            addScheduledSection(sp);
+        }
     }
 }
 
@@ -419,8 +514,10 @@ std::ostream& ts::CyclingPacketizer::display(std::ostream& strm) const
         << "  Stored sections: " << _section_count << std::endl
         << "  Scheduled sections: " << _sched_sections.size() << std::endl
         << "  Scheduled packets max: " << _sched_packets << std::endl;
-    for (auto& it : _sched_sections) {
-        it->display(duck(), strm);
+    SectionDescHeap sorted(_sched_sections);
+    std::sort_heap(sorted.begin(), sorted.end(), sendAfter);
+    for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
+        (*it)->display(duck(), strm);
     }
     strm << "  Unscheduled sections: " << _other_sections.size() << std::endl;
     for (auto& it : _other_sections) {
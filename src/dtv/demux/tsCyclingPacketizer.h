@@ -143,6 +143,36 @@ namespace ts {
         //!
         void addTable(DuckContext& duck, const AbstractTable& table, MilliSecond repetition_rate = 0);
 
+        //!
+        //! Replace one section in the packetizer.
+        //! If a section with the same table id, table id extension and section number is already
+        //! present, its content is replaced in place and it keeps its position in the schedule.
+        //! Otherwise, the section is added.
+        //! @param [in] section A smart pointer to the new section.
+        //! @param [in] repetition_rate Repetition rate of the section in milliseconds,
+        //! used only when the section is added.
+        //!
+        void replaceSection(const SectionPtr& section, MilliSecond repetition_rate = 0);
+
+        //!
+        //! Replace all sections of a binary table in the packetizer, typically a new version of the table.
+        //! Existing sections are replaced in place, new sections are added and sections with the same
+        //! table id and table id extension which are beyond the last section number of the new table are removed.
+        //! Unlike removeSections() followed by addTable(), the schedule of the other sections is not rebuilt.
+        //! @param [in] table A binary table to packetize.
+        //! @param [in] repetition_rate Repetition rate of the new sections in milliseconds.
+        //!
+        void replaceTable(const BinaryTable& table, MilliSecond repetition_rate = 0);
+
+        //!
+        //! Replace all sections of a typed table in the packetizer.
+        //! @param [in,out] duck TSDuck execution context.
+        //! @param [in] table A table to packetize.
+        //! @param [in] repetition_rate Repetition rate of the new sections in milliseconds.
+        //! @see replaceTable(const BinaryTable&, MilliSecond)
+        //!
+        void replaceTable(DuckContext& duck, const AbstractTable& table, MilliSecond repetition_rate = 0);
+
         //!
         //! Remove all sections with the specified table id.
         //! If one such section is currently being packetized, the rest of the section will be packetized.
@@ -205,12 +235,13 @@ namespace ts {
             PacketCounter  last_packet = 0; // Packet index of last time the section was sent
             PacketCounter  due_packet = 0;  // Packet index of next time
             SectionCounter last_cycle = 0;  // Cycle index of last time the section was sent
+            uint64_t       sched_order = 0; // Scheduling order, to break ties between identical due packets
 
             // Constructor
             SectionDesc(const SectionPtr& sec, MilliSecond rep);
 
-            // Check if this section shall be inserted after some other one.
-            bool insertAfter(const SectionDesc& other) const;
+            // Get the lookup key of the section (table id, table id extension, section number).
+            uint32_t key() const;
 
             // Display the internal state, mainly for debug.
             std::ostream& display(const DuckContext&, std::ostream&) const;
@@ -222,12 +253,24 @@ namespace ts {
         // List of sections
         typedef std::list <SectionDescPtr> SectionDescList;
 
+        // Binary heap of scheduled sections, the next due section is at front.
+        // Inserting or rescheduling a section is O(log n), unlike a sorted list.
+        typedef std::vector <SectionDescPtr> SectionDescHeap;
+
+        // Heap ordering: true if the section a shall be sent after the section b.
+        static bool sendAfter(const SectionDescPtr& a, const SectionDescPtr& b);
+
+        // Index of all sections by key, used to replace sections in place.
+        typedef std::multimap <uint32_t, SectionDescPtr> SectionDescIndex;
+
         // Private members:
         StuffingPolicy  _stuffing {StuffingPolicy::NEVER};
         BitRate         _bitrate = 0;
         size_t          _section_count = 0;      // Number of sections in the 2 lists
-        SectionDescList _sched_sections {};      // Scheduled sections, with repetition rates
+        SectionDescHeap _sched_sections {};      // Scheduled sections, with repetition rates
         SectionDescList _other_sections {};      // Unscheduled sections
+        SectionDescIndex _index {};              // All sections in the 2 lists, by key
+        uint64_t        _sched_order = 0;        // Counter for SectionDesc::sched_order
         PacketCounter   _sched_packets = 0;      // Size in TS packets of all sections in _sched_sections
         SectionCounter  _current_cycle {1};      // Cycle number (start at 1, always increasing)
         size_t          _remain_in_cycle = 0;    // Number of unsent sections in this cycle
@@ -235,11 +278,20 @@ namespace ts {
 
         static constexpr SectionCounter UNDEFINED = ~SectionCounter(0);
 
-        // Insert a scheduled section in the list, sorted by due_packet.
+        // Insert a scheduled section in the heap, sorted by due_packet.
         void addScheduledSection(const SectionDescPtr&);
 
-        // Remove all sections with the specified tid/tid_ext in the specified list.
-        void removeSections(SectionDescList&, TID tid, uint16_t tid_ext, uint8_t sec_number, bool use_tid_ext, bool use_sec_number, bool scheduled);
+        // Remove the next due scheduled section from the heap.
+        SectionDescPtr popScheduledSection();
+
+        // Check if a section is in the scheduled heap.
+        bool isScheduled(const SectionDesc&) const;
+
+        // Remove all sections with the specified tid/tid_ext and a range of section numbers.
+        void removeSections(TID tid, uint16_t tid_ext, uint8_t first_sec, uint8_t last_sec, bool use_tid_ext);
+
+        // Update the counters when a section is removed.
+        void forgetSection(const SectionDesc&, bool scheduled);
 
         // Inherited from SectionProviderInterface
         virtual void provideSection(SectionCounter, SectionPtr&) override;
@@ -200,6 +200,7 @@ void ts::SectionDemux::immediateReset()
 {
 	SuperClass::immediateReset();
 	_pids.clear();
+	_dedup_history.clear();
 }
 
 void ts::SectionDemux::immediateResetPID(PID pid)
@@ -459,6 +460,37 @@ void ts::SectionDemux::processPacket(const TSPacket &pkt)
 			section_ok = false;
 		}
 
+		// Fast path for repeated sections: a long section which is identical to the last one with
+		// the same PID, TID, TIDext and section number is recognized from its size and CRC32 and
+		// skipped without building a Section. This is not done if the section is still expected
+		// to complete a table which is currently being collected.
+		const bool dedup = section_ok && _dedup_sections && long_header;
+		uint64_t dedup_key = 0;
+		uint64_t dedup_fingerprint = 0;
+		if (dedup)
+		{
+			dedup_key = DedupKey(pid, etid, section_number);
+			dedup_fingerprint = DedupFingerprint(ts_start, section_length);
+			const auto dedup_it = _dedup_history.find(dedup_key);
+			if (dedup_it != _dedup_history.end() && dedup_it->second == dedup_fingerprint)
+			{
+				const auto tc_it = pc.tids.find(etid);
+				const bool expected =
+					tc_it != pc.tids.end() &&
+					tc_it->second.version == version &&
+					tc_it->second.sect_expected == size_t(last_section_number) + 1 &&
+					tc_it->second.sects[section_number].isNull();
+				if (!expected)
+				{
+					// Identical section, move to next section in the buffer.
+					ts_start += section_length;
+					ts_size -= section_length;
+					pusi_pkt_index = _packet_count;
+					continue;
+				}
+			}
+		}
+
 		if (section_ok)
 		{
 
@@ -528,6 +560,11 @@ void ts::SectionDemux::processPacket(const TSPacket &pkt)
 					_status.wrong_crc++;  // only possible error (hum?)
 					section_ok = false;
 				}
+				else if (dedup)
+				{
+					// Remember this valid section for deduplication.
+					_dedup_history[dedup_key] = dedup_fingerprint;
+				}
 			}
 
 			// Mark that we are in the context of a table or section handler.
@@ -141,6 +141,40 @@ namespace ts {
             _track_invalid_version = on;
         }
 
+        //!
+        //! Enable / disable the deduplication of identical sections.
+        //!
+        //! Most PSI/SI sections are repeated unchanged many times. When deduplication is enabled,
+        //! the demux remembers the CRC32 (the last four bytes) and the size of the last long section
+        //! for each PID, TID, TIDext and section number. A section which is identical to the last one
+        //! is recognized from its payload bytes and ignored, without building a Section object or
+        //! checking its CRC32. It is reported neither to the section handler nor to the table handler.
+        //!
+        //! The deduplication history is kept when a PID is reset using resetPID(), so that an application
+        //! which resets a PID after each table to get the next occurrence is notified only when the content
+        //! changes. The history is cleared by reset() and resetSectionDeduplication().
+        //!
+        //! Short sections are never deduplicated since they have no CRC32.
+        //! @param [in] on Deduplicate identical sections. This is false by default.
+        //!
+        void setSectionDeduplication(bool on)
+        {
+            _dedup_sections = on;
+            if (!on) {
+                _dedup_history.clear();
+            }
+        }
+
+        //!
+        //! Forget all sections which were recorded for deduplication.
+        //! The next occurrence of each section will be processed again.
+        //! @see setSectionDeduplication()
+        //!
+        void resetSectionDeduplication()
+        {
+            _dedup_history.clear();
+        }
+
         //!
         //! Set the log level for messages reporting transport stream errors in demux.
         //! By default, the log level is Severity::Debug.
@@ -274,6 +308,18 @@ namespace ts {
         // If fill_eit is true, add missing sections in EIT.
         void fixAndFlush(bool pack, bool fill_eit);
 
+        // Build the key of a section in the deduplication history.
+        static uint64_t DedupKey(PID pid, const ETID& etid, uint8_t section_number)
+        {
+            return (uint64_t(pid) << 32) | (uint64_t(etid.tid()) << 24) | (uint64_t(etid.tidExt()) << 8) | section_number;
+        }
+
+        // Build the fingerprint of a complete long section: size and CRC32 (last four bytes).
+        static uint64_t DedupFingerprint(const uint8_t* section, size_t size)
+        {
+            return (uint64_t(size) << 32) | GetUInt32(section + size - SECTION_CRC32_SIZE);
+        }
+
         // Private members:
         TableHandlerInterface*          _table_handler = nullptr;
         SectionHandlerInterface*        _section_handler = nullptr;
@@ -283,6 +329,8 @@ namespace ts {
         bool   _get_current = true;
         bool   _get_next = false;
         bool   _track_invalid_version = false;
+        bool   _dedup_sections = false;
+        std::unordered_map<uint64_t,uint64_t> _dedup_history {};  // key: DedupKey(), value: DedupFingerprint()
         int    _ts_error_level {Severity::Debug};
     };
 }
@@ -0,0 +1,378 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsTimelineDemux.h"
+#include "tsBinaryTable.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsTSPacket.h"
+#include "tsTSPacketWindow.h"
+
+// Scale of M2TS time stamps (30 bits).
+#define M2TS_SCALE (uint64_t(1) << 30)
+
+
+//----------------------------------------------------------------------------
+// Extension of a wrapping clock to a 64-bit timeline.
+//----------------------------------------------------------------------------
+
+int64_t ts::TimelineDemux::ClockExtender::Distance(uint64_t from, uint64_t to, uint64_t scale)
+{
+    // Forward distance, modulo scale, then fold the upper half as negative.
+    const uint64_t forward = to >= from ? to - from : scale + to - from;
+    return forward <= scale / 2 ? int64_t(forward) : int64_t(forward) - int64_t(scale);
+}
+
+void ts::TimelineDemux::ClockExtender::reset()
+{
+    _last = 0;
+    _extended = _first = 0;
+    _count = _discontinuities = 0;
+}
+
+int64_t ts::TimelineDemux::ClockExtender::extend(uint64_t value) const
+{
+    return _count == 0 ? int64_t(value) : _extended + Distance(_last, value, _scale);
+}
+
+int64_t ts::TimelineDemux::ClockExtender::set(uint64_t value)
+{
+    if (value < _scale) {
+        _extended = extend(value);
+        if (_count++ == 0) {
+            _first = _extended;
+        }
+        _last = value;
+    }
+    return _extended;
+}
+
+int64_t ts::TimelineDemux::ClockExtender::rebase(uint64_t value)
+{
+    if (value < _scale) {
+        if (_count++ == 0) {
+            _first = _extended = int64_t(value);
+        }
+        else {
+            // Keep _extended, the timeline continues from the last value.
+            _discontinuities++;
+        }
+        _last = value;
+    }
+    return _extended;
+}
+
+
+//----------------------------------------------------------------------------
+// Linear regression of input time against PCR.
+//----------------------------------------------------------------------------
+
+void ts::TimelineDemux::ClockRegression::reset()
+{
+    _pcr0 = _time0 = 0;
+    _count = 0;
+    _sum_x = _sum_y = _sum_xx = _sum_xy = 0;
+}
+
+void ts::TimelineDemux::ClockRegression::addSample(int64_t pcr, int64_t time)
+{
+    if (_count == 0) {
+        _pcr0 = pcr;
+        _time0 = time;
+    }
+    const double x = double(pcr - _pcr0);
+    const double y = double(time - _time0);
+    _count++;
+    _sum_x += x;
+    _sum_y += y;
+    _sum_xx += x * x;
+    _sum_xy += x * y;
+}
+
+bool ts::TimelineDemux::ClockRegression::isValid() const
+{
+    return _count >= 2 && _count * _sum_xx - _sum_x * _sum_x > 0;
+}
+
+double ts::TimelineDemux::ClockRegression::slope() const
+{
+    if (!isValid()) {
+        return 1.0;
+    }
+    const double n = double(_count);
+    return (n * _sum_xy - _sum_x * _sum_y) / (n * _sum_xx - _sum_x * _sum_x);
+}
+
+int64_t ts::TimelineDemux::ClockRegression::timeOf(int64_t pcr) const
+{
+    if (_count == 0) {
+        return 0;
+    }
+    // The regression line goes through the mean point.
+    const double n = double(_count);
+    const double x = double(pcr - _pcr0);
+    return _time0 + int64_t(_sum_y / n + slope() * (x - _sum_x / n));
+}
+
+
+//----------------------------------------------------------------------------
+// Construction and reset.
+//----------------------------------------------------------------------------
+
+ts::TimelineDemux::TimelineDemux(DuckContext& duck, const PIDSet& pid_filter) :
+    SuperClass(duck, pid_filter),
+    _section_demux(_duck, this)
+{
+    // Analyze the PAT, to get the PMT's, to get the programs.
+    _section_demux.addPID(PID_PAT);
+}
+
+ts::TimelineDemux::~TimelineDemux()
+{
+}
+
+void ts::TimelineDemux::immediateReset()
+{
+    SuperClass::immediateReset();
+    _packet_count = 0;
+    _first_pcr_pid = PID_NULL;
+    _pids.clear();
+    _programs.clear();
+
+    // Reset the section demux back to initial state (intercepting the PAT).
+    _section_demux.reset();
+    _section_demux.addPID(PID_PAT);
+}
+
+void ts::TimelineDemux::immediateResetPID(PID pid)
+{
+    SuperClass::immediateResetPID(pid);
+    _pids.erase(pid);
+    if (pid == _first_pcr_pid) {
+        _first_pcr_pid = PID_NULL;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Feed the demux with TS packets.
+//----------------------------------------------------------------------------
+
+void ts::TimelineDemux::feedPacket(const TSPacket& pkt)
+{
+    processPacket(pkt, nullptr);
+}
+
+void ts::TimelineDemux::feedPacket(const TSPacket& pkt, const TSPacketMetadata& mdata)
+{
+    processPacket(pkt, &mdata);
+}
+
+void ts::TimelineDemux::feedPackets(const TSPacket* pkt, const TSPacketMetadata* mdata, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        processPacket(pkt[i], mdata == nullptr ? nullptr : mdata + i);
+    }
+}
+
+void ts::TimelineDemux::feedPackets(const TSPacketWindow& window)
+{
+    for (size_t i = 0; i < window.size(); ) {
+        TSPacket* pkt = nullptr;
+        TSPacketMetadata* mdata = nullptr;
+        const size_t count = window.getContiguous(i, pkt, mdata);
+        if (count == 0) {
+            // Dropped packet.
+            ++i;
+        }
+        else {
+            feedPackets(pkt, mdata, count);
+            i += count;
+        }
+    }
+}
+
+void ts::TimelineDemux::processPacket(const TSPacket& pkt, const TSPacketMetadata* mdata)
+{
+    const PID pid = pkt.getPID();
+
+    SuperClass::feedPacket(pkt);
+
+    // Feed the section demux to get the PAT and PMT's.
+    _section_demux.feedPacket(pkt);
+
+    if (_pid_filter[pid] && (pkt.hasPCR() || pkt.hasPTS() || pkt.hasDTS())) {
+        PIDTimeline& ctx(_pids[pid]);
+
+        if (pkt.hasPCR()) {
+            const uint64_t pcr = pkt.getPCR();
+            const int64_t ext_pcr = pkt.getDiscontinuityIndicator() ? ctx.pcr.rebase(pcr) : ctx.pcr.set(pcr);
+            ctx.last_pcr_packet = _packet_count;
+            if (_first_pcr_pid == PID_NULL) {
+                _first_pcr_pid = pid;
+            }
+
+            // Correlate the PCR with the input time of the packet.
+            if (mdata != nullptr && mdata->hasInputTimeStamp()) {
+                const uint64_t scale = mdata->getInputTimeSource() == TimeSource::M2TS ? M2TS_SCALE : PCR_SCALE;
+                if (ctx.input_time.scale() != scale) {
+                    ctx.input_time = ClockExtender(scale);
+                    ctx.regression.reset();
+                }
+                if (pkt.getDiscontinuityIndicator()) {
+                    // The PCR timeline was rebased, previous samples are no longer aligned.
+                    ctx.regression.reset();
+                }
+                ctx.regression.addSample(ext_pcr, ctx.input_time.set(mdata->getInputTimeStamp() % scale));
+            }
+        }
+
+        if (pkt.hasPTS()) {
+            ctx.pts.set(pkt.getPTS());
+
+            // Delay between presentation and transmission, using the PCR of the program.
+            const PIDTimeline* pcr_ctx = pkt.hasPCR() ? &ctx : nullptr;
+            if (pcr_ctx == nullptr) {
+                const ProgramTimeline* prog = programTimeline(ctx.service_id);
+                pcr_ctx = prog == nullptr ? nullptr : pidTimeline(prog->pcr_pid);
+            }
+            if (pcr_ctx != nullptr && pcr_ctx->pcr.isValid()) {
+                // Extend the PTS relative to the PCR, the PTS and PCR timelines may have started on different sides of a wrap-around.
+                const int64_t pcr_base = pcr_ctx->pcr.extended() / int64_t(SYSTEM_CLOCK_SUBFACTOR);
+                const int64_t pts = pcr_base + ClockExtender::Distance(uint64_t(pcr_base) % PTS_DTS_SCALE, pkt.getPTS(), PTS_DTS_SCALE);
+                ctx.pts_delay = pts * int64_t(SYSTEM_CLOCK_SUBFACTOR) - pcr_ctx->pcr.extended();
+                ctx.has_pts_delay = true;
+            }
+        }
+
+        if (pkt.hasDTS()) {
+            ctx.dts.set(pkt.getDTS());
+        }
+    }
+
+    _packet_count++;
+}
+
+
+//----------------------------------------------------------------------------
+// Implementation of TableHandlerInterface.
+//----------------------------------------------------------------------------
+
+void ts::TimelineDemux::handleTable(SectionDemux& demux, const BinaryTable& table)
+{
+    switch (table.tableId()) {
+        case TID_PAT: {
+            // Got a PAT, add all PMT PID's to section demux.
+            const PAT pat(_duck, table);
+            if (pat.isValid()) {
+                for (const auto& it : pat.pmts) {
+                    _section_demux.addPID(it.second);
+                }
+            }
+            break;
+        }
+        case TID_PMT: {
+            // Got a PMT, describe the program and its PID's.
+            const PMT pmt(_duck, table);
+            if (pmt.isValid()) {
+                ProgramTimeline& prog(_programs[pmt.service_id]);
+                prog.service_id = pmt.service_id;
+                prog.pcr_pid = pmt.pcr_pid;
+                prog.video_pid = prog.audio_pid = PID_NULL;
+                prog.pids.clear();
+                for (const auto& it : pmt.streams) {
+                    const PID pid = it.first;
+                    PIDTimeline& ctx(_pids[pid]);
+                    if (ctx.service_id == 0xFFFF || ctx.service_id == pmt.service_id) {
+                        ctx.service_id = pmt.service_id;
+                        ctx.is_video = it.second.isVideo(_duck);
+                        ctx.is_audio = it.second.isAudio(_duck);
+                    }
+                    prog.pids.insert(pid);
+                    if (prog.video_pid == PID_NULL && it.second.isVideo(_duck)) {
+                        prog.video_pid = pid;
+                    }
+                    if (prog.audio_pid == PID_NULL && it.second.isAudio(_duck)) {
+                        prog.audio_pid = pid;
+                    }
+                }
+            }
+            break;
+        }
+        default: {
+            // Nothing to do.
+            break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Accessors.
+//----------------------------------------------------------------------------
+
+const ts::TimelineDemux::PIDTimeline* ts::TimelineDemux::pidTimeline(PID pid) const
+{
+    const auto it = _pids.find(pid);
+    return it == _pids.end() ? nullptr : &it->second;
+}
+
+const ts::TimelineDemux::ProgramTimeline* ts::TimelineDemux::programTimeline(uint16_t service_id) const
+{
+    const auto it = _programs.find(service_id);
+    return it == _programs.end() ? nullptr : &it->second;
+}
+
+ts::PID ts::TimelineDemux::referencePCRPID() const
+{
+    // First program, in service id order, with PCR's.
+    for (const auto& it : _programs) {
+        const PIDTimeline* ctx = pidTimeline(it.second.pcr_pid);
+        if (ctx != nullptr && ctx->pcr.isValid()) {
+            return it.second.pcr_pid;
+        }
+    }
+    return _first_pcr_pid;
+}
+
+int64_t ts::TimelineDemux::referencePCR() const
+{
+    const PIDTimeline* ctx = pidTimeline(referencePCRPID());
+    return ctx == nullptr ? 0 : ctx->pcr.extended();
+}
+
+int64_t ts::TimelineDemux::currentPCR(PID pid) const
+{
+    const PIDTimeline* ctx = pidTimeline(pid);
+    if (ctx != nullptr && ctx->pcr.isValid()) {
+        return ctx->pcr.extended();
+    }
+    if (ctx != nullptr && ctx->service_id != 0xFFFF) {
+        const ProgramTimeline* prog = programTimeline(ctx->service_id);
+        const PIDTimeline* pcr_ctx = prog == nullptr ? nullptr : pidTimeline(prog->pcr_pid);
+        if (pcr_ctx != nullptr && pcr_ctx->pcr.isValid()) {
+            return pcr_ctx->pcr.extended();
+        }
+    }
+    return referencePCR();
+}
+
+bool ts::TimelineDemux::avOffset(uint16_t service_id, int64_t& offset) const
+{
+    const ProgramTimeline* prog = programTimeline(service_id);
+    if (prog == nullptr) {
+        return false;
+    }
+    const PIDTimeline* video = pidTimeline(prog->video_pid);
+    const PIDTimeline* audio = pidTimeline(prog->audio_pid);
+    if (video == nullptr || audio == nullptr || !video->has_pts_delay || !audio->has_pts_delay) {
+        return false;
+    }
+    offset = video->pts_delay - audio->pts_delay;
+    return true;
+}
@@ -0,0 +1,359 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2023, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  PCR, PTS and DTS timelines per PID and per program.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsAbstractDemux.h"
+#include "tsSectionDemux.h"
+#include "tsTableHandlerInterface.h"
+#include "tsTSPacketMetadata.h"
+
+namespace ts {
+
+    class TSPacketWindow;
+
+    //!
+    //! A demux which maintains the PCR, PTS and DTS timelines of all PID's and programs.
+    //! @ingroup mpeg
+    //!
+    //! For each PID, the latest PCR, PTS and DTS are kept, together with their value
+    //! on a 64-bit timeline which is corrected for wrap-around. For each PCR PID, when
+    //! the packets carry an input time stamp, a linear regression of the input time
+    //! against the PCR is maintained, giving the PCR drift and the input time of any PCR.
+    //!
+    //! The PAT and PMT's are analyzed to group PID's into programs. For each PES PID
+    //! of a program, the delay between the PTS and the PCR of the program at the time
+    //! the PTS was received is computed. The difference between the video and audio
+    //! delays is the A/V offset of the program.
+    //!
+    //! This class is intended as a shared time reference for stages which need it
+    //! (pacing, splicing, table repetition, monitoring), instead of each stage
+    //! recomputing time differences from raw PCR values.
+    //!
+    class TSDUCKDLL TimelineDemux: public AbstractDemux, private TableHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(TimelineDemux);
+    public:
+        //!
+        //! Explicit reference to superclass.
+        //!
+        typedef AbstractDemux SuperClass;
+
+        //!
+        //! Extension of a wrapping clock (PCR, PTS, DTS, input time stamps) to a 64-bit timeline.
+        //!
+        //! Each new value is placed on the timeline at the shortest distance from the previous
+        //! one, forward or backward. Slightly lower values such as out-of-order PTS are therefore
+        //! placed before the previous value, not one full wrap-around later.
+        //!
+        class TSDUCKDLL ClockExtender
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] scale Scale offset after wrapping up at max value. Default is appropriate for PTS/DTS.
+            //!
+            explicit ClockExtender(uint64_t scale = PTS_DTS_SCALE) : _scale(scale) {}
+            //!
+            //! Check if at least one value was collected.
+            //! @return True if at least one value was collected.
+            //!
+            bool isValid() const { return _count > 0; }
+            //!
+            //! Reset all values, forget collected time stamps.
+            //!
+            void reset();
+            //!
+            //! Set a new collected value.
+            //! @param [in] value New collected value, in the range 0 to scale-1. Invalid values are ignored.
+            //! @return The extended value of @a value.
+            //!
+            int64_t set(uint64_t value);
+            //!
+            //! Set a new collected value after a discontinuity.
+            //! The new value is placed at the same position on the timeline as the previous value.
+            //! The time between the last value before the discontinuity and the first value after it is lost.
+            //! @param [in] value New collected value, in the range 0 to scale-1. Invalid values are ignored.
+            //! @return The extended value of @a value.
+            //!
+            int64_t rebase(uint64_t value);
+            //!
+            //! Compute the extended value of a value without collecting it.
+            //! @param [in] value A value in the range 0 to scale-1.
+            //! @return The extended value of @a value, relative to the last collected value.
+            //! If no value was collected, return @a value.
+            //!
+            int64_t extend(uint64_t value) const;
+            //!
+            //! Get the scale of the clock.
+            //! @return The scale of the clock.
+            //!
+            uint64_t scale() const { return _scale; }
+            //!
+            //! Get the last collected value, as found in the stream.
+            //! @return The last collected value or INVALID_PCR if none was collected.
+            //!
+            uint64_t last() const { return isValid() ? _last : INVALID_PCR; }
+            //!
+            //! Get the extended value of the last collected value.
+            //! @return The extended value of the last collected value or zero if none was collected.
+            //!
+            int64_t extended() const { return _extended; }
+            //!
+            //! Get the extended value of the first collected value.
+            //! @return The extended value of the first collected value or zero if none was collected.
+            //!
+            int64_t first() const { return _first; }
+            //!
+            //! Get the duration between the first and the last collected value.
+            //! @return The duration in clock units, excluding the time lost in discontinuities.
+            //!
+            int64_t duration() const { return _extended - _first; }
+            //!
+            //! Get the number of collected values.
+            //! @return The number of collected values.
+            //!
+            uint64_t count() const { return _count; }
+            //!
+            //! Get the number of discontinuities.
+            //! @return The number of calls to rebase() after the first value.
+            //!
+            uint64_t discontinuities() const { return _discontinuities; }
+            //!
+            //! Compute the signed shortest distance between two values of a wrapping clock.
+            //! @param [in] from First value, in the range 0 to @a scale-1.
+            //! @param [in] to Second value, in the range 0 to @a scale-1.
+            //! @param [in] scale Scale offset after wrapping up at max value.
+            //! @return The distance from @a from to @a to, in the range -scale/2 to scale/2.
+            //!
+            static int64_t Distance(uint64_t from, uint64_t to, uint64_t scale);
+
+        private:
+            uint64_t _scale = PTS_DTS_SCALE;  //!< Scale offset after wrapping up at max value.
+            uint64_t _last = 0;               //!< Last collected value.
+            int64_t  _extended = 0;           //!< Extended value of _last.
+            int64_t  _first = 0;              //!< Extended value of the first collected value.
+            uint64_t _count = 0;              //!< Number of collected values.
+            uint64_t _discontinuities = 0;    //!< Number of discontinuities.
+        };
+
+        //!
+        //! Linear regression of the input time of the packets against their PCR.
+        //!
+        //! The regression is computed on values relative to the first sample, so
+        //! that double precision is sufficient for streams of several days.
+        //!
+        class TSDUCKDLL ClockRegression
+        {
+        public:
+            //!
+            //! Reset the regression, forget all samples.
+            //!
+            void reset();
+            //!
+            //! Add a sample.
+            //! @param [in] pcr Extended PCR value.
+            //! @param [in] time Extended input time, in PCR units.
+            //!
+            void addSample(int64_t pcr, int64_t time);
+            //!
+            //! Get the number of samples.
+            //! @return The number of samples since the last reset.
+            //!
+            uint64_t count() const { return _count; }
+            //!
+            //! Check if the regression can be used.
+            //! @return True if at least two samples with distinct PCR values were collected.
+            //!
+            bool isValid() const;
+            //!
+            //! Get the slope of the regression.
+            //! @return The number of input time units per PCR unit. One when the PCR clock and
+            //! the input clock run at the same speed. Return one if the regression is not valid.
+            //!
+            double slope() const;
+            //!
+            //! Get the drift of the PCR clock against the input clock.
+            //! @return The drift in parts per million. Positive when the PCR clock is slower
+            //! than the input clock. Return zero if the regression is not valid.
+            //!
+            double driftPPM() const { return (slope() - 1.0) * 1000000.0; }
+            //!
+            //! Estimate the input time of a PCR.
+            //! @param [in] pcr Extended PCR value.
+            //! @return The estimated extended input time of @a pcr, in PCR units.
+            //! Return zero if no sample was collected.
+            //!
+            int64_t timeOf(int64_t pcr) const;
+
+        private:
+            int64_t  _pcr0 = 0;     //!< PCR of the first sample.
+            int64_t  _time0 = 0;    //!< Input time of the first sample.
+            uint64_t _count = 0;    //!< Number of samples.
+            double   _sum_x = 0;    //!< Sum of relative PCR values.
+            double   _sum_y = 0;    //!< Sum of relative input times.
+            double   _sum_xx = 0;   //!< Sum of squared relative PCR values.
+            double   _sum_xy = 0;   //!< Sum of products of relative PCR and input times.
+        };
+
+        //!
+        //! Timeline of one PID.
+        //!
+        class TSDUCKDLL PIDTimeline
+        {
+        public:
+            uint16_t        service_id = 0xFFFF;                //!< Service id of the first program containing the PID, 0xFFFF if unknown.
+            bool            is_video = false;                   //!< The PID is a video stream, from the PMT.
+            bool            is_audio = false;                   //!< The PID is an audio stream, from the PMT.
+            ClockExtender   pcr {PCR_SCALE};                    //!< PCR's found in the PID.
+            ClockExtender   pts {PTS_DTS_SCALE};                //!< PTS's found in the PID.
+            ClockExtender   dts {PTS_DTS_SCALE};                //!< DTS's found in the PID.
+            ClockExtender   input_time {PCR_SCALE};             //!< Input time stamps of the packets with a PCR.
+            ClockRegression regression {};                      //!< Input time against PCR, for PCR PID's.
+            PacketCounter   last_pcr_packet = INVALID_PACKET_COUNTER; //!< Index in the stream of the last packet with a PCR.
+            bool            has_pts_delay = false;              //!< The field @a pts_delay is valid.
+            int64_t         pts_delay = 0;                      //!< Last PTS minus the PCR of the program at the same time, in PCR units.
+        };
+
+        //!
+        //! Description of one program.
+        //!
+        class TSDUCKDLL ProgramTimeline
+        {
+        public:
+            uint16_t       service_id = 0;         //!< Service id.
+            PID            pcr_pid = PID_NULL;     //!< PCR PID of the program, from the PMT.
+            PID            video_pid = PID_NULL;   //!< First video PID of the program, PID_NULL if none.
+            PID            audio_pid = PID_NULL;   //!< First audio PID of the program, PID_NULL if none.
+            std::set<PID>  pids {};                //!< All elementary stream PID's of the program.
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in,out] duck TSDuck execution context. The reference is kept inside the demux.
+        //! @param [in] pid_filter The initial set of PID's to track. All PID's by default.
+        //! The PAT and PMT's are always analyzed.
+        //!
+        explicit TimelineDemux(DuckContext& duck, const PIDSet& pid_filter = AllPIDs);
+
+        //!
+        //! Destructor.
+        //!
+        virtual ~TimelineDemux() override;
+
+        // Inherited methods
+        virtual void feedPacket(const TSPacket& pkt) override;
+
+        //!
+        //! Feed the demux with a TS packet and its metadata.
+        //! The input time stamp of the metadata, if any, is used for the PCR to input time regression.
+        //! @param [in] pkt A TS packet.
+        //! @param [in] mdata Metadata of the packet.
+        //!
+        void feedPacket(const TSPacket& pkt, const TSPacketMetadata& mdata);
+
+        //!
+        //! Feed the demux with a contiguous span of TS packets.
+        //! @param [in] pkt Address of the first packet.
+        //! @param [in] mdata Address of the metadata of the first packet. Can be null.
+        //! @param [in] count Number of packets.
+        //!
+        void feedPackets(const TSPacket* pkt, const TSPacketMetadata* mdata, size_t count);
+
+        //!
+        //! Feed the demux with all packets of a window, skipping dropped packets.
+        //! @param [in] window A window of packets.
+        //!
+        void feedPackets(const TSPacketWindow& window);
+
+        //!
+        //! Get the number of packets which were fed into the demux.
+        //! @return The number of packets since the last reset.
+        //!
+        PacketCounter packetCount() const { return _packet_count; }
+
+        //!
+        //! Get the timeline of a PID.
+        //! @param [in] pid The PID to check.
+        //! @return The timeline of @a pid or a null pointer if nothing is known about @a pid.
+        //!
+        const PIDTimeline* pidTimeline(PID pid) const;
+
+        //!
+        //! Get the description of a program.
+        //! @param [in] service_id The service id to check.
+        //! @return The program or a null pointer if the PMT of the program was not found.
+        //!
+        const ProgramTimeline* programTimeline(uint16_t service_id) const;
+
+        //!
+        //! Get the reference PCR PID.
+        //! This is the PCR PID of the first program with PCR's or, without PMT, the first PID with PCR's.
+        //! @return The reference PCR PID or PID_NULL if no PCR was found so far.
+        //!
+        PID referencePCRPID() const;
+
+        //!
+        //! Get the extended value of the last PCR on the reference PCR PID.
+        //! This is the simplest "current time" of the stream.
+        //! @return The extended value of the last PCR or zero if no PCR was found so far.
+        //!
+        int64_t referencePCR() const;
+
+        //!
+        //! Get the extended value of the last PCR of the program containing a PID.
+        //! @param [in] pid A PID. If the PID carries PCR's, it is used. Otherwise, the
+        //! PCR PID of its program is used. Otherwise, the reference PCR PID is used.
+        //! @return The extended value of the last PCR or zero if none was found.
+        //!
+        int64_t currentPCR(PID pid) const;
+
+        //!
+        //! Get the A/V offset of a program.
+        //! @param [in] service_id The service id of the program.
+        //! @param [out] offset The delay between PTS and PCR of the video PID minus the same delay
+        //! on the audio PID, in PCR units. Positive when video is sent earlier than audio, relative
+        //! to their presentation time.
+        //! @return True on success, false if the program, its video or audio PID or their PTS are not known.
+        //!
+        bool avOffset(uint16_t service_id, int64_t& offset) const;
+
+        //!
+        //! Get the number of milliseconds between two extended PCR values.
+        //! @param [in] from First extended PCR value.
+        //! @param [in] to Second extended PCR value.
+        //! @return The number of milliseconds from @a from to @a to.
+        //!
+        static MilliSecond PCRToMilliSecond(int64_t from, int64_t to) { return (to - from) * 1000 / int64_t(SYSTEM_CLOCK_FREQ); }
+
+    protected:
+        // Inherited methods
+        virtual void immediateReset() override;
+        virtual void immediateResetPID(PID pid) override;
+
+    private:
+        typedef std::map<PID, PIDTimeline> PIDTimelineMap;
+        typedef std::map<uint16_t, ProgramTimeline> ProgramTimelineMap;
+
+        SectionDemux       _section_demux;               //!< Demux for PAT and PMT's.
+        PacketCounter      _packet_count = 0;            //!< Number of packets since last reset.
+        PID                _first_pcr_pid = PID_NULL;    //!< First PID with PCR's.
+        PIDTimelineMap     _pids {};                     //!< Timeline per PID.
+        ProgramTimelineMap _programs {};                 //!< Programs by service id.
+
+        // Process a packet, with an optional metadata.
+        void processPacket(const TSPacket& pkt, const TSPacketMetadata* mdata);
+
+        // Implementation of TableHandlerInterface.
+        virtual void handleTable(SectionDemux& demux, const BinaryTable& table) override;
+    };
+}
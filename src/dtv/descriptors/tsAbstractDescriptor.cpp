@@ -150,18 +150,23 @@ bool ts::AbstractDescriptor::serialize(DuckContext& duck, Descriptor& bin) const
 //----------------------------------------------------------------------------
 
 bool ts::AbstractDescriptor::deserialize(DuckContext& duck, const Descriptor& bin)
+{
+    return bin.isValid() ? deserialize(duck, bin.content(), bin.size()) : deserialize(duck, nullptr, 0);
+}
+
+bool ts::AbstractDescriptor::deserialize(DuckContext& duck, const uint8_t* content, size_t size)
 {
     // Make sure the object is cleared before analyzing the binary descriptor.
     clear();
 
-    if (!bin.isValid() || bin.tag() != _tag) {
+    if (content == nullptr || size < 2 || content[1] != size - 2 || content[0] != _tag) {
         // If the binary descriptor is already invalid or has the wrong descriptor tag, this object is invalid too.
         invalidate();
         return false;
     }
     else {
         // Map a deserialization read-only buffer over the payload part.
-        PSIBuffer buf(duck, bin.payload(), bin.payloadSize());
+        PSIBuffer buf(duck, content + 2, size - 2);
 
         // If this is an extension descriptor, check that the expected extended tag is present in the payload.
         const DID etag = extendedTag();
@@ -190,11 +195,12 @@ bool ts::AbstractDescriptor::deserialize(DuckContext& duck, const Descriptor& bi
 
 bool ts::AbstractDescriptor::deserialize(DuckContext& duck, const DescriptorList& dlist, size_t index)
 {
-    if (index > dlist.count()) {
+    if (index >= dlist.count()) {
         invalidate();
         return false;
     }
     else {
-        return deserialize(duck, *dlist[index]);
+        // Read the content in place, no Descriptor object is created.
+        return deserialize(duck, dlist.content(index), dlist.contentSize(index));
     }
 }
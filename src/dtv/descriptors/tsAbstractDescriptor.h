@@ -121,6 +121,18 @@ namespace ts {
         //!
         bool deserialize(DuckContext& duck, const Descriptor& bin);
 
+        //!
+        //! This method deserializes a binary descriptor from a memory area.
+        //! @param [in,out] duck TSDuck execution context.
+        //! @param [in] content Address of the full binary descriptor (tag, length, payload).
+        //! Can be null for an invalid descriptor.
+        //! @param [in] size Size in bytes of the full binary descriptor.
+        //! In case of success, this object is replaced with the interpreted content of the descriptor.
+        //! In case of error, this object is invalidated.
+        //! @return True in case of success, false if the descriptor is invalid.
+        //!
+        bool deserialize(DuckContext& duck, const uint8_t* content, size_t size);
+
         //!
         //! Deserialize a descriptor from a descriptor list.
         //! In case of success, this object is replaced with the interpreted content of the binary descriptor.
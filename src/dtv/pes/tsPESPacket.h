@@ -13,6 +13,7 @@
 
 #pragma once
 #include "tsDemuxedData.h"
+#include "tsPoolAllocated.h"
 #include "tsCodecType.h"
 #include "tsTS.h"
 #include "tsPSI.h"
@@ -35,7 +36,9 @@ namespace ts {
     //! Representation of MPEG PES packets.
     //! @ingroup mpeg
     //!
-    class TSDUCKDLL PESPacket : public DemuxedData
+    //! Dynamically allocated instances use a thread-local pool, see PoolAllocated.
+    //!
+    class TSDUCKDLL PESPacket : public DemuxedData, public PoolAllocated<PESPacket>
     {
     public:
         //!
@@ -13,6 +13,7 @@
 
 #pragma once
 #include "tsAbstractDefinedByStandards.h"
+#include "tsPoolAllocated.h"
 #include "tsTablesPtr.h"
 #include "tsTS.h"
 
@@ -34,7 +35,7 @@ namespace ts
 	//! the first section is added. Subsequent sections must have the
 	//! same properties.
 	//!
-	class TSDUCKDLL BinaryTable : public AbstractDefinedByStandards
+	class TSDUCKDLL BinaryTable : public AbstractDefinedByStandards, public PoolAllocated<BinaryTable>
 	{
 	public:
 		//!
@@ -132,11 +132,16 @@ ts::EDID ts::Descriptor::edid(PDS pds, AbstractTable const *table) const
 
 ts::EDID ts::Descriptor::edid(PDS pds, TID tid) const
 {
-	if (!isValid())
+	return isValid() ? GetEDID(content(), size(), pds, tid) : EDID();
+}
+
+ts::EDID ts::Descriptor::GetEDID(uint8_t const *content, size_t size, PDS pds, TID tid)
+{
+	if (content == nullptr || size < 2)
 	{
 		return EDID(); // invalid value.
 	}
-	const DID did = tag();
+	const DID did = content[0];
 	if (tid != TID_NULL && names::HasTableSpecificName(did, tid))
 	{
 		// Table-specific descriptor.
@@ -147,15 +152,15 @@ ts::EDID ts::Descriptor::edid(PDS pds, TID tid) const
 		// Private descriptor.
 		return EDID::Private(did, pds);
 	}
-	else if (did == DID_DVB_EXTENSION && payloadSize() > 0)
+	else if (did == DID_DVB_EXTENSION && size > 2)
 	{
 		// DVB extension descriptor.
-		return EDID::ExtensionDVB(payload()[0]);
+		return EDID::ExtensionDVB(content[2]);
 	}
-	else if (did == DID_MPEG_EXTENSION && payloadSize() > 0)
+	else if (did == DID_MPEG_EXTENSION && size > 2)
 	{
 		// MPEG extension descriptor.
-		return EDID::ExtensionMPEG(payload()[0]);
+		return EDID::ExtensionMPEG(content[2]);
 	}
 	else
 	{
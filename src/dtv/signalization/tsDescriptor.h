@@ -152,6 +152,16 @@ namespace ts
 		//!
 		EDID edid(PDS pds, AbstractTable const *table) const;
 
+		//!
+		//! Get the extended descriptor id of a binary descriptor in memory.
+		//! @param [in] content Address of the full binary content of the descriptor.
+		//! @param [in] size Size in bytes of the full binary content of the descriptor.
+		//! @param [in] pds Associated private data specifier.
+		//! @param [in] tid Check if the descriptor is table-specific for this table-id.
+		//! @return The extended descriptor id.
+		//!
+		static EDID GetEDID(uint8_t const *content, size_t size, PDS pds = 0, TID tid = TID_NULL);
+
 		//!
 		//! Access to the full binary content of the descriptor.
 		//! @return Address of the full binary content of the descriptor.
@@ -23,13 +23,15 @@ ts::DescriptorList::DescriptorList(AbstractTable const *table)
 
 ts::DescriptorList::DescriptorList(AbstractTable const *table, DescriptorList const &dl)
 	: _table(table),
-	  _list(dl._list)
+	  _list(dl._list),
+	  _flat(dl._flat)
 {
 }
 
 ts::DescriptorList::DescriptorList(AbstractTable const *table, DescriptorList &&dl) noexcept
 	: _table(table),
-	  _list(std::move(dl._list))
+	  _list(std::move(dl._list)),
+	  _flat(std::move(dl._flat))
 {
 }
 
@@ -39,6 +41,7 @@ ts::DescriptorList &ts::DescriptorList::operator=(DescriptorList const &dl)
 	{
 		// Copy the list of descriptors but preserve the parent table.
 		_list = dl._list;
+		_flat = dl._flat;
 	}
 	return *this;
 }
@@ -49,6 +52,7 @@ ts::DescriptorList &ts::DescriptorList::operator=(DescriptorList &&dl) noexcept
 	{
 		// Move the list of descriptors but preserve the parent table.
 		_list = std::move(dl._list);
+		_flat = std::move(dl._flat);
 	}
 	return *this;
 }
@@ -62,6 +66,56 @@ ts::TID ts::DescriptorList::tableId() const
 	return _table == nullptr ? TID(TID_NULL) : _table->tableId();
 }
 
+//----------------------------------------------------------------------------
+// Binary content of a descriptor in the list.
+//----------------------------------------------------------------------------
+
+uint8_t const *ts::DescriptorList::content(Element const &e) const
+{
+	if (e.offset != NPOS)
+	{
+		return _flat.data() + e.offset;
+	}
+	else
+	{
+		return e.desc.isNull() || !e.desc->isValid() ? nullptr : e.desc->content();
+	}
+}
+
+size_t ts::DescriptorList::contentSize(Element const &e) const
+{
+	if (e.offset != NPOS)
+	{
+		return e.size;
+	}
+	else
+	{
+		return e.desc.isNull() || !e.desc->isValid() ? 0 : e.desc->size();
+	}
+}
+
+//----------------------------------------------------------------------------
+// Access to the binary content of a descriptor by index.
+//----------------------------------------------------------------------------
+
+ts::DID ts::DescriptorList::tag(size_t index) const
+{
+	assert(index < _list.size());
+	return tagOf(_list[index]);
+}
+
+uint8_t const *ts::DescriptorList::content(size_t index) const
+{
+	assert(index < _list.size());
+	return content(_list[index]);
+}
+
+size_t ts::DescriptorList::contentSize(size_t index) const
+{
+	assert(index < _list.size());
+	return contentSize(_list[index]);
+}
+
 //----------------------------------------------------------------------------
 // Comparison
 //----------------------------------------------------------------------------
@@ -74,9 +128,10 @@ bool ts::DescriptorList::operator==(DescriptorList const &other) const
 	}
 	for (size_t i = 0; i < _list.size(); ++i)
 	{
-		DescriptorPtr const &desc1(_list[i].desc);
-		DescriptorPtr const &desc2(other._list[i].desc);
-		if (desc1.isNull() || desc2.isNull() || *desc1 != *desc2)
+		uint8_t const *data1 = content(_list[i]);
+		uint8_t const *data2 = other.content(other._list[i]);
+		size_t const size1 = contentSize(_list[i]);
+		if (data1 == nullptr || data2 == nullptr || size1 != other.contentSize(other._list[i]) || std::memcmp(data1, data2, size1) != 0)
 		{
 			return false;
 		}
@@ -90,34 +145,39 @@ bool ts::DescriptorList::operator==(DescriptorList const &other) const
 
 bool ts::DescriptorList::add(DescriptorPtr const &desc)
 {
-	PDS pds = 0;
-
 	if (desc.isNull() || !desc->isValid())
 	{
 		return false;
 	}
 
+	// Add the descriptor in the list
+	_list.push_back(Element(desc, nextPDS(desc->content(), desc->size())));
+	return true;
+}
+
+//----------------------------------------------------------------------------
+// Compute the PDS of a new descriptor at end of list.
+//----------------------------------------------------------------------------
+
+ts::PDS ts::DescriptorList::nextPDS(uint8_t const *data, size_t size) const
+{
 	// Determine which PDS to associate with the descriptor
-	if (desc->tag() == DID_PRIV_DATA_SPECIF)
+	if (data[0] == DID_PRIV_DATA_SPECIF)
 	{
 		// This descriptor defines a new "private data specifier".
 		// The PDS is the only thing in the descriptor payload.
-		pds = desc->payloadSize() < 4 ? 0 : GetUInt32(desc->payload());
+		return size < 6 ? 0 : GetUInt32(data + 2);
 	}
 	else if (_list.empty())
 	{
 		// First descriptor in the list
-		pds = 0;
+		return 0;
 	}
 	else
 	{
 		// Use same PDS as previous descriptor
-		pds = _list[_list.size() - 1].pds;
+		return _list[_list.size() - 1].pds;
 	}
-
-	// Add the descriptor in the list
-	_list.push_back(Element(desc, pds));
-	return true;
 }
 
 //----------------------------------------------------------------------------
@@ -139,16 +199,49 @@ bool ts::DescriptorList::add(void const *data, size_t size)
 {
 	uint8_t const *desc = reinterpret_cast<uint8_t const *>(data);
 	size_t length = 0;
-	bool success = true;
+
+	// All descriptors are appended in the contiguous buffer, at most one reallocation.
+	_flat.reserve(_flat.size() + size);
 
 	while (size >= 2 && (length = size_t(desc[1]) + 2) <= size)
 	{
-		success = add(DescriptorPtr(new Descriptor(desc, length))) && success;
+		const PDS pds = nextPDS(desc, length);
+		_list.push_back(Element(_flat.size(), length, pds));
+		_flat.append(desc, length);
 		desc += length;
 		size -= length;
 	}
 
-	return success && size == 0;
+	return size == 0;
+}
+
+//----------------------------------------------------------------------------
+// Add another list of descriptors at end of list.
+//----------------------------------------------------------------------------
+
+void ts::DescriptorList::add(DescriptorList const &dl)
+{
+	if (&dl == this)
+	{
+		// The buffer would be reallocated while reading it.
+		DescriptorList const copy(_table, dl);
+		add(copy);
+		return;
+	}
+
+	_list.reserve(_list.size() + dl._list.size());
+	for (auto const &e : dl._list)
+	{
+		if (e.offset == NPOS)
+		{
+			_list.push_back(e);
+		}
+		else
+		{
+			_list.push_back(Element(_flat.size(), e.size, e.pds));
+			_flat.append(dl._flat.data() + e.offset, e.size);
+		}
+	}
 }
 
 //----------------------------------------------------------------------------
@@ -187,13 +280,14 @@ void ts::DescriptorList::merge(DuckContext &duck, AbstractDescriptor const &desc
 				{
 					// New descriptor shall replace the previous one.
 					_list[index].desc = bindesc;
+					_list[index].offset = NPOS;
 					return;
 				}
 			case DescriptorDuplication::MERGE:
 				{
 					// New descriptor shall be merged into old one.
 					// We need to deserialize the previous descriptor first.
-					AbstractDescriptorPtr const dp(_list[index].desc->deserialize(duck, pds, _table));
+					AbstractDescriptorPtr const dp((*this)[index]->deserialize(duck, pds, _table));
 					if (!dp.isNull() && dp->merge(desc))
 					{
 						// Descriptor successfully merged. Reserialize it and replace it.
@@ -212,7 +306,7 @@ void ts::DescriptorList::merge(DuckContext &duck, AbstractDescriptor const &desc
 			case DescriptorDuplication::ADD_OTHER:
 				{
 					// In case the two binary descriptors are exactly identical, do nothing.
-					if (*_list[index].desc == *bindesc)
+					if (contentSize(_list[index]) == bindesc->size() && std::memcmp(content(_list[index]), bindesc->content(), bindesc->size()) == 0)
 					{
 						return;
 					}
@@ -245,12 +339,13 @@ void ts::DescriptorList::merge(DuckContext &duck, DescriptorList const &other)
 		for (size_t index = 0; index < other._list.size(); ++index)
 		{
 			// The descriptor from the other list must be deserialized to be merged.
-			AbstractDescriptorPtr const dp(other._list[index].desc->deserialize(duck, other._list[index].pds, other._table));
+			DescriptorPtr const desc(other[index]);
+			AbstractDescriptorPtr const dp(desc->deserialize(duck, other._list[index].pds, other._table));
 			if (dp.isNull() || dp->duplicationMode() == DescriptorDuplication::ADD_ALWAYS)
 			{
 				// Cannot be deserialized or simply add the descriptor.
 				addPrivateDataSpecifier(other._list[index].pds);
-				add(other._list[index].desc);
+				add(desc);
 			}
 			else
 			{
@@ -265,10 +360,36 @@ void ts::DescriptorList::merge(DuckContext &duck, DescriptorList const &other)
 // Get a reference to the descriptor at a specified index.
 //----------------------------------------------------------------------------
 
-ts::DescriptorPtr const &ts::DescriptorList::operator[](size_t index) const
+ts::DescriptorPtr const &ts::DescriptorList::operator[](size_t index)
+{
+	assert(index < _list.size());
+	Element &e(_list[index]);
+	if (e.offset != NPOS)
+	{
+		// Create the Descriptor object on first access. From now on, it holds the content.
+		e.desc = new Descriptor(_flat.data() + e.offset, e.size);
+		e.offset = NPOS;
+	}
+	return e.desc;
+}
+
+//----------------------------------------------------------------------------
+// Get a copy of the descriptor at a specified index.
+//----------------------------------------------------------------------------
+
+ts::DescriptorPtr ts::DescriptorList::operator[](size_t index) const
 {
 	assert(index < _list.size());
-	return _list[index].desc;
+	Element const &e(_list[index]);
+	if (e.offset == NPOS && e.desc.isNull())
+	{
+		return DescriptorPtr();
+	}
+
+	// Nothing is modified in the list, not even the reference count of a shared descriptor.
+	// This is what makes concurrent reads of the same list safe.
+	uint8_t const *const data = content(e);
+	return DescriptorPtr(data == nullptr ? new Descriptor() : new Descriptor(data, contentSize(e)));
 }
 
 //----------------------------------------------------------------------------
@@ -278,13 +399,13 @@ ts::DescriptorPtr const &ts::DescriptorList::operator[](size_t index) const
 ts::EDID ts::DescriptorList::edid(size_t index) const
 {
 	// Eliminate invalid descriptor, index out of range.
-	if (index >= _list.size() || _list[index].desc.isNull() || !_list[index].desc->isValid())
+	if (index >= _list.size())
 	{
 		return EDID(); // invalid value
 	}
 	else
 	{
-		return _list[index].desc->edid(_list[index].pds, _table);
+		return Descriptor::GetEDID(content(_list[index]), contentSize(_list[index]), _list[index].pds, tableId());
 	}
 }
 
@@ -301,10 +422,10 @@ ts::PDS ts::DescriptorList::privateDataSpecifier(size_t index) const
 // Prepare removal of a private_data_specifier descriptor.
 //----------------------------------------------------------------------------
 
-bool ts::DescriptorList::prepareRemovePDS(ElementVector::iterator it)
+bool ts::DescriptorList::prepareRemovePDS(ElementVector::iterator it, PDS previous_pds)
 {
 	// Eliminate invalid cases
-	if (it == _list.end() || it->desc->tag() != DID_PRIV_DATA_SPECIF)
+	if (it == _list.end() || tagOf(*it) != DID_PRIV_DATA_SPECIF)
 	{
 		return false;
 	}
@@ -313,7 +434,7 @@ bool ts::DescriptorList::prepareRemovePDS(ElementVector::iterator it)
 	decltype(it) end;
 	for (end = it + 1; end != _list.end(); ++end)
 	{
-		DID tag = end->desc->tag();
+		DID tag = tagOf(*end);
 		if (tag >= 0x80)
 		{
 			// This is a private descriptor, the private_data_specifier descriptor
@@ -329,7 +450,6 @@ bool ts::DescriptorList::prepareRemovePDS(ElementVector::iterator it)
 	}
 
 	// Update the current PDS after removed private_data_specifier descriptor
-	uint32_t previous_pds = it == _list.begin() ? 0 : (it - 1)->pds;
 	while (--end != it)
 	{
 		end->pds = previous_pds;
@@ -363,20 +483,13 @@ void ts::DescriptorList::addPrivateDataSpecifier(PDS pds)
 
 size_t ts::DescriptorList::removeInvalidPrivateDescriptors()
 {
-	size_t count = 0;
-
-	for (size_t n = 0; n < _list.size();)
-	{
-		if (_list[n].pds == 0 && !_list[n].desc.isNull() && _list[n].desc->isValid() && _list[n].desc->tag() >= 0x80)
-		{
-			_list.erase(_list.begin() + n);
-			count++;
-		}
-		else
-		{
-			n++;
-		}
-	}
+	// Compact the list in one pass, then the contiguous buffer once.
+	auto const end = std::remove_if(_list.begin(), _list.end(), [this](Element const &e) {
+		return e.pds == 0 && content(e) != nullptr && tagOf(e) >= 0x80;
+	});
+	size_t const count = _list.end() - end;
+	_list.erase(end, _list.end());
+	compactFlat();
 
 	return count;
 }
@@ -394,13 +507,14 @@ bool ts::DescriptorList::removeByIndex(size_t index)
 	}
 
 	// Private_data_specifier descriptor can be removed under certain conditions only
-	if (_list[index].desc->tag() == DID_PRIV_DATA_SPECIF && !prepareRemovePDS(_list.begin() + index))
+	if (tagOf(_list[index]) == DID_PRIV_DATA_SPECIF && !prepareRemovePDS(_list.begin() + index, index == 0 ? 0 : _list[index - 1].pds))
 	{
 		return false;
 	}
 
 	// Remove the specified descriptor
 	_list.erase(_list.begin() + index);
+	compactFlat();
 	return true;
 }
 
@@ -413,19 +527,28 @@ size_t ts::DescriptorList::removeByTag(DID tag, PDS pds)
 	bool const check_pds = pds != 0 && tag >= 0x80;
 	size_t removed_count = 0;
 
-	for (auto it = _list.begin(); it != _list.end();)
+	// Kept elements are moved down to 'out' as we go, the list and the contiguous
+	// buffer are compacted once at the end. Elements after 'it' are still in place,
+	// this is what prepareRemovePDS() looks at.
+	auto out = _list.begin();
+	for (auto it = _list.begin(); it != _list.end(); ++it)
 	{
-		const DID itag = it->desc->tag();
-		if (itag == tag && (!check_pds || it->pds == pds) && (itag != DID_PRIV_DATA_SPECIF || prepareRemovePDS(it)))
+		const DID itag = tagOf(*it);
+		if (itag == tag && (!check_pds || it->pds == pds) && (itag != DID_PRIV_DATA_SPECIF || prepareRemovePDS(it, out == _list.begin() ? 0 : (out - 1)->pds)))
 		{
-			it = _list.erase(it);
 			++removed_count;
 		}
 		else
 		{
-			++it;
+			if (out != it)
+			{
+				*out = std::move(*it);
+			}
+			++out;
 		}
 	}
+	_list.erase(out, _list.end());
+	compactFlat();
 
 	return removed_count;
 }
@@ -442,7 +565,7 @@ size_t ts::DescriptorList::binarySize(size_t start, size_t count) const
 
 	for (size_t i = start; i < start + count; ++i)
 	{
-		size += _list[i].desc->size();
+		size += contentSize(_list[i]);
 	}
 
 	return size;
@@ -456,11 +579,15 @@ size_t ts::DescriptorList::serialize(uint8_t *&addr, size_t &size, size_t start)
 {
 	size_t i;
 
-	for (i = start; i < _list.size() && _list[i].desc->size() <= size; ++i)
+	for (i = start; i < _list.size() && contentSize(_list[i]) <= size; ++i)
 	{
-		std::memcpy(addr, _list[i].desc->content(), _list[i].desc->size());
-		addr += _list[i].desc->size();
-		size -= _list[i].desc->size();
+		size_t const desc_size = contentSize(_list[i]);
+		if (desc_size > 0)
+		{
+			std::memcpy(addr, content(_list[i]), desc_size);
+		}
+		addr += desc_size;
+		size -= desc_size;
 	}
 
 	return i;
@@ -530,7 +657,7 @@ size_t ts::DescriptorList::search(DID tag, size_t start_index, PDS pds) const
 	bool check_pds = pds != 0 && tag >= 0x80;
 	size_t index = start_index;
 
-	while (index < _list.size() && (_list[index].desc->tag() != tag || (check_pds && _list[index].pds != pds)))
+	while (index < _list.size() && (tagOf(_list[index]) != tag || (check_pds && _list[index].pds != pds)))
 	{
 		index++;
 	}
@@ -555,7 +682,7 @@ size_t ts::DescriptorList::search(ts::EDID const &edid, size_t start_index) cons
 
 	// Now search in the list.
 	size_t index = start_index;
-	while (index < _list.size() && _list[index].desc->edid(_list[index].pds, tid) != edid)
+	while (index < _list.size() && Descriptor::GetEDID(content(_list[index]), contentSize(_list[index]), _list[index].pds, tid) != edid)
 	{
 		index++;
 	}
@@ -582,14 +709,14 @@ size_t ts::DescriptorList::searchLanguage(DuckContext const &duck, UString const
 	// Seach all known types of descriptors containing languages.
 	for (size_t index = start_index; index < _list.size(); index++)
 	{
-		DescriptorPtr const &desc(_list[index].desc);
-		if (!desc.isNull() && desc->isValid())
+		uint8_t const *const desc = content(_list[index]);
+		if (desc != nullptr)
 		{
 
-			const DID tag = desc->tag();
+			const DID tag = desc[0];
 			const PDS pds = _list[index].pds;
-			uint8_t const *data = desc->payload();
-			size_t size = desc->payloadSize();
+			uint8_t const *data = desc + 2;
+			size_t size = contentSize(_list[index]) - 2;
 
 			if (tag == DID_LANGUAGE)
 			{
@@ -729,9 +856,15 @@ size_t ts::DescriptorList::searchSubtitle(UString const &language, size_t start_
 	for (size_t index = start_index; index < _list.size(); index++)
 	{
 
-		const DID tag = _list[index].desc->tag();
-		uint8_t const *desc = _list[index].desc->payload();
-		size_t size = _list[index].desc->payloadSize();
+		uint8_t const *const data = content(_list[index]);
+		if (data == nullptr)
+		{
+			continue;
+		}
+
+		const DID tag = data[0];
+		uint8_t const *desc = data + 2;
+		size_t size = contentSize(_list[index]) - 2;
 
 		if (tag == DID_SUBTITLING)
 		{
@@ -787,3 +920,40 @@ size_t ts::DescriptorList::searchSubtitle(UString const &language, size_t start_
 
 	return not_found;
 }
+
+//----------------------------------------------------------------------------
+// Compact the contiguous buffer when most of it is unused.
+//----------------------------------------------------------------------------
+
+void ts::DescriptorList::compactFlat()
+{
+	// Size of the contents which are still used in _flat.
+	size_t used = 0;
+	for (auto const &e : _list)
+	{
+		if (e.offset != NPOS)
+		{
+			used += e.size;
+		}
+	}
+
+	if (used == 0)
+	{
+		_flat.clear();
+	}
+	else if (used < _flat.size() / 2)
+	{
+		ByteBlock flat;
+		flat.reserve(used);
+		for (auto &e : _list)
+		{
+			if (e.offset != NPOS)
+			{
+				const size_t offset = flat.size();
+				flat.append(_flat.data() + e.offset, e.size);
+				e.offset = offset;
+			}
+		}
+		_flat.swap(flat);
+	}
+}
@@ -25,6 +25,12 @@ namespace ts
 	//! List of MPEG PSI/SI descriptors.
 	//! @ingroup mpeg
 	//!
+	//! Descriptors which are added from a memory area, typically when a table is deserialized,
+	//! are stored in one contiguous byte buffer per list, without one Descriptor object per
+	//! descriptor. Searching, serializing and comparing lists work directly on this buffer.
+	//! A Descriptor object is kept in the list only when a descriptor is accessed using the
+	//! non-const operator[].
+	//!
 	class TSDUCKDLL DescriptorList
 	{
 	public:
@@ -128,10 +134,43 @@ namespace ts
 
 		//!
 		//! Get a reference to the descriptor at a specified index.
+		//! If the descriptor is still in the contiguous buffer, a Descriptor object is created
+		//! and kept in the list. Subsequent modifications of the descriptor are taken into account.
 		//! @param [in] index Index in the list. Valid index are 0 to count()-1.
 		//! @return A reference to the descriptor at @a index.
 		//!
-		DescriptorPtr const &operator[](size_t index) const;
+		DescriptorPtr const &operator[](size_t index);
+
+		//!
+		//! Get a copy of the descriptor at a specified index.
+		//! The list is not modified, concurrent calls on the same constant list are safe.
+		//! Modifications of the returned descriptor are not reflected in the list.
+		//! @param [in] index Index in the list. Valid index are 0 to count()-1.
+		//! @return A new Descriptor object with the content of the descriptor at @a index.
+		//!
+		DescriptorPtr operator[](size_t index) const;
+
+		//!
+		//! Get the tag of a descriptor in the list, without creating a Descriptor object.
+		//! @param [in] index Index of a descriptor in the list. Valid index are 0 to count()-1.
+		//! @return The tag of the descriptor at @a index, zero if the descriptor is invalid.
+		//!
+		DID tag(size_t index) const;
+
+		//!
+		//! Get the binary content of a descriptor in the list, without creating a Descriptor object.
+		//! The returned address remains valid until the list is modified.
+		//! @param [in] index Index of a descriptor in the list. Valid index are 0 to count()-1.
+		//! @return Address of the full binary descriptor (tag, length, payload), null if the descriptor is invalid.
+		//!
+		uint8_t const *content(size_t index) const;
+
+		//!
+		//! Get the size of the binary content of a descriptor in the list.
+		//! @param [in] index Index of a descriptor in the list. Valid index are 0 to count()-1.
+		//! @return Size in bytes of the full binary descriptor, zero if the descriptor is invalid.
+		//!
+		size_t contentSize(size_t index) const;
 
 		//!
 		//! Get the extended descriptor id of a descriptor in the list.
@@ -164,13 +203,11 @@ namespace ts
 
 		//!
 		//! Add another list of descriptors at end of list.
-		//! The descriptors objects are shared between the two lists.
+		//! The descriptors objects are shared between the two lists. The descriptors
+		//! which are still in the contiguous buffer of @a dl are copied.
 		//! @param [in] dl The descriptor list to add.
 		//!
-		void add(DescriptorList const &dl)
-		{
-			_list.insert(_list.end(), dl._list.begin(), dl._list.end());
-		}
+		void add(DescriptorList const &dl);
 
 		//!
 		//! Add descriptors from a memory area at end of list
@@ -254,6 +291,7 @@ namespace ts
 		void clear()
 		{
 			_list.clear();
+			_flat.clear();
 		}
 
 		//!
@@ -370,16 +408,30 @@ namespace ts
 
 	private:
 		// Each entry contains a descriptor and its corresponding private data specifier.
+		// The binary content of the descriptor is either in desc or at offset in _flat.
+		// The Descriptor object is created on demand by the non-const operator[] and then
+		// replaces the content in _flat (offset becomes NPOS).
 		struct Element
 		{
 			// Public members:
 			DescriptorPtr desc;
 			PDS pds;
+			size_t offset;
+			size_t size;
 
-			// Constructor:
+			// Constructors:
 			Element(DescriptorPtr const &desc_ = DescriptorPtr(), PDS pds_ = 0)
 				: desc(desc_),
-				  pds(pds_)
+				  pds(pds_),
+				  offset(NPOS),
+				  size(0)
+			{
+			}
+			Element(size_t offset_, size_t size_, PDS pds_)
+				: desc(),
+				  pds(pds_),
+				  offset(offset_),
+				  size(size_)
 			{
 			}
 		};
@@ -388,12 +440,29 @@ namespace ts
 
 		// Private members
 		AbstractTable const *const _table; // Parent table (zero for descriptor list object outside a table).
-		ElementVector _list{};             // Vector of safe pointers to descriptors.
+		ElementVector _list{};             // Vector of descriptors.
+		ByteBlock _flat{};                 // Contiguous binary content of descriptors without Descriptor object.
+
+		// Binary content of a descriptor in the list, null if invalid.
+		uint8_t const *content(Element const &e) const;
+		size_t contentSize(Element const &e) const;
+		DID tagOf(Element const &e) const
+		{
+			uint8_t const *data = content(e);
+			return data == nullptr ? DID(0) : data[0];
+		}
+
+		// Compute the PDS of a new descriptor at end of list.
+		PDS nextPDS(uint8_t const *data, size_t size) const;
+
+		// Compact _flat when most of it is no longer used. Called once after each removal pass.
+		void compactFlat();
 
 		// Prepare removal of a private_data_specifier descriptor.
 		// Return true if can be removed, false if it cannot (private descriptors ahead).
-		// When it can be removed, the current PDS of all subsequent descriptors is updated.
-		bool prepareRemovePDS(ElementVector::iterator);
+		// When it can be removed, the current PDS of all subsequent descriptors is updated
+		// to previous_pds, the PDS of the descriptor which will precede them.
+		bool prepareRemovePDS(ElementVector::iterator it, PDS previous_pds);
 
 		// Inaccessible operations.
 		DescriptorList() = delete;
@@ -413,7 +482,7 @@ size_t ts::DescriptorList::search(DuckContext &duck, DID tag, DESC &desc, size_t
 	// Repeatedly search for a descriptor until one is successfully deserialized
 	for (size_t index = search(tag, start_index, pds); index < _list.size(); index = search(tag, index + 1, pds))
 	{
-		desc.deserialize(duck, *(_list[index].desc));
+		desc.deserialize(duck, *this, index);
 		if (desc.isValid())
 		{
 			return index;
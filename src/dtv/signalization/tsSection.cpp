@@ -307,6 +307,32 @@ void ts::Section::recomputeCRC()
 	}
 }
 
+//----------------------------------------------------------------------------
+// Overwrite bytes of the section and update its CRC32 incrementally.
+//----------------------------------------------------------------------------
+
+void ts::Section::patch(size_t offset, void const *data, size_t dsize)
+{
+	if (!_is_valid || data == nullptr || dsize == 0)
+	{
+		return;
+	}
+
+	size_t const sec_size = isLongSection() ? size() - SECTION_CRC32_SIZE : size();
+	if (offset + dsize > sec_size)
+	{
+		return;
+	}
+
+	if (isLongSection())
+	{
+		uint32_t const crc = CRC32::Update(GetUInt32(content() + sec_size), content() + offset, data, dsize, sec_size - offset - dsize);
+		PutUInt32(rwContent() + sec_size, crc);
+	}
+
+	std::memcpy(rwContent() + offset, data, dsize);
+}
+
 //----------------------------------------------------------------------------
 // Get a hash of the section content.
 //----------------------------------------------------------------------------
@@ -17,6 +17,7 @@
 #include "tsCerrReport.h"
 #include "tsCRC32.h"
 #include "tsDemuxedData.h"
+#include "tsPoolAllocated.h"
 #include "tsETID.h"
 #include "tsTS.h"
 
@@ -36,7 +37,10 @@ namespace ts
 	//! Typically, if the ByteBlock comes from the wire, use CHECK.
 	//! If the ByteBlock is built by the application, use COMPUTE,
 	//!
-	class TSDUCKDLL Section : public DemuxedData, public AbstractDefinedByStandards
+	//! Demuxes create one Section object per received section. Their memory
+	//! is recycled through a thread-local pool, see PoolAllocated.
+	//!
+	class TSDUCKDLL Section : public DemuxedData, public AbstractDefinedByStandards, public PoolAllocated<Section>
 	{
 	public:
 		//!
@@ -502,6 +506,17 @@ namespace ts
 		//!
 		void recomputeCRC();
 
+		//!
+		//! Overwrite bytes of the section and update its CRC32 incrementally.
+		//! Unlike recomputeCRC(), the cost does not depend on the section size.
+		//! The CRC32 of the section must be valid before the call.
+		//! @param [in] offset Byte offset from the beginning of the section, not the payload.
+		//! The modified bytes must be located before the CRC32.
+		//! @param [in] data Address of the new bytes.
+		//! @param [in] size Number of bytes to overwrite.
+		//!
+		void patch(size_t offset, void const *data, size_t size);
+
 		//!
 		//! Check if the section has a "diversified" payload.
 		//! A payload is "diversified" if its size is 2 bytes or more and if
@@ -258,21 +258,45 @@ void ts::SDT::serializePayload(BinaryTable &table, PSIBuffer &buf) const
 
 bool ts::SDT::ServiceEntry::locateServiceDescriptor(DuckContext &duck, ServiceDescriptor &desc) const
 {
-	const size_t index = descs.search(DID_SERVICE);
-
-	if (index >= descs.count())
+	const ServiceDescriptor *sd = cachedServiceDescriptor(duck);
+	if (sd == nullptr)
 	{
 		desc.invalidate();
 		return false;
 	}
 	else
 	{
-		assert(!descs[index].isNull());
-		desc.deserialize(duck, *descs[index]);
-		return desc.isValid();
+		desc = *sd;
+		return true;
 	}
 }
 
+const ts::ServiceDescriptor *ts::SDT::ServiceEntry::cachedServiceDescriptor(DuckContext &duck) const
+{
+	const size_t index = descs.search(DID_SERVICE);
+	if (index >= descs.count())
+	{
+		return nullptr;
+	}
+
+	// Read the binary descriptor in place, without creating a Descriptor object.
+	const uint8_t *const data = descs.content(index);
+	const size_t size = descs.contentSize(index);
+	const Charset *charset = duck.charsetIn();
+
+	// Decode the names only when the descriptor changed since the last call.
+	if (_cached_charset != charset ||
+	    _cached_desc_data.size() != size ||
+	    (size > 0 && std::memcmp(_cached_desc_data.data(), data, size) != 0))
+	{
+		_cached_desc.deserialize(duck, data, size);
+		_cached_desc_data.copy(data, size);
+		_cached_charset = charset;
+	}
+
+	return _cached_desc.isValid() ? &_cached_desc : nullptr;
+}
+
 
 //----------------------------------------------------------------------------
 // Return the service type, service name and provider name (all found from
@@ -281,20 +305,20 @@ bool ts::SDT::ServiceEntry::locateServiceDescriptor(DuckContext &duck, ServiceDe
 
 uint8_t ts::SDT::ServiceEntry::serviceType(DuckContext &duck) const
 {
-	ServiceDescriptor sd;
-	return locateServiceDescriptor(duck, sd) ? sd.service_type : 0; // 0 is a "reserved" service_type value
+	const ServiceDescriptor *sd = cachedServiceDescriptor(duck);
+	return sd != nullptr ? sd->service_type : 0; // 0 is a "reserved" service_type value
 }
 
 ts::UString ts::SDT::ServiceEntry::providerName(DuckContext &duck) const
 {
-	ServiceDescriptor sd;
-	return locateServiceDescriptor(duck, sd) ? sd.provider_name : UString();
+	const ServiceDescriptor *sd = cachedServiceDescriptor(duck);
+	return sd != nullptr ? sd->provider_name : UString();
 }
 
 ts::UString ts::SDT::ServiceEntry::serviceName(DuckContext &duck) const
 {
-	ServiceDescriptor sd;
-	return locateServiceDescriptor(duck, sd) ? sd.service_name : UString();
+	const ServiceDescriptor *sd = cachedServiceDescriptor(duck);
+	return sd != nullptr ? sd->service_name : UString();
 }
 
 
@@ -13,6 +13,7 @@
 
 #pragma once
 #include "tsAbstractLongTable.h"
+#include "tsCharset.h"
 #include "tsDescriptorList.h"
 #include "tsService.h"
 #include "tsServiceDescriptor.h"
@@ -123,6 +124,9 @@ namespace ts
 
 			//!
 			//! Locate and deserialize the first DVB service_descriptor inside the entry.
+			//! The decoded descriptor is cached, keyed by its binary content and the input
+			//! character set. Repeated calls on an unmodified descriptor do not decode the
+			//! names again. The cache is not thread-safe, like the rest of the entry.
 			//! @param [in,out] duck TSDuck execution context.
 			//! @param [out] desc Returned content of the service descriptor.
 			//! @return True if found and valid, false otherwise.
@@ -137,6 +141,15 @@ namespace ts
 			void updateService(DuckContext &duck, Service &service) const;
 
 		private:
+			// Cache of the last decoded service_descriptor.
+			mutable ByteBlock         _cached_desc_data {};         // Binary content of the decoded descriptor.
+			mutable const Charset*    _cached_charset = nullptr;    // Input character set used to decode it.
+			mutable ServiceDescriptor _cached_desc {};              // Decoded descriptor.
+
+			// Locate the first service_descriptor and return its decoded content from the cache.
+			// Return a null pointer if there is no valid service_descriptor.
+			const ServiceDescriptor* cachedServiceDescriptor(DuckContext &duck) const;
+
 			//!
 			//! Set a string value (typically provider or service name).
 			//! @param [in,out] duck TSDuck execution context.
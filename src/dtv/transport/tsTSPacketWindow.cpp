@@ -48,6 +48,50 @@ void ts::TSPacketWindow::addPacketsReference(TSPacket* pkt, TSPacketMetadata* md
 }
 
 
+//----------------------------------------------------------------------------
+// Insert the address of a range of packets and their metadata inside the window.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketWindow::insertPacketsReference(size_t index, TSPacket* pkt, TSPacketMetadata* mdata, size_t count)
+{
+    assert(pkt != nullptr);
+    assert(mdata != nullptr);
+
+    if (index >= _size) {
+        addPacketsReference(pkt, mdata, count);
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    // Locate the range which contains index.
+    size_t ri = 0;
+    while (index >= _ranges[ri].first + _ranges[ri].count) {
+        ++ri;
+        assert(ri < _ranges.size());
+    }
+
+    // Split the range when the insertion point is in the middle of it.
+    if (index > _ranges[ri].first) {
+        PacketRange& head(_ranges[ri]);
+        const size_t head_count = index - head.first;
+        const PacketRange tail {head.packets + head_count, head.metadata + head_count, index, head.count - head_count};
+        head.count = head_count;
+        _ranges.insert(_ranges.begin() + ri + 1, tail);
+        ++ri;
+    }
+
+    // Insert the new range and shift the next ones.
+    _ranges.insert(_ranges.begin() + ri, {pkt, mdata, index, count});
+    for (++ri; ri < _ranges.size(); ++ri) {
+        _ranges[ri].first += count;
+    }
+    _size += count;
+    _last_range_index = 0;
+}
+
+
 //----------------------------------------------------------------------------
 // Get the address of a packet or metadata inside the window.
 //----------------------------------------------------------------------------
@@ -87,6 +131,27 @@ bool ts::TSPacketWindow::get(size_t index, TSPacket*& pkt, TSPacketMetadata*& md
 }
 
 
+//----------------------------------------------------------------------------
+// Get the address of a physically contiguous run of packets.
+//----------------------------------------------------------------------------
+
+size_t ts::TSPacketWindow::getContiguous(size_t index, TSPacket*& pkt, TSPacketMetadata*& mdata) const
+{
+    if (!get(index, pkt, mdata)) {
+        return 0;
+    }
+
+    // The last range index was set by get() to the range of the packet.
+    const PacketRange& ipr(_ranges[_last_range_index]);
+    const size_t end = ipr.count - (index - ipr.first);
+    size_t count = 1;
+    while (count < end && pkt[count].b[0] == SYNC_BYTE) {
+        ++count;
+    }
+    return count;
+}
+
+
 //----------------------------------------------------------------------------
 // Get the physical index of a packet inside a buffer.
 //----------------------------------------------------------------------------
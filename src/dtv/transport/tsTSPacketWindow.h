@@ -50,6 +50,18 @@ namespace ts {
         //!
         void addPacketsReference(TSPacket* packet, TSPacketMetadata* metadata, size_t count);
 
+        //!
+        //! Insert the address of a range of packets and their metadata inside the window.
+        //! The packets which were at @a index and after are moved after the inserted range.
+        //! The inserted packets are not copied and must remain valid while the window is used.
+        //! @param [in] index Index in the window where to insert the packets. If @a index is
+        //! greater than or equal to size(), the packets are added at the end of the window.
+        //! @param [in] packet The address of the first packet.
+        //! @param [in] metadata The address of the first corresponding packet metadata.
+        //! @param [in] count Number of contiguous packets and metadata.
+        //!
+        void insertPacketsReference(size_t index, TSPacket* packet, TSPacketMetadata* metadata, size_t count);
+
         //!
         //! Get the number of packets in this window.
         //! @return The number of packets in this window.
@@ -89,6 +101,16 @@ namespace ts {
         //!
         bool get(size_t index, TSPacket*& packet, TSPacketMetadata*& metadata) const;
 
+        //!
+        //! Get the address of a physically contiguous run of packets inside the window.
+        //! @param [in] index Index of the first packet inside the window, from 0 to size()-1.
+        //! @param [out] packet The address of the first packet of the run.
+        //! @param [out] metadata The address of the first corresponding packet metadata.
+        //! @return The number of contiguous packets starting at @a index, not including dropped packets.
+        //! Return zero if the @a index is out of range or if the packet was previously dropped.
+        //!
+        size_t getContiguous(size_t index, TSPacket*& packet, TSPacketMetadata*& metadata) const;
+
         //!
         //! Get the physical index of a packet inside a buffer.
         //! @param [in] index Index of the packet inside the window, from 0 to size()-1.
@@ -0,0 +1,361 @@
+#include "benchmark_tsduck.h"
+#include <base/filesystem/file.h>
+#include <base/string/Json.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <PidChanger.h>
+#include <tsAES.h>
+#include <tsCRC32.h>
+#include <tsCyclingPacketizer.h>
+#include <tsDVBCSA2.h>
+#include <tsduck/container/TSPacketQueue.h>
+#include <tsduck/corrector/CCCorrector.h>
+#include <tsduck/corrector/TableRepeater.h>
+#include <tsduck/generator/SyntheticTsStream.h>
+#include <tsduck/io/TSPacketStreamReader.h>
+#include <tsduck/io/TSPacketStreamWriter.h>
+#include <tsduck/mux/AutoChangeIdProgramMux.h>
+#include <tsduck/mux/JoinedTsStream.h>
+#include <tsduck/TableOperator.h>
+#include <tsECB.h>
+#include <tsPESDemux.h>
+#include <tsSection.h>
+#include <tsSectionDemux.h>
+
+namespace
+{
+	/// <summary>
+	///		什么都不做，只统计收到的包数。放在被测环节的输出端。
+	/// </summary>
+	class NullConsumer : public video::ITSPacketConsumer
+	{
+	public:
+		uint64_t _packet_count = 0;
+
+		using ITSPacketConsumer::SendPacket;
+
+		void SendPacket(ts::TSPacket *packet) override
+		{
+			_packet_count++;
+		}
+	};
+
+	/// <summary>
+	///		统计表格数量的表格处理器。
+	/// </summary>
+	class CountingTableHandler : public ts::TableHandlerInterface
+	{
+	public:
+		uint64_t _table_count = 0;
+
+		void handleTable(ts::SectionDemux &demux, ts::BinaryTable const &table) override
+		{
+			_table_count++;
+		}
+	};
+
+	/// <summary>
+	///		统计 PES 包数量的 PES 处理器。
+	/// </summary>
+	class CountingPESHandler : public ts::PESHandlerInterface
+	{
+	public:
+		uint64_t _pes_count = 0;
+
+		void handlePESPacket(ts::PESDemux &demux, ts::PESPacket const &packet) override
+		{
+			_pes_count++;
+		}
+	};
+
+	/// <summary>
+	///		用 SyntheticTsStream 在内存中合成一个 ts 流。每个节目有一路带 PCR 的视频和一路音频。
+	/// </summary>
+	/// <param name="service_count">节目数。为 1 时就是单节目流。</param>
+	/// <param name="packet_count">要合成的包数。</param>
+	/// <returns></returns>
+	std::vector<ts::TSPacket> GenerateStream(uint16_t service_count, size_t packet_count)
+	{
+		video::SyntheticTsStream stream{service_count, 2, 40'000'000};
+		stream._max_packet_count = packet_count;
+
+		std::vector<ts::TSPacket> packets;
+		packets.reserve(packet_count);
+		ts::TSPacket packet;
+		while (stream.ReadPacket(packet) == video::ITSPacketSource::ReadPacketResult::Success)
+		{
+			packets.push_back(packet);
+		}
+
+		return packets;
+	}
+
+	/// <summary>
+	///		生成类似 EIT 的长段。每 8 个段属于同一个表，负载长度在 100 到 400 字节之间变化。
+	/// </summary>
+	/// <param name="section_count"></param>
+	/// <returns></returns>
+	ts::SectionPtrVector GenerateEitLikeSections(size_t section_count)
+	{
+		ts::SectionPtrVector sections;
+		sections.reserve(section_count);
+		std::vector<uint8_t> payload(400);
+		for (size_t i = 0; i < section_count; i++)
+		{
+			for (size_t k = 0; k < payload.size(); k++)
+			{
+				payload[k] = uint8_t(i + k);
+			}
+
+			sections.push_back(ts::SectionPtr{new ts::Section{
+				ts::TID(0x50 + (i / 8) % 16),
+				true,
+				uint16_t(i / 128),
+				0,
+				true,
+				uint8_t(i % 8),
+				7,
+				payload.data(),
+				100 + i * 37 % 300,
+			}});
+		}
+
+		return sections;
+	}
+
+	/// <summary>
+	///		运行一次测量，返回 Json 格式的结果。
+	/// </summary>
+	/// <param name="name">被测环节的名称。</param>
+	/// <param name="packet_count">一轮处理的包数。</param>
+	/// <param name="rounds">重复的轮数。</param>
+	/// <param name="func">处理一轮。</param>
+	/// <returns></returns>
+	base::Json Measure(std::string name, size_t packet_count, int rounds, std::function<void()> func)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < rounds; i++)
+		{
+			func();
+		}
+
+		auto end = std::chrono::steady_clock::now();
+		double seconds = std::chrono::duration<double>(end - start).count();
+		double total_packets = double(packet_count) * rounds;
+		base::Json json{
+			{"name", name},
+			{"packets", uint64_t(total_packets)},
+			{"seconds", seconds},
+			{"packets_per_second", seconds > 0 ? total_packets / seconds : 0},
+			{"ns_per_packet", total_packets > 0 ? seconds * 1e9 / total_packets : 0},
+			{"mbps", seconds > 0 ? total_packets * ts::PKT_SIZE_BITS / seconds / 1e6 : 0},
+		};
+
+		std::cout << json.dump() << std::endl;
+		return json;
+	}
+} // namespace
+
+void benchmark_tsduck(std::string output_json_path)
+{
+	int const rounds = 5;
+	std::vector<ts::TSPacket> spts = GenerateStream(1, 200000);
+	std::vector<ts::TSPacket> mpts = GenerateStream(30, 200000);
+
+	base::Json results;
+	results["version"] = 1;
+
+	{
+		// 先写入临时目录中的文件，然后从文件读出，测量 TSPacketStreamReader 的解析速度。
+		std::string file_path = (std::filesystem::temp_directory_path() / "tsduck-benchmark.ts").string();
+		{
+			shared_ptr<base::Stream> out_stream = base::file::CreateNewAnyway(file_path);
+			video::TSPacketStreamWriter writer{out_stream};
+			writer.SendPacket(mpts);
+			out_stream->Flush();
+		}
+
+		results["results"].push_back(Measure("TSPacketStreamReader", mpts.size(), rounds, [&]()
+											 {
+												 video::TSPacketStreamReader reader{base::file::OpenExisting(file_path)};
+												 ts::TSPacket packet;
+												 while (reader.ReadPacket(packet) == video::ITSPacketSource::ReadPacketResult::Success)
+												 {
+												 }
+											 }));
+
+		// 测完删除临时文件。删除失败不影响测量结果。
+		std::error_code ec;
+		std::filesystem::remove(file_path, ec);
+	}
+
+	results["results"].push_back(Measure("SectionDemux", mpts.size(), rounds, [&]()
+										 {
+											 ts::DuckContext duck;
+											 CountingTableHandler handler;
+											 ts::SectionDemux demux{duck, &handler, nullptr, ts::AllPIDs};
+											 for (ts::TSPacket const &packet : mpts)
+											 {
+												 demux.feedPacket(packet);
+											 }
+										 }));
+
+	results["results"].push_back(Measure("PESDemux", mpts.size(), rounds, [&]()
+										 {
+											 ts::DuckContext duck;
+											 CountingPESHandler handler;
+											 ts::PESDemux demux{duck, &handler};
+											 for (ts::TSPacket const &packet : mpts)
+											 {
+												 demux.feedPacket(packet);
+											 }
+										 }));
+
+	results["results"].push_back(Measure("CCCorrector", mpts.size(), rounds, [&]()
+										 {
+											 video::CCCorrector corrector;
+											 corrector.AddTsPacketConsumer(shared_ptr<NullConsumer>{new NullConsumer{}});
+											 std::vector<ts::TSPacket> packets{mpts};
+											 for (ts::TSPacket &packet : packets)
+											 {
+												 corrector.SendPacket(&packet);
+											 }
+										 }));
+
+	results["results"].push_back(Measure("TableRepeater", mpts.size(), rounds, [&]()
+										 {
+											 video::TableRepeater repeater;
+											 repeater.AddTsPacketConsumer(shared_ptr<NullConsumer>{new NullConsumer{}});
+											 std::vector<ts::TSPacket> packets{mpts};
+											 for (ts::TSPacket &packet : packets)
+											 {
+												 repeater.SendPacket(&packet);
+											 }
+										 }));
+
+	results["results"].push_back(Measure("PidChanger", mpts.size(), rounds, [&]()
+										 {
+											 std::map<uint16_t, uint16_t> pid_map;
+											 for (uint16_t pid = 0x100; pid < 0x100 + 30 * 0x10; pid++)
+											 {
+												 pid_map[pid] = pid + 0x1000;
+											 }
+
+											 video::PidChanger changer{pid_map};
+											 changer.AddTsPacketConsumer(shared_ptr<NullConsumer>{new NullConsumer{}});
+											 std::vector<ts::TSPacket> packets{mpts};
+											 for (ts::TSPacket &packet : packets)
+											 {
+												 changer.SendPacket(&packet);
+											 }
+										 }));
+
+	results["results"].push_back(Measure("AutoChangeIdProgramMux", spts.size() * 2, rounds, [&]()
+										 {
+											 video::AutoChangeIdProgramMux mux;
+											 mux.AddTsPacketConsumer(shared_ptr<NullConsumer>{new NullConsumer{}});
+											 shared_ptr<video::ITSPacketConsumer> input_port = mux.GetNewInputPort();
+											 shared_ptr<video::ITSPacketConsumer> input_port1 = mux.GetNewInputPort();
+											 // 输入端口会就地改写 PID 和表格，所以每个端口要有自己的一份包。
+											 std::vector<ts::TSPacket> packets{spts};
+											 std::vector<ts::TSPacket> packets1{spts};
+											 for (size_t i = 0; i < packets.size(); i++)
+											 {
+												 input_port->SendPacket(&packets[i]);
+												 input_port1->SendPacket(&packets1[i]);
+											 }
+										 }));
+
+	{
+		// 大量段，重复周期各不相同，测量 CyclingPacketizer 调度段的开销。
+		ts::SectionPtrVector sections = GenerateEitLikeSections(20000);
+		ts::MilliSecond const repetition_rates[] = {0, 2000, 10000, 30000};
+		size_t const cycling_packet_count = 500000;
+		results["results"].push_back(Measure("CyclingPacketizer", cycling_packet_count, rounds, [&]()
+											 {
+												 ts::DuckContext duck;
+												 ts::CyclingPacketizer packetizer{duck, 0x12, ts::CyclingPacketizer::StuffingPolicy::AT_END, 40'000'000};
+												 for (size_t i = 0; i < sections.size(); i++)
+												 {
+													 packetizer.addSection(sections[i], repetition_rates[i % 4]);
+												 }
+
+												 ts::TSPacket packet;
+												 for (size_t i = 0; i < cycling_packet_count; i++)
+												 {
+													 packetizer.getNextPacket(packet);
+												 }
+											 }));
+	}
+
+	results["results"].push_back(Measure("JoinedTsStream", spts.size() * 3, rounds, [&]()
+										 {
+											 video::JoinedTsStream joined_ts_stream;
+											 for (int i = 0; i < 3; i++)
+											 {
+												 shared_ptr<video::TSPacketQueue> queue{new video::TSPacketQueue{}};
+												 queue->SendPacket(spts);
+												 queue->SendPacket(nullptr);
+												 joined_ts_stream.AddSource(queue);
+											 }
+
+											 ts::TSPacket packet;
+											 while (joined_ts_stream.ReadPacket(packet) == video::ITSPacketSource::ReadPacketResult::Success)
+											 {
+											 }
+										 }));
+
+	results["results"].push_back(Measure("CRC32", mpts.size(), rounds, [&]()
+										 {
+											 ts::CRC32 crc;
+											 for (ts::TSPacket const &packet : mpts)
+											 {
+												 crc.add(packet.b, ts::PKT_SIZE);
+											 }
+
+											 volatile uint32_t value = crc.value();
+											 (void)value;
+										 }));
+
+	results["results"].push_back(Measure("AES-ECB", mpts.size(), rounds, [&]()
+										 {
+											 static uint8_t const key[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+											 ts::ECB<ts::AES> aes;
+											 aes.setKey(key, sizeof(key));
+											 std::vector<ts::TSPacket> packets{mpts};
+											 for (ts::TSPacket &packet : packets)
+											 {
+												 // 加密负载中 16 字节对齐的部分。
+												 aes.encryptInPlace(packet.b + 12, 176);
+											 }
+										 }));
+
+	results["results"].push_back(Measure("SyntheticTsStream", mpts.size(), rounds, [&]()
+										 {
+											 video::SyntheticTsStream stream{30, 2, 40'000'000};
+											 stream._max_packet_count = mpts.size();
+											 ts::TSPacket packet;
+											 while (stream.ReadPacket(packet) == video::ITSPacketSource::ReadPacketResult::Success)
+											 {
+											 }
+										 }));
+
+	// DVBCSA2 比其它环节慢得多，只用一部分包测量。
+	size_t const dvbcsa2_packet_count = 20000;
+	results["results"].push_back(Measure("DVBCSA2", dvbcsa2_packet_count, rounds, [&]()
+										 {
+											 static uint8_t const key[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+											 ts::DVBCSA2 csa;
+											 csa.setKey(key, sizeof(key));
+											 std::vector<ts::TSPacket> packets{mpts.begin(), mpts.begin() + dvbcsa2_packet_count};
+											 for (ts::TSPacket &packet : packets)
+											 {
+												 csa.encryptInPlace(packet.getPayload(), packet.getPayloadSize());
+											 }
+										 }));
+
+	std::ofstream{output_json_path, std::ios_base::out | std::ios_base::trunc} << results.dump(4) << std::endl;
+}
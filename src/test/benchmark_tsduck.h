@@ -0,0 +1,9 @@
+#pragma once
+#include <string>
+
+/// <summary>
+///		对包处理管道的各个环节做微基准测试。测试用的 ts 流在内存中合成，不需要外部文件。
+///		结果以 Json 格式输出到标准输出，并写入 output_json_path 指定的文件，方便在不同版本之间比较性能。
+/// </summary>
+/// <param name="output_json_path"></param>
+void benchmark_tsduck(std::string output_json_path = "tsduck-benchmark.json");
@@ -0,0 +1,415 @@
+//----------------------------------------------------------------------------
+//
+// Compile ".names" files into C++ tables for ts::NamesFile.
+//
+// Usage: tsNamesCompiler output.cpp registered-name input.names...
+//
+// All input files are merged into one names file, as ts::NamesFile does when
+// it loads and merges several files. The generated source file contains one
+// sorted constexpr table per section and registers them under the given name
+// with ts::NamesFile::RegisterCompiledFile. At run time, the tables are used
+// in place: nothing is read, parsed or allocated per entry.
+//
+// The syntax checks are the same as in ts::NamesFile::decodeDefinition().
+// Errors are fatal here, a bad ".names" file fails the build.
+//
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	typedef uint64_t Value;
+
+	struct Entry
+	{
+		Value first = 0;
+		Value last = 0;
+		std::string name{}; // UTF-8
+		std::string location{};
+	};
+
+	struct Section
+	{
+		size_t bits = 0;
+		std::string inherit{};
+		std::vector<Entry> entries{};
+	};
+
+	// Sections by lowercase name. The map sorts them.
+	std::map<std::string, Section> Sections;
+	size_t ErrorCount = 0;
+
+	void Error(std::string const &location, std::string const &message)
+	{
+		std::cerr << location << ": " << message << std::endl;
+		ErrorCount++;
+	}
+
+	std::string Trim(std::string const &s)
+	{
+		size_t const begin = s.find_first_not_of(" \t\r\n");
+		if (begin == std::string::npos)
+		{
+			return std::string();
+		}
+		size_t const end = s.find_last_not_of(" \t\r\n");
+		return s.substr(begin, end - begin + 1);
+	}
+
+	std::string ToLower(std::string s)
+	{
+		for (char &c : s)
+		{
+			if (c >= 'A' && c <= 'Z')
+			{
+				c = char(c + ('a' - 'A'));
+			}
+		}
+		return s;
+	}
+
+	// Same syntax as UString::toInteger() with ".,_" as ignored separators.
+	bool ToValue(std::string const &text, Value &value)
+	{
+		std::string digits;
+		for (char c : Trim(text))
+		{
+			if (c != '.' && c != ',' && c != '_')
+			{
+				digits.push_back(c);
+			}
+		}
+
+		Value base = 10;
+		if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X'))
+		{
+			base = 16;
+			digits.erase(0, 2);
+		}
+		if (digits.empty())
+		{
+			return false;
+		}
+
+		value = 0;
+		for (char c : digits)
+		{
+			Value digit = 0;
+			if (c >= '0' && c <= '9')
+			{
+				digit = Value(c - '0');
+			}
+			else if (base == 16 && c >= 'a' && c <= 'f')
+			{
+				digit = Value(c - 'a' + 10);
+			}
+			else if (base == 16 && c >= 'A' && c <= 'F')
+			{
+				digit = Value(c - 'A' + 10);
+			}
+			else
+			{
+				return false;
+			}
+			if (value > (~Value(0) - digit) / base)
+			{
+				return false; // overflow
+			}
+			value = value * base + digit;
+		}
+		return true;
+	}
+
+	// Decode a line as "first[-last] = name".
+	bool DecodeDefinition(std::string const &line, Section *section, std::string const &location)
+	{
+		size_t const equal = line.find('=');
+		if (equal == 0 || equal == std::string::npos || section == nullptr)
+		{
+			return false;
+		}
+
+		std::string const range = Trim(line.substr(0, equal));
+		std::string const value = Trim(line.substr(equal + 1));
+
+		if (ToLower(range) == "bits")
+		{
+			Value bits = 0;
+			if (!ToValue(value, bits))
+			{
+				return false;
+			}
+			section->bits = size_t(bits);
+			return true;
+		}
+		else if (ToLower(range) == "inherit")
+		{
+			section->inherit = value;
+			return true;
+		}
+
+		Entry entry;
+		entry.name = value;
+		entry.location = location;
+		size_t const dash = range.find('-');
+		if (dash == std::string::npos)
+		{
+			if (!ToValue(range, entry.first))
+			{
+				return false;
+			}
+			entry.last = entry.first;
+		}
+		else if (!ToValue(range.substr(0, dash), entry.first) || !ToValue(range.substr(dash + 1), entry.last) || entry.last < entry.first)
+		{
+			return false;
+		}
+
+		section->entries.push_back(entry);
+		return true;
+	}
+
+	void LoadFile(std::string const &fileName)
+	{
+		std::ifstream strm(fileName);
+		if (!strm)
+		{
+			Error(fileName, "cannot open file");
+			return;
+		}
+
+		Section *section = nullptr;
+		std::string line;
+		for (size_t lineNumber = 1; std::getline(strm, line); ++lineNumber)
+		{
+			line = Trim(line);
+			std::string const location = fileName + ":" + std::to_string(lineNumber);
+			if (line.empty() || line[0] == '#')
+			{
+				// Empty or comment line, ignore.
+			}
+			else if (line.front() == '[' && line.back() == ']')
+			{
+				// Sections with the same name in several files are merged.
+				section = &Sections[ToLower(Trim(line.substr(1, line.size() - 2)))];
+			}
+			else if (!DecodeDefinition(line, section, location))
+			{
+				Error(location, "invalid line: " + line);
+			}
+		}
+	}
+
+	// Sort the entries of each section and check that ranges do not overlap.
+	void SortAndCheck()
+	{
+		for (auto &it : Sections)
+		{
+			std::vector<Entry> &entries(it.second.entries);
+			std::stable_sort(entries.begin(), entries.end(), [](Entry const &a, Entry const &b) { return a.first < b.first; });
+			for (size_t i = 1; i < entries.size(); ++i)
+			{
+				if (entries[i].first <= entries[i - 1].last)
+				{
+					Error(entries[i].location, "range overlaps with an existing range in section [" + it.first + "]");
+				}
+			}
+		}
+	}
+
+	// Decode one UTF-8 character, return 0xFFFD on invalid sequence.
+	uint32_t NextCodePoint(std::string const &s, size_t &i)
+	{
+		uint8_t const c = uint8_t(s[i++]);
+		size_t more = 0;
+		uint32_t cp = 0;
+		if (c < 0x80)
+		{
+			return c;
+		}
+		else if ((c & 0xE0) == 0xC0)
+		{
+			more = 1;
+			cp = c & 0x1F;
+		}
+		else if ((c & 0xF0) == 0xE0)
+		{
+			more = 2;
+			cp = c & 0x0F;
+		}
+		else if ((c & 0xF8) == 0xF0)
+		{
+			more = 3;
+			cp = c & 0x07;
+		}
+		else
+		{
+			return 0xFFFD;
+		}
+		for (; more > 0; --more)
+		{
+			if (i >= s.size() || (uint8_t(s[i]) & 0xC0) != 0x80)
+			{
+				return 0xFFFD;
+			}
+			cp = (cp << 6) | (uint8_t(s[i++]) & 0x3F);
+		}
+		return cp;
+	}
+
+	// Format a UTF-8 string as a char16_t literal. Non-ASCII characters are escaped,
+	// the generated file does not depend on the source character set of the compiler.
+	std::string Literal(std::string const &s)
+	{
+		std::string result("u\"");
+		char buffer[16];
+		for (size_t i = 0; i < s.size();)
+		{
+			uint32_t const cp = NextCodePoint(s, i);
+			if (cp == '"' || cp == '\\')
+			{
+				result.push_back('\\');
+				result.push_back(char(cp));
+			}
+			else if (cp >= 0x20 && cp < 0x7F)
+			{
+				result.push_back(char(cp));
+			}
+			else if (cp < 0x10000)
+			{
+				std::snprintf(buffer, sizeof(buffer), "\\u%04X", unsigned(cp));
+				result.append(buffer);
+			}
+			else
+			{
+				std::snprintf(buffer, sizeof(buffer), "\\U%08X", unsigned(cp));
+				result.append(buffer);
+			}
+		}
+		result.push_back('"');
+		return result;
+	}
+
+	std::string Hexa(Value value)
+	{
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "0x%llX", static_cast<unsigned long long>(value));
+		return buffer;
+	}
+
+	std::string Generate(std::string const &registeredName, std::vector<std::string> const &inputs)
+	{
+		std::ostringstream out;
+		out << "// Generated by tsNamesCompiler, do not edit." << std::endl;
+		out << "// Sources:" << std::endl;
+		for (auto const &input : inputs)
+		{
+			out << "//   " << input << std::endl;
+		}
+		out << std::endl;
+		out << "#include \"tsNamesFile.h\"" << std::endl;
+		out << std::endl;
+		out << "namespace" << std::endl;
+		out << "{" << std::endl;
+
+		size_t index = 0;
+		for (auto const &it : Sections)
+		{
+			if (!it.second.entries.empty())
+			{
+				out << "\tconstexpr ts::NamesFile::CompiledEntry Entries" << index << "[] = {" << std::endl;
+				for (auto const &entry : it.second.entries)
+				{
+					out << "\t\t{" << Hexa(entry.first) << ", " << Hexa(entry.last) << ", " << Literal(entry.name) << "}," << std::endl;
+				}
+				out << "\t};" << std::endl;
+				out << std::endl;
+			}
+			index++;
+		}
+
+		out << "\tconstexpr ts::NamesFile::CompiledSection Sections[] = {" << std::endl;
+		index = 0;
+		for (auto const &it : Sections)
+		{
+			out << "\t\t{" << Literal(it.first) << ", " << it.second.bits << ", " << Literal(it.second.inherit) << ", ";
+			if (it.second.entries.empty())
+			{
+				out << "nullptr, 0";
+			}
+			else
+			{
+				out << "Entries" << index << ", " << it.second.entries.size();
+			}
+			out << "}," << std::endl;
+			index++;
+		}
+		out << "\t};" << std::endl;
+		out << std::endl;
+		out << "\tts::NamesFile::RegisterCompiledFile const Registrar(" << Literal(registeredName) << ", Sections, sizeof(Sections) / sizeof(Sections[0]));" << std::endl;
+		out << "} // namespace" << std::endl;
+		return out.str();
+	}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4)
+	{
+		std::cerr << "usage: tsNamesCompiler output.cpp registered-name input.names..." << std::endl;
+		return 2;
+	}
+
+	std::string const output(argv[1]);
+	std::string const registeredName(argv[2]);
+	std::vector<std::string> const inputs(argv + 3, argv + argc);
+
+	for (auto const &input : inputs)
+	{
+		LoadFile(input);
+	}
+	SortAndCheck();
+	if (ErrorCount > 0)
+	{
+		std::cerr << "tsNamesCompiler: " << ErrorCount << " error(s)" << std::endl;
+		return 1;
+	}
+
+	if (Sections.empty())
+	{
+		// A zero-size array does not compile.
+		std::cerr << "tsNamesCompiler: no section found" << std::endl;
+		return 1;
+	}
+
+	// Do not touch the output when it is unchanged, this avoids a useless rebuild.
+	std::string const content(Generate(registeredName, inputs));
+	{
+		std::ifstream previous(output, std::ios::binary);
+		std::ostringstream previousContent;
+		previousContent << previous.rdbuf();
+		if (previous && previousContent.str() == content)
+		{
+			return 0;
+		}
+	}
+
+	std::ofstream strm(output, std::ios::binary | std::ios::trunc);
+	strm << content;
+	strm.close();
+	if (!strm)
+	{
+		std::cerr << "tsNamesCompiler: error writing " << output << std::endl;
+		return 1;
+	}
+	return 0;
+}